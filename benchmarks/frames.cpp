@@ -0,0 +1,87 @@
+#include <cstdlib>
+#include <new>
+#include <optional>
+
+#include <asio.hpp>
+
+#include <harbour/harbour.hpp>
+#include <benchmark/benchmark.h>
+
+// Count every heap allocation and its size so we can report frame allocations per request
+static std::size_t allocations = 0;
+static std::size_t allocated   = 0;
+
+void *operator new(std::size_t n) {
+    allocations++;
+    allocated += n;
+    if (auto p = std::malloc(n)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+
+using namespace harbour;
+using asio::awaitable;
+
+// Nested awaitables the depth of a request's chain: connection, dispatch, middleware, Ship
+static auto nested(std::size_t depth) -> awaitable<std::size_t> {
+    if (depth == 0) co_return 0;
+    co_return 1 + co_await nested(depth - 1);
+}
+
+static auto Auth(const Request &) -> awaitable<std::optional<Response>> { co_return std::nullopt; }
+static auto Hello() -> awaitable<Response> { co_return "Hello, World!"; }
+
+// Run a benchmark loop inside the io_context so frames are allocated through asio's per-thread cache
+static void run(benchmark::State &state, auto request) {
+    asio::io_context ctx(1);
+    std::size_t calls = 0, bytes = 0;
+    asio::co_spawn(ctx, [&]() -> awaitable<void> {
+        // Warm the frame cache before measuring steady state
+        co_await request();
+        calls = allocations;
+        bytes = allocated;
+        for (auto _: state)
+            co_await request();
+        calls = allocations - calls;
+        bytes = allocated - bytes; }, asio::detached);
+    ctx.run();
+    state.counters["mallocs/request"] = benchmark::Counter(static_cast<double>(calls), benchmark::Counter::kAvgIterations);
+    state.counters["bytes/request"]   = benchmark::Counter(static_cast<double>(bytes), benchmark::Counter::kAvgIterations);
+    state.counters["frame cache"]     = ASIO_RECYCLING_ALLOCATOR_CACHE_SIZE;
+}
+
+static void BM_NestedFrames(benchmark::State &state) {
+    const auto depth = static_cast<std::size_t>(state.range(0));
+    run(state, [&]() -> awaitable<void> {
+        benchmark::DoNotOptimize(co_await nested(depth));
+    });
+}
+BENCHMARK(BM_NestedFrames)->DenseRange(1, 8);
+
+static void BM_ShipFrames(benchmark::State &state) {
+    const std::vector<detail::Ship> ships{detail::make_ship(Middleware(Auth, Hello))};
+    run(state, [&]() -> awaitable<void> {
+        Request req;
+        Response resp;
+        for (const auto &ship: ships)
+            if (ship.is_async() ? co_await ship.async_call(req, resp) : ship(req, resp))
+                break;
+        benchmark::DoNotOptimize(resp);
+    });
+}
+BENCHMARK(BM_ShipFrames);
+
+static void BM_PipelineFrames(benchmark::State &state) {
+    const auto ship = detail::make_ship(pipeline(Auth, Hello));
+    run(state, [&]() -> awaitable<void> {
+        Request req;
+        Response resp;
+        co_await ship.async_call(req, resp);
+        benchmark::DoNotOptimize(resp);
+    });
+}
+BENCHMARK(BM_PipelineFrames);
+
+BENCHMARK_MAIN();
@@ -1,6 +1,21 @@
+#include <cstdlib>
+#include <new>
+
 #include <harbour/harbour.hpp>
 #include <benchmark/benchmark.h>
 
+// Count every heap allocation so we can report allocations per parse
+static std::size_t allocations = 0;
+
+void *operator new(std::size_t n) {
+    allocations++;
+    if (auto p = std::malloc(n)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+
 static const std::string msg =
         "GET /joyent/http-parser HTTP/1.1\r\n"
         "Host: github.com\r\n"
@@ -17,9 +32,30 @@ static const std::string msg =
 
 static void BM_RequestFrom(benchmark::State &state) {
     std::shared_ptr<harbour::server::Socket> sock;
+    const auto before = allocations;
     for (auto _: state)
         benchmark::DoNotOptimize(harbour::Request::create(sock, msg.data(), msg.size()));
+    state.counters["allocs/parse"] = benchmark::Counter(static_cast<double>(allocations - before),
+                                                        benchmark::Counter::kAvgIterations);
 }
 BENCHMARK(BM_RequestFrom);
 
+static void BM_ParseLlhttp(benchmark::State &state) {
+    for (auto _: state) {
+        harbour::request::detail::RequestData data;
+        benchmark::DoNotOptimize(harbour::request::detail::parse_llhttp(data, msg.data(), msg.size()));
+        benchmark::DoNotOptimize(data);
+    }
+}
+BENCHMARK(BM_ParseLlhttp);
+
+static void BM_ParseSimd(benchmark::State &state) {
+    for (auto _: state) {
+        harbour::request::detail::RequestData data;
+        benchmark::DoNotOptimize(harbour::request::detail::parse_simd(data, msg.data(), msg.size()));
+        benchmark::DoNotOptimize(data);
+    }
+}
+BENCHMARK(BM_ParseSimd);
+
 BENCHMARK_MAIN();
\ No newline at end of file
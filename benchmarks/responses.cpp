@@ -0,0 +1,58 @@
+#include <array>
+#include <cstdlib>
+#include <memory>
+#include <new>
+
+#include <asio.hpp>
+
+#include <harbour/harbour.hpp>
+#include <benchmark/benchmark.h>
+
+// Count every heap allocation so we can report allocations per response
+static std::size_t allocations = 0;
+
+void *operator new(std::size_t n) {
+    allocations++;
+    if (auto p = std::malloc(n)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+
+using namespace harbour;
+
+// A cached page large enough that copying it shows up
+static const auto page = std::make_shared<const std::string>(16 * 1024, 'x');
+
+static void report(benchmark::State &state, std::size_t before) {
+    state.counters["allocs/response"] = benchmark::Counter(static_cast<double>(allocations - before),
+                                                           benchmark::Counter::kAvgIterations);
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * page->size()));
+}
+
+// Copy the cached page into the Response and serialize it into one string
+static void BM_ResponseCopy(benchmark::State &state) {
+    const auto before = allocations;
+    for (auto _: state) {
+        Response resp(*page);
+        benchmark::DoNotOptimize(resp.string());
+    }
+    report(state, before);
+}
+BENCHMARK(BM_ResponseCopy);
+
+// Share the cached page and gather it with the head
+static void BM_ResponseShared(benchmark::State &state) {
+    const auto before = allocations;
+    for (auto _: state) {
+        Response resp(page);
+        const auto head = resp.head();
+        const std::array<asio::const_buffer, 2> buffers{asio::buffer(head), asio::buffer(resp.data.view())};
+        benchmark::DoNotOptimize(buffers);
+    }
+    report(state, before);
+}
+BENCHMARK(BM_ResponseShared);
+
+BENCHMARK_MAIN();
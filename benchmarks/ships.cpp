@@ -0,0 +1,251 @@
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <optional>
+#include <variant>
+#include <vector>
+
+#include <asio.hpp>
+
+#include <harbour/harbour.hpp>
+#include <benchmark/benchmark.h>
+
+// Count every heap allocation so we can report allocations per dispatch
+static std::size_t allocations = 0;
+
+void *operator new(std::size_t n) {
+    allocations++;
+    if (auto p = std::malloc(n)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+
+using namespace harbour;
+using asio::awaitable;
+
+// std::variant of std::function Ship dispatch used before Ships were normalized,
+// kept here to compare against detail::Ship
+namespace legacy {
+
+    using harbour::detail::is_awaitable;
+
+    /// @brief Helper struct to overload multiple function call operators.
+    /// @tparam Ts The types of the function call operators.
+    template<class... Ts>
+    struct overloaded : Ts... {
+        using Ts::operator()...;
+    };
+
+    /// explicit deduction guide (not needed as of C++20) but AppleClang throws a fit
+    template<class... Ts>
+    overloaded(Ts...) -> overloaded<Ts...>;
+
+    /// @brief Type aliases for awaitable ship variants
+    using Ship_0  = std::function<awaitable<Response>(const Request &, Response &)>;
+    using Ship_1  = std::function<awaitable<Response>(Response &, const Request &)>;
+    using Ship_2  = std::function<awaitable<std::optional<Response>>(const Request &, Response &)>;
+    using Ship_3  = std::function<awaitable<std::optional<Response>>(Response &, const Request &)>;
+    using Ship_4  = std::function<awaitable<void>(const Request &, Response &)>;
+    using Ship_5  = std::function<awaitable<void>(Response &, const Request &)>;
+    using Ship_6  = std::function<awaitable<Response>(const Request &)>;
+    using Ship_7  = std::function<awaitable<Response>(Response &)>;
+    using Ship_8  = std::function<awaitable<std::optional<Response>>(const Request &)>;
+    using Ship_9  = std::function<awaitable<std::optional<Response>>(Response &)>;
+    using Ship_10 = std::function<awaitable<void>(const Request &)>;
+    using Ship_11 = std::function<awaitable<void>(Response &)>;
+    using Ship_12 = std::function<awaitable<Response>()>;
+    using Ship_13 = std::function<awaitable<std::optional<Response>>()>;
+    using Ship_14 = std::function<awaitable<void>()>;
+
+    /// @brief Type aliases for non-awaitable ship variants
+    using Ship_15 = std::function<Response(const Request &, Response &)>;
+    using Ship_16 = std::function<Response(Response &, const Request &)>;
+    using Ship_17 = std::function<std::optional<Response>(const Request &, Response &)>;
+    using Ship_18 = std::function<std::optional<Response>(Response &, const Request &)>;
+    using Ship_19 = std::function<void(const Request &, Response &)>;
+    using Ship_20 = std::function<void(Response &, const Request &)>;
+    using Ship_21 = std::function<Response(const Request &)>;
+    using Ship_22 = std::function<Response(Response &)>;
+    using Ship_23 = std::function<std::optional<Response>(const Request &)>;
+    using Ship_24 = std::function<std::optional<Response>(Response &)>;
+    using Ship_25 = std::function<void(const Request &)>;
+    using Ship_26 = std::function<void(Response &)>;
+    using Ship_27 = std::function<Response()>;
+    using Ship_28 = std::function<std::optional<Response>()>;
+    using Ship_29 = std::function<void()>;
+
+    /// @brief Main ship variant used
+    using Ship = std::variant<Ship_0, Ship_1, Ship_2, Ship_3, Ship_4,
+                              Ship_5, Ship_6, Ship_7, Ship_8, Ship_9,
+                              Ship_10, Ship_11, Ship_12, Ship_13, Ship_14,
+                              Ship_15, Ship_16, Ship_17, Ship_18,
+                              Ship_19, Ship_20, Ship_21, Ship_22,
+                              Ship_23, Ship_24, Ship_25, Ship_26,
+                              Ship_27, Ship_28, Ship_29>;
+
+    /// @brief Creates a Ship from a given ShipConcept.
+    /// @tparam S The type of the ship concept.
+    /// @param s The ship concept instance.
+    /// @return A Ship variant.
+    constexpr auto make_ship(auto &&s) {
+        using S = decltype(s);
+        using T = std::decay_t<S>;
+
+        // clang-format off
+        /// Awaitable ship variants
+        if constexpr (std::is_invocable_r_v<awaitable<Response>, S, const Request &, Response &>)                return Ship{Ship_0{s}};
+        else if constexpr (std::is_invocable_r_v<awaitable<Response>, S, Response &, const Request &>)                return Ship{Ship_1{s}};
+        else if constexpr (std::is_invocable_r_v<awaitable<std::optional<Response>>, S, const Request &, Response &>) return Ship{Ship_2{s}};
+        else if constexpr (std::is_invocable_r_v<awaitable<std::optional<Response>>, S, Response &, const Request &>) return Ship{Ship_3{s}};
+        else if constexpr (std::is_invocable_r_v<awaitable<void>, S, const Request &, Response &>)                    return Ship{Ship_4{s}};
+        else if constexpr (std::is_invocable_r_v<awaitable<void>, S, Response &, const Request &>)                    return Ship{Ship_5{s}};
+        else if constexpr (std::is_invocable_r_v<awaitable<Response>, S, const Request &>)                            return Ship{Ship_6{s}};
+        else if constexpr (std::is_invocable_r_v<awaitable<Response>, S, Response &>)                                 return Ship{Ship_7{s}};
+        else if constexpr (std::is_invocable_r_v<awaitable<std::optional<Response>>, S, const Request &>)             return Ship{Ship_8{s}};
+        else if constexpr (std::is_invocable_r_v<awaitable<std::optional<Response>>, S, Response &>)                  return Ship{Ship_9{s}};
+        else if constexpr (std::is_invocable_r_v<awaitable<void>, S, const Request &>)                                return Ship{Ship_10{s}};
+        else if constexpr (std::is_invocable_r_v<awaitable<void>, S, Response &>)                                     return Ship{Ship_11{s}};
+        else if constexpr (std::is_invocable_r_v<awaitable<Response>, S>)                                             return Ship{Ship_12{s}};
+        else if constexpr (std::is_invocable_r_v<awaitable<std::optional<Response>>, S>)                              return Ship{Ship_13{s}};
+        else if constexpr (std::is_invocable_r_v<awaitable<void>, S>)                                                 return Ship{Ship_14{s}};
+        
+        /// Non-awaitable ship variants
+        else if constexpr (std::is_invocable_r_v<Response, S, const Request &, Response &>)                           return Ship{Ship_15{s}};
+        else if constexpr (std::is_invocable_r_v<Response, S, Response &, const Request &>)                           return Ship{Ship_16{s}};
+        else if constexpr (std::is_invocable_r_v<std::optional<Response>, S, const Request &, Response &>)            return Ship{Ship_17{s}};
+        else if constexpr (std::is_invocable_r_v<std::optional<Response>, S, Response &, const Request &>)            return Ship{Ship_18{s}};
+        else if constexpr (std::is_invocable_r_v<void, S, const Request &, Response &>)                               return Ship{Ship_19{s}};
+        else if constexpr (std::is_invocable_r_v<void, S, Response &, const Request &>)                               return Ship{Ship_20{s}};
+        else if constexpr (std::is_invocable_r_v<Response, S, const Request &>)                                       return Ship{Ship_21{s}};
+        else if constexpr (std::is_invocable_r_v<Response, S, Response &>)                                            return Ship{Ship_22{s}};
+        else if constexpr (std::is_invocable_r_v<std::optional<Response>, S, const Request &>)                        return Ship{Ship_23{s}};
+        else if constexpr (std::is_invocable_r_v<std::optional<Response>, S, Response &>)                             return Ship{Ship_24{s}};
+        else if constexpr (std::is_invocable_r_v<void, S, const Request &>)                                           return Ship{Ship_25{s}};
+        else if constexpr (std::is_invocable_r_v<void, S, Response &>)                                                return Ship{Ship_26{s}};
+        else if constexpr (std::is_invocable_r_v<Response, S>)                                                        return Ship{Ship_27{s}};
+        else if constexpr (std::is_invocable_r_v<std::optional<Response>, S>)                                         return Ship{Ship_28{s}};
+        else if constexpr (std::is_invocable_r_v<void, S>)                                                            return Ship{Ship_29{s}};
+        // clang-format on
+    }
+
+    /// @brief Handler for processing a Request and Response using a Ship.
+    constexpr auto ShipHandler = [](const Request &req, Response &resp, auto &&ship) -> awaitable<std::optional<Response>> {
+        auto handle = [&](auto &&s, auto &&...args) -> awaitable<std::optional<Response>> {
+            using ReturnType = decltype(s(args...));
+
+            if constexpr (is_awaitable<ReturnType>::value) {
+                if constexpr (std::is_same_v<awaitable<void>, decltype(s(args...))>) {
+                    co_await s(args...);
+                    co_return std::nullopt;
+                } else {
+                    co_return co_await s(args...);
+                }
+            } else {
+                if constexpr (std::is_same_v<void, decltype(s(args...))>) {
+                    s(args...);
+                    co_return std::nullopt;
+                } else {
+                    auto ret = s(args...);
+                    co_return ret;
+                }
+            }
+        };
+
+        // clang-format off
+        auto ol = overloaded{
+                [&](auto &s) -> awaitable<std::optional<Response>> {
+                    if      constexpr (requires { s(req, resp); }) co_return co_await handle(s, req, resp);
+                    else if constexpr (requires { s(resp, req); }) co_return co_await handle(s, resp, req);
+                    else if constexpr (requires { s(req); })       co_return co_await handle(s, req);
+                    else if constexpr (requires { s(resp); })      co_return co_await handle(s, resp);
+                    else                                           co_return co_await handle(s);
+                }};
+        // clang-format on
+
+        co_return co_await std::visit(ol, ship);
+    };
+
+}// namespace legacy
+
+// Ships covering the common shapes: a synchronous handler, a synchronous middleware and an awaitable handler
+static auto Hello(const Request &) -> Response { return "Hello, World!"; }
+static auto Header(Response &resp) -> void { resp.headers["X-Harbour"] = "1"; }
+static auto Async(const Request &) -> awaitable<std::optional<Response>> { co_return std::nullopt; }
+
+// Run a benchmark loop inside a single coroutine so only dispatch is measured
+static void run(benchmark::State &state, auto dispatch) {
+    asio::io_context ctx(1);
+    const auto before = allocations;
+    asio::co_spawn(ctx, [&]() -> awaitable<void> {
+        Request req;
+        for (auto _: state) {
+            Response resp;
+            co_await dispatch(req, resp);
+            benchmark::DoNotOptimize(resp);
+        } }, asio::detached);
+    ctx.run();
+    state.counters["allocs/request"] = benchmark::Counter(static_cast<double>(allocations - before),
+                                                          benchmark::Counter::kAvgIterations);
+}
+
+static void BM_LegacyShips(benchmark::State &state) {
+    std::vector<legacy::Ship> ships{legacy::make_ship(Header), legacy::make_ship(Async), legacy::make_ship(Hello)};
+    run(state, [&](const Request &req, Response &resp) -> awaitable<void> {
+        for (const auto &ship: ships) {
+            if (auto response = co_await legacy::ShipHandler(req, resp, ship)) {
+                resp = *response;
+                co_return;
+            }
+        }
+    });
+}
+BENCHMARK(BM_LegacyShips);
+
+static void BM_Ships(benchmark::State &state) {
+    std::vector<detail::Ship> ships{detail::make_ship(Header), detail::make_ship(Async), detail::make_ship(Hello)};
+    run(state, [&](const Request &req, Response &resp) -> awaitable<void> {
+        for (const auto &ship: ships)
+            if (ship.is_async() ? co_await ship.async_call(req, resp) : ship(req, resp))
+                co_return;
+    });
+}
+BENCHMARK(BM_Ships);
+
+static void BM_Pipeline(benchmark::State &state) {
+    const auto ship = detail::make_ship(pipeline(Header, Async, Hello));
+    run(state, [&](const Request &req, Response &resp) -> awaitable<void> {
+        co_await ship.async_call(req, resp);
+    });
+}
+BENCHMARK(BM_Pipeline);
+
+static void BM_LegacySyncShip(benchmark::State &state) {
+    const auto ship = legacy::make_ship(Hello);
+    run(state, [&](const Request &req, Response &resp) -> awaitable<void> {
+        if (auto response = co_await legacy::ShipHandler(req, resp, ship))
+            resp = *response;
+    });
+}
+BENCHMARK(BM_LegacySyncShip);
+
+static void BM_SyncShip(benchmark::State &state) {
+    const auto ship = detail::make_ship(Hello);
+    run(state, [&](const Request &req, Response &resp) -> awaitable<void> {
+        ship(req, resp);
+        co_return;
+    });
+}
+BENCHMARK(BM_SyncShip);
+
+static void BM_SyncPipeline(benchmark::State &state) {
+    const auto ship = detail::make_ship(pipeline(Header, [](const Request &) -> std::optional<Response> { return {}; }, Hello));
+    run(state, [&](const Request &req, Response &resp) -> awaitable<void> {
+        ship(req, resp);
+        co_return;
+    });
+}
+BENCHMARK(BM_SyncPipeline);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,76 @@
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <new>
+#include <string>
+
+#include <harbour/harbour.hpp>
+#include <benchmark/benchmark.h>
+
+// Count every heap allocation so we can report allocations per render
+static std::size_t allocations = 0;
+
+void *operator new(std::size_t n) {
+    allocations++;
+    if (auto p = std::malloc(n)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+
+using namespace harbour;
+
+// The same page written for fmt and for the template engine
+static const auto directory = std::filesystem::temp_directory_path();
+static const auto fmt_path  = directory / "harbour_bench_page.fmt";
+static const auto tmpl_path = directory / "harbour_bench_page.html";
+
+static const std::string head = "<!DOCTYPE html><html><head><title>Harbour</title></head><body>" + std::string(2048, ' ');
+
+static auto write_pages() -> void {
+    std::ofstream(fmt_path) << head << "<h1>{}</h1>{}</body></html>";
+    std::ofstream(tmpl_path) << head << "<h1>{{title}}</h1>{{#users}}<p><b>Name: </b>{{name}} <b>Email: </b>{{email}}</p>{{/users}}</body></html>";
+}
+
+static void report(benchmark::State &state, std::size_t before) {
+    state.counters["allocs/render"] = benchmark::Counter(static_cast<double>(allocations - before),
+                                                         benchmark::Counter::kAvgIterations);
+}
+
+// Read and format the file on every render, concatenating rows like examples/database.cpp
+static void BM_RenderFile(benchmark::State &state) {
+    write_pages();
+    const auto users  = state.range(0);
+    const auto path   = fmt_path.string();
+    const auto before = allocations;
+    for (auto _: state) {
+        std::string rows;
+        for (std::int64_t i = 0; i < users; i++)
+            rows += tmpl::render("<p><b>Name: </b>{} <b>Email: </b>{}</p>", "Pegleg Billy", "billy@harbour.dev");
+        benchmark::DoNotOptimize(tmpl::render_file(path, "Users", rows));
+    }
+    report(state, before);
+}
+BENCHMARK(BM_RenderFile)->Arg(1)->Arg(16)->Arg(256);
+
+// Render the cached compiled template into a reused buffer
+static void BM_Compiled(benchmark::State &state) {
+    write_pages();
+    tmpl::List list;
+    for (std::int64_t i = 0; i < state.range(0); i++)
+        list.emplace_back(tmpl::Object{{"name", "Pegleg Billy"}, {"email", "billy@harbour.dev"}});
+    const tmpl::Value data = tmpl::Object{{"title", "Users"}, {"users", std::move(list)}};
+
+    std::string buffer;
+    const auto before = allocations;
+    for (auto _: state) {
+        buffer.clear();
+        tmpl::compile_file(tmpl_path)->render(data, buffer);
+        benchmark::DoNotOptimize(buffer.data());
+    }
+    report(state, before);
+}
+BENCHMARK(BM_Compiled)->Arg(1)->Arg(16)->Arg(256);
+
+BENCHMARK_MAIN();
@@ -3,12 +3,25 @@
 #include <cstdlib>
 #include <ctime>
 #include <memory>
+#include <new>
 
 #include <harbour/harbour.hpp>
 #include <benchmark/benchmark.h>
 
 using Ships = std::vector<harbour::detail::Ship>;
 
+// Count every heap allocation so we can report allocations per match
+static std::size_t allocations = 0;
+
+void *operator new(std::size_t n) {
+    allocations++;
+    if (auto p = std::malloc(n)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+
 struct Vec {
     std::vector<std::string> routes;
     std::vector<Ships> ships;
@@ -42,6 +55,43 @@ auto make_trie(auto &&routes) -> harbour::Trie<Ships> {
     return trie;
 }
 
+auto make_router(auto &&routes) -> harbour::router::Router<Ships> {
+    harbour::router::Router<Ships> router{};
+    for (const auto &route: routes)
+        router.insert(route, Ships{[] {}});
+    return router;
+}
+
+// Build a REST style route set mixing static routes, named parameters and catch-alls
+auto api_routes(size_t n) -> std::vector<std::string> {
+    const std::vector<std::string> resources = {"users", "repos", "orgs", "teams", "issues", "pulls",
+                                                "gists", "projects", "commits", "releases", "hooks", "keys"};
+    const std::vector<std::string> actions   = {"", "/comments", "/labels", "/events", "/members", "/settings"};
+    std::vector<std::string> routes;
+    for (size_t version = 0; routes.size() < n; version++) {
+        routes.push_back(fmt::format("/api/v{}/static/*file", version));
+        for (const auto &resource: resources) {
+            for (const auto &action: actions) {
+                const auto base = fmt::format("/api/v{}/{}", version, resource);
+                routes.push_back(base + action);
+                routes.push_back(base + "/:id" + action);
+                routes.push_back(base + "/:id" + action + "/:item");
+            }
+        }
+    }
+    routes.resize(n);
+    return routes;
+}
+
+// Turn a route pattern into a request path that matches it
+auto fill_route(std::string route) -> std::string {
+    for (auto p = route.find_first_of(":*"); p != std::string::npos; p = route.find_first_of(":*")) {
+        auto end = route.find('/', p);
+        route.replace(p, end == std::string::npos ? std::string::npos : end - p, "1234");
+    }
+    return route;
+}
+
 auto rand_strs(size_t n) -> std::vector<std::string> {
     const std::string m = "abcdefghijklmnopqrstuvwxyz";
     std::srand(std::time(0));
@@ -89,4 +139,91 @@ static void BM_Vec(benchmark::State &state) {
 }
 BENCHMARK(BM_Vec)->Arg(10)->Arg(100)->Arg(1000)->Arg(10000)->Arg(100000);
 
+static void BM_Router(benchmark::State &state) {
+    std::unique_ptr<harbour::router::Router<Ships>> router;
+    if (state.range(0) == 10) router = std::make_unique<harbour::router::Router<Ships>>(make_router(rstr0));
+    if (state.range(0) == 100) router = std::make_unique<harbour::router::Router<Ships>>(make_router(rstr1));
+    if (state.range(0) == 1000) router = std::make_unique<harbour::router::Router<Ships>>(make_router(rstr2));
+    if (state.range(0) == 10000) router = std::make_unique<harbour::router::Router<Ships>>(make_router(rstr3));
+    if (state.range(0) == 100000) router = std::make_unique<harbour::router::Router<Ships>>(make_router(rstr4));
+    for (auto _: state) {
+        benchmark::DoNotOptimize(router->match("/api/v1/foo/bar/baz/boz"));
+    }
+}
+BENCHMARK(BM_Router)->Arg(10)->Arg(100)->Arg(1000)->Arg(10000)->Arg(100000);
+
+static void BM_Frozen(benchmark::State &state) {
+    std::unique_ptr<harbour::router::Router<Ships>> router;
+    if (state.range(0) == 10) router = std::make_unique<harbour::router::Router<Ships>>(make_router(rstr0));
+    if (state.range(0) == 100) router = std::make_unique<harbour::router::Router<Ships>>(make_router(rstr1));
+    if (state.range(0) == 1000) router = std::make_unique<harbour::router::Router<Ships>>(make_router(rstr2));
+    if (state.range(0) == 10000) router = std::make_unique<harbour::router::Router<Ships>>(make_router(rstr3));
+    if (state.range(0) == 100000) router = std::make_unique<harbour::router::Router<Ships>>(make_router(rstr4));
+    const harbour::router::FrozenRouter<Ships> frozen(*router);
+    for (auto _: state) {
+        benchmark::DoNotOptimize(frozen.match("/api/v1/foo/bar/baz/boz"));
+    }
+}
+BENCHMARK(BM_Frozen)->Arg(10)->Arg(100)->Arg(1000)->Arg(10000)->Arg(100000);
+
+// Match a realistic API route set, hitting the last route inserted with its parameters filled in
+static void BM_RouterApi(benchmark::State &state) {
+    const auto routes = api_routes(state.range(0));
+    auto router       = make_router(routes);
+    const auto path   = fill_route(routes.back());
+    const auto before = allocations;
+    for (auto _: state) {
+        benchmark::DoNotOptimize(router.match(path));
+    }
+    state.counters["allocs/match"] = benchmark::Counter(static_cast<double>(allocations - before),
+                                                        benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_RouterApi)->Arg(10)->Arg(100)->Arg(1000)->Arg(10000)->Arg(100000);
+
+static void BM_FrozenApi(benchmark::State &state) {
+    const auto routes = api_routes(state.range(0));
+    auto router       = make_router(routes);
+    const harbour::router::FrozenRouter<Ships> frozen(router);
+    const auto path   = fill_route(routes.back());
+    const auto before = allocations;
+    for (auto _: state) {
+        benchmark::DoNotOptimize(frozen.match(path));
+    }
+    state.counters["allocs/match"] = benchmark::Counter(static_cast<double>(allocations - before),
+                                                        benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_FrozenApi)->Arg(10)->Arg(100)->Arg(1000)->Arg(10000)->Arg(100000);
+
+// Match a static route through the frozen table's perfect hash
+static void BM_FrozenStatic(benchmark::State &state) {
+    const auto routes = api_routes(state.range(0));
+    auto router       = make_router(routes);
+    const harbour::router::FrozenRouter<Ships> frozen(router);
+    for (auto _: state) {
+        benchmark::DoNotOptimize(frozen.match("/api/v0/users/comments"));
+    }
+}
+BENCHMARK(BM_FrozenStatic)->Arg(10)->Arg(100)->Arg(1000)->Arg(10000)->Arg(100000);
+
+// Match a static route through a table hashed at compile time
+static void BM_StaticTable(benchmark::State &state) {
+    using Table = harbour::router::StaticTable<"/", "/health", "/api/v0/users", "/api/v0/users/comments",
+                                               "/api/v0/repos", "/api/v0/repos/labels", "/api/v0/orgs", "/api/v0/orgs/members">;
+    const std::string path = "/api/v0/users/comments";
+    for (auto _: state) {
+        benchmark::DoNotOptimize(Table::find(path));
+    }
+}
+BENCHMARK(BM_StaticTable);
+
+// Miss every route in a realistic API route set
+static void BM_RouterApiMiss(benchmark::State &state) {
+    const auto routes = api_routes(state.range(0));
+    auto router       = make_router(routes);
+    for (auto _: state) {
+        benchmark::DoNotOptimize(router.match("/api/v0/unknown/1234/comments"));
+    }
+}
+BENCHMARK(BM_RouterApiMiss)->Arg(10)->Arg(100)->Arg(1000)->Arg(10000)->Arg(100000);
+
 BENCHMARK_MAIN();
\ No newline at end of file
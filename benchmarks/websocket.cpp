@@ -0,0 +1,100 @@
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include <asio.hpp>
+
+#include <harbour/harbour.hpp>
+#include <benchmark/benchmark.h>
+
+using namespace harbour;
+using namespace harbour::websocket;
+using asio::ip::tcp;
+
+// Encode a masked client frame like a browser would send
+static auto frame(std::size_t size) -> std::string {
+    std::string out;
+    out += static_cast<char>(0x80 | static_cast<uint8_t>(Opcode::Text));
+    if (size <= 125) {
+        out += static_cast<char>(0x80 | size);
+    } else {
+        out += static_cast<char>(0x80 | 126);
+        out += static_cast<char>(size >> 8);
+        out += static_cast<char>(size & 0xFF);
+    }
+    out.append("\x12\x34\x56\x78", 4);
+    out.append(size, 'h');
+    return out;
+}
+
+// A batch of frames about 64KB long, the client sends it over and over
+static auto batch(std::size_t size) -> std::string {
+    const auto one = frame(size);
+    std::string out;
+    while (out.size() < 64 * 1024) out += one;
+    return out;
+}
+
+// Decode frames from memory, the cost of parsing and unmasking alone
+static void BM_Decode(benchmark::State &state) {
+    const auto size  = static_cast<std::size_t>(state.range(0));
+    const auto bytes = batch(size);
+
+    Decoder decoder(bytes.size());
+    std::int64_t messages = 0;
+    for (auto _: state) {
+        Frame f;
+        if (decoder.next(f) != Parse::Complete) {
+            const auto space = decoder.prepare();
+            std::memcpy(space.data(), bytes.data(), bytes.size());
+            decoder.commit(bytes.size());
+            continue;
+        }
+        benchmark::DoNotOptimize(f.payload.data());
+        messages++;
+    }
+    state.SetItemsProcessed(messages);
+    state.SetBytesProcessed(messages * static_cast<std::int64_t>(size));
+}
+BENCHMARK(BM_Decode)->Arg(16)->Arg(256)->Arg(4096);
+
+// Read messages from a single loopback connection, items per second is messages per second per connection
+static void BM_Connection(benchmark::State &state) {
+    const auto size  = static_cast<std::size_t>(state.range(0));
+    const auto bytes = batch(size);
+
+    asio::io_context io(1);
+    tcp::acceptor acceptor(io, {asio::ip::make_address("127.0.0.1"), 0});
+    tcp::socket client(io);
+    client.connect(acceptor.local_endpoint());
+    auto socket = std::make_shared<server::Socket>(acceptor.accept());
+    Connection connection("key", "13", "secret", socket);
+
+    // Keep the connection saturated until the reader hangs up
+    std::thread writer([&] {
+        asio::error_code ec;
+        while (!ec) asio::write(client, asio::buffer(bytes), ec);
+    });
+
+    std::int64_t messages = 0;
+    asio::co_spawn(io, [&]() -> asio::awaitable<void> {
+        for (auto _: state) {
+            auto message = co_await connection.read();
+            if (!message) {
+                state.SkipWithError("Connection failed");
+                break;
+            }
+            messages++;
+        } }, asio::detached);
+    io.run();
+
+    std::get<server::TcpSocket>(socket->socket()).close();
+    writer.join();
+    state.SetItemsProcessed(messages);
+    state.SetBytesProcessed(messages * static_cast<std::int64_t>(size));
+}
+BENCHMARK(BM_Connection)->Arg(16)->Arg(256)->Arg(4096);
+
+BENCHMARK_MAIN();
@@ -38,6 +38,14 @@ if(NOT asio_POPULATED AND NOT TARGET asio)
         asio PUBLIC -DASIO_STANDALONE -DASIO_SEPARATE_COMPILATION -DASIO_NO_DEPRECATED
     )
 
+    # Recycle coroutine frames per thread instead of returning them to malloc.
+    # asio caches ASIO_RECYCLING_ALLOCATOR_CACHE_SIZE blocks per thread for each kind of allocation,
+    # the default of 2 is shallower than a connection's chain of awaitables.
+    # This changes the layout of asio's thread info so it must be the same for every target.
+    target_compile_definitions(
+        asio PUBLIC -DASIO_RECYCLING_ALLOCATOR_CACHE_SIZE=${HARBOUR_FRAME_CACHE_SIZE}
+    )
+
     # Fix warning : "Please define _WIN32_WINNT or _WIN32_WINDOWS appropriately."
     # https://stackoverflow.com/questions/9742003/platform-detection-in-cmake
     if(WIN32 AND CMAKE_SYSTEM_VERSION)
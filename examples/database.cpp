@@ -13,8 +13,10 @@
 
 using namespace harbour;
 
-using Database               = std::unordered_map<std::string, std::string>;
-const std::string index_tmpl = R"(<!DOCTYPE html>
+using Database = std::unordered_map<std::string, std::string>;
+
+// Compiled once, rendered on every request
+const tmpl::Template index_tmpl(R"(<!DOCTYPE html>
  <html lang="en">
  <head>
      <meta charset="UTF-8">
@@ -23,7 +25,7 @@ const std::string index_tmpl = R"(<!DOCTYPE html>
  </head>
  <body>
      <h1>Users:</h1>
-     {}
+     {{#users}}<p><b>Name: </b>{{name}} <b>Email: </b>{{email}}</p>{{/users}}
      <br>
      <h1>Add User</h1>
      <form action="/api/v1/user/add" method="POST">
@@ -36,14 +38,14 @@ const std::string index_tmpl = R"(<!DOCTYPE html>
          <input type="submit" value="Submit">
      </form>
  </body>
- </html>)";
+ </html>)");
 
 struct Index {
     auto operator()() {
-        std::string users;
+        tmpl::List users;
         for (const auto &entry: db)
-            users += tmpl::render("<p><b>Name: </b>{} <b>Email: </b>{}</p>", entry.first, entry.second);
-        return tmpl::render(index_tmpl, users);
+            users.emplace_back(tmpl::Object{{"name", entry.first}, {"email", entry.second}});
+        return index_tmpl.render(tmpl::Object{{"users", std::move(users)}});
     }
 
     Database &db;
@@ -65,9 +67,14 @@ struct NewUser {
 
 auto main() -> int {
     Database db;// Connect to your database
+
+    // Database calls block, so run them on their own pool instead of the server's thread.
+    // Blocking Ships only run on the pool's workers, so a single worker means only one Ship touches the database at a time.
+    pool::Pool database({.threads = 1});
+
     Harbour hb;
-    hb.dock("/", Index{db})                        // Pass in the database to your ship
-            .dock("/api/v1/user/add", NewUser{db});// Add new users to the db with an API
+    hb.dock("/", blocking(database, Index{db}))                        // Pass in the database to your ship
+            .dock("/api/v1/user/add", blocking(database, NewUser{db}));// Add new users to the db with an API
     hb.sail();
     return 0;
 }
\ No newline at end of file
@@ -38,6 +38,10 @@ auto main() -> int {
     // If your Middleware returns a valid response, it will
     // be sent to the user without processing the rest of the Ships in the chain
     hb.dock("/admin", Middleware(Auth, AdminPanel));
+
+    // Ships can also be composed at compile-time into a single pipeline.
+    // Every Ship runs once, in order, until one of them returns a valid Response.
+    hb.dock("/admin/panel", pipeline(Auth, AdminPanel));
     hb.sail();
 
     return 0;
@@ -21,7 +21,7 @@ auto Routed(const Request &req) -> Response {
     // Render a named route if it exists
     if (auto route = req.route) {
         // Routes contain a key value pair describing the route
-        // Key is the variable name stored on the Trie
+        // Key is the variable name of the first parameter in the docked route
         // Value is the parsed Request path that matches Key
         const auto &[key, value] = *route;
         return tmpl::render("{}: {}", key, value);
@@ -31,6 +31,14 @@ auto Routed(const Request &req) -> Response {
     return req.path;
 }
 
+// This Ship will print every named parameter of its route
+auto Params(const Request &req) -> Response {
+    std::string body;
+    for (const auto &[name, value]: req.params)
+        body += fmt::format("{}: {}\n", name, value);
+    return body;
+}
+
 auto main() -> int {
     // Disable the default Connection callback and let a Global Ship do it instead
     Harbour hb(server::Settings().with_on_connection(nullptr));
@@ -55,7 +63,16 @@ auto main() -> int {
     // In this case /multi will only be served on http::Method::GET or http::Method::POST
     hb.dock(http::Method::GET | http::Method::POST, "/multi", Routed);
 
-    // Routes are automatically converted to start and end with a '/'
+    // Routes can hold multiple named parameters, each captures a single path segment.
+    // Static routes are always preferred, so /users/me is served by Routed
+    // while /users/42/posts/7 is served by Params.
+    hb.dock("/users/:user/posts/:post", Params);
+    hb.dock("/users/me", Routed);
+
+    // A catch-all using *name captures the rest of the path, for example /static/css/site.css
+    hb.dock("/static/*file", Params);
+
+    // Routes are automatically converted to start with a '/' and trailing slashes are ignored
     hb.dock("123/456", Routed);
 
     hb.sail();
@@ -6,10 +6,42 @@
 
 #include <harbour/harbour.hpp>
 #include <memory>
+#include <string_view>
+
+using namespace harbour::request;
+
+// View a span of parsed bytes
+static auto view(std::span<const char> span) -> std::string_view {
+    return {span.data(), span.size()};
+}
+
+// Check that both parsers produced the same request
+static auto same(const detail::RequestData &a, const detail::RequestData &b) -> bool {
+    if (a.method != b.method || a.version != b.version) return false;
+    if (view(a.path) != view(b.path) || view(a.data) != view(b.data)) return false;
+    if (a.headers.size() != b.headers.size()) return false;
+    for (std::size_t i = 0; i < a.headers.size(); i++)
+        if (a.headers[i].key != b.headers[i].key || a.headers[i].value != b.headers[i].value) return false;
+    return true;
+}
 
 extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
     std::shared_ptr<harbour::server::Socket> sock;
     auto fuzz_data = reinterpret_cast<const char *>(data);
     auto req = harbour::Request::create(sock, fuzz_data, size);
+
+    // Parse only the first request like the server does, llhttp would overwrite it with any pipelined after it
+    std::size_t length = 0;
+    if (frame(std::string_view(fuzz_data, size), length) != Framing::Complete) return 0;
+
+    // Run both parser backends over the same input
+    detail::RequestData llhttp_data;
+    const auto llhttp_ok = detail::parse_llhttp(llhttp_data, fuzz_data, length);
+
+    detail::RequestData simd_data;
+    const auto simd_ok = detail::parse_simd(simd_data, fuzz_data, length) == detail::ParseResult::Ok;
+
+    // The fast path must never accept a request differently than llhttp
+    if (llhttp_ok && simd_ok && !same(llhttp_data, simd_data)) __builtin_trap();
     return 0;
-}
\ No newline at end of file
+}
@@ -144,7 +144,7 @@ namespace harbour {
         /// @return Value for Key. Empty if Key doesnt exist in the cookie map.
         [[nodiscard]] auto get(auto &&Key) -> std::optional<std::string> {
             if (auto it = data.find(Key); it != data.end()) {
-                return it->second;
+                return std::string(it->second);
             }
             return {};
         }
@@ -153,7 +153,7 @@ namespace harbour {
         //         This operation will automatically create an entry for the map.
         /// @param Key Header key.
         /// @return Reference to the header value.
-        [[nodiscard]] constexpr auto operator[](auto &&Key) -> std::string & {
+        [[nodiscard]] constexpr auto operator[](auto &&Key) -> std::pmr::string & {
             return data[Key];
         }
 
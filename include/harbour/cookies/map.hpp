@@ -10,13 +10,14 @@
 
 #include <string>
 
-#include <ankerl/unordered_dense.h>
 #include <rfl.hpp>
 
+#include "../memory.hpp"
+
 namespace harbour::cookies {
 
     /// The internal map for key=value of a cookie
-    using Map = ankerl::unordered_dense::map<std::string, std::string>;
+    using Map = memory::StringMap;
 
 }// namespace harbour::cookies
 
@@ -36,7 +37,7 @@ namespace rfl {
         static ReflType from(const harbour::cookies::Map &map) {
             ReflType obj;
             for (const auto &[k, v]: map)
-                obj[k] = v;
+                obj[std::string(k)] = v;
             return obj;
         }
     };
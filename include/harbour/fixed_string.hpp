@@ -0,0 +1,33 @@
+///  _  _             _
+/// | || | __ _  _ _ | |__  ___  _  _  _ _   A Web Server Framework For Modern C++
+/// | __ |/ _` || '_|| '_ \/ _ \| || || '_|  https://github.com/griefzz/harbour
+/// |_||_|\__,_||_|  |_.__/\___/ \_,_||_|    License: MIT
+///
+/// @file fixed_string.hpp
+/// @brief Contains the implementation of harbours compile-time string type
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <string_view>
+
+namespace harbour {
+
+    /// @brief String literal usable as a template parameter, for example dock<"/health">(Health)
+    /// @tparam N Size of the string literal including its null terminator
+    template<std::size_t N>
+    struct FixedString {
+        /// @brief Construct from a string literal
+        consteval FixedString(const char (&str)[N]) noexcept { std::copy_n(str, N, data); }
+
+        /// @brief Get the string without its null terminator
+        [[nodiscard]] constexpr auto view() const noexcept -> std::string_view { return {data, N - 1}; }
+
+        /// @brief Size of the string without its null terminator
+        [[nodiscard]] constexpr auto size() const noexcept -> std::size_t { return N - 1; }
+
+        char data[N]{};///< String data including the null terminator
+    };
+
+}// namespace harbour
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <array>
 #include <iostream>
 #include <vector>
 #include <string_view>
@@ -22,12 +23,19 @@
 #include "request/request.hpp"
 #include "response/response.hpp"
 #include "template.hpp"
+#include "pool.hpp"
+#include "offload.hpp"
 #include "log/log.hpp"
 #include "ship.hpp"
 #include "json.hpp"
 #include "server/settings.hpp"
 #include "server/server.hpp"
 #include "trie.hpp"
+#include "router/radix.hpp"
+#include "router/frozen.hpp"
+#include "router/static.hpp"
+#include "router/methods.hpp"
+#include "fixed_string.hpp"
 #include "cookies/cookies.hpp"
 #include "cookies/securecookies.hpp"
 #include "middleware/middleware.hpp"
@@ -60,50 +68,78 @@ namespace harbour {
         }
 
         /// @brief Dock Ship(s) to a given route
-        /// @param route Route to dock our Ship(s)
+        /// @param route Route to dock our Ship(s), ':name' captures a segment and '*name' the rest of the path
         /// @param ...ship Ship(s) to dock
         /// @return Chainable reference to Harbour
+        /// @throws std::invalid_argument if the route pattern is malformed
         template<detail::ShipConcept... Ships>
         constexpr auto &dock(std::string_view route, Ships &&...ship) {
             std::vector<detail::Ship> routers;
             routers.reserve(sizeof...(Ships));
             (routers.emplace_back(detail::make_ship(std::forward<Ships>(ship))), ...);
-            routes_.insert({}, std::string{route}, std::move(routers));
+            insert_route({}, route, std::move(routers));
             return *this;
         }
 
         /// @brief Dock Ship(s) to a given route with a Method constraint
         /// @param method Method constraint to use
-        /// @param route Route to dock our Ship(s)
+        /// @param route Route to dock our Ship(s), ':name' captures a segment and '*name' the rest of the path
         /// @param ...ship Ship(s) to dock
         /// @return Chainable reference to Harbour
+        /// @throws std::invalid_argument if the route pattern is malformed
         template<detail::ShipConcept... Ships>
         constexpr auto &dock(http::MethodConstraint method, std::string_view route, Ships &&...ship) {
             std::vector<detail::Ship> routers;
             routers.reserve(sizeof...(Ships));
             (routers.emplace_back(detail::make_ship(std::forward<Ships>(ship))), ...);
-            routes_.insert(method, std::string{route}, std::move(routers));
+            insert_route(method, route, std::move(routers));
             return *this;
         }
 
         /// @brief Dock Ship(s) to a given route with a Method constraint
         /// @param method Method constraint to use
-        /// @param route Route to dock our Ship(s)
+        /// @param route Route to dock our Ship(s), ':name' captures a segment and '*name' the rest of the path
         /// @param ...ship Ship(s) to dock
         /// @return Chainable reference to Harbour
+        /// @throws std::invalid_argument if the route pattern is malformed
         template<detail::ShipConcept... Ships>
         constexpr auto &dock(http::Method method, std::string_view route, Ships &&...ship) {
             return dock(static_cast<http::MethodConstraint>(method), route,
                         std::forward<Ships>(ship)...);
         }
 
+        /// @brief Dock Ship(s) to a route that is checked at compile time
+        /// @tparam Route Route to dock our Ship(s), for example dock<"/users/:id">(User)
+        /// @param ...ship Ship(s) to dock
+        /// @return Chainable reference to Harbour
+        template<FixedString Route, detail::ShipConcept... Ships>
+        constexpr auto &dock(Ships &&...ship) {
+            static_assert(!router::detail::validate(Route.view()), "Malformed route pattern");
+            return dock(Route.view(), std::forward<Ships>(ship)...);
+        }
+
+        /// @brief Dock Ship(s) to a route that is checked at compile time with a Method constraint
+        /// @tparam Route Route to dock our Ship(s), for example dock<"/users/:id">(http::Method::GET, User)
+        /// @param method Method constraint to use
+        /// @param ...ship Ship(s) to dock
+        /// @return Chainable reference to Harbour
+        template<FixedString Route, detail::ShipConcept... Ships>
+        constexpr auto &dock(http::Method method, Ships &&...ship) {
+            static_assert(!router::detail::validate(Route.view()), "Malformed route pattern");
+            return dock(method, Route.view(), std::forward<Ships>(ship)...);
+        }
+
         /// @brief Launch server and begin handling Ships
         void sail() {
+            // The route set is fixed from here on, flatten it for matching
+            frozen_  = router::FrozenRouter(routes_);
+            sailing_ = true;
+
             fmt::print(fmt::emphasis::bold | fg(fmt::color::blue_violet),
                        fmt::runtime("• Listening on: 0.0.0.0:{}\n"), settings_.port);
 
             auto ship_handler = [this](Request &req, Response &resp) -> awaitable<void> {
-                co_await handle_ships(req, resp);
+                return handle_ships(req, resp);
             };
 
             server::Server srv{ship_handler, settings_, ships_};
@@ -111,44 +147,53 @@ namespace harbour {
         }
 
     private:
+        /// @brief Insert Ship(s) into the route table, rebuilding the frozen table if we are already sailing
+        /// @param method Optional Method constraint to use
+        /// @param route Route to dock our Ship(s)
+        /// @param ships Ship(s) to dock
+        auto insert_route(std::optional<http::MethodConstraint> method, std::string_view route,
+                          std::vector<detail::Ship> &&ships) -> void {
+            routes_.emplace(route).insert(method, std::move(ships));
+            if (sailing_)
+                frozen_ = router::FrozenRouter(routes_);
+        }
+
         /// @brief Apply ships to our Request and Response
         /// @param req Request to handle
         /// @param resp Response to handle
         auto handle_ships(Request &req, Response &resp) -> awaitable<void> {
-            // Handle routed ships first
-            if (auto found = routes_.match(req.path)) {
-                auto &ships     = found->node.value()->data;
-                auto constraint = found->node.value()->method;
-                req.route       = found->get_route();
-
-                // Process routed ships if we dont have a Method constraint
-                // or if the constraint matches the Request's Method
-                if (!constraint || http::detail::matches_constraint(*constraint, req.method)) {
-                    if (co_await try_handle_ships(ships, req, resp)) {
-                        co_return;
-                    }
+            const std::vector<detail::Ship> *routed = nullptr;
+            if (auto found = frozen_.match(req.path)) {
+                req.pattern = found->pattern;
+                req.params  = found->params;
+                if (!req.params.empty())
+                    req.route = std::make_pair(req.params[0].name, req.params[0].value);
+
+                // Dispatch to the Ships docked for the Request's Method
+                routed = found->value->find(req.method);
+                if (!routed) {
+                    // Answer OPTIONS and reject any other Method the route doesnt handle
+                    resp                  = Response(req.method == http::Method::OPTIONS ? http::Status::NoContent
+                                                                                         : http::Status::MethodNotAllowed);
+                    resp.headers["Allow"] = found->value->allow();
+                    co_return;
                 }
             }
 
-            // Handle global ships if no route handled the request
-            co_await try_handle_ships(ships_, req, resp);
-        }
-
-        /// @brief Try to handle ships until one returns a response
-        /// @return true if a ship handled the request
-        auto try_handle_ships(const std::vector<detail::Ship> &ships,
-                              Request &req, Response &resp) -> awaitable<bool> {
-            for (const auto &ship: ships) {
-                if (auto response = co_await detail::ShipHandler(req, resp, ship)) {
-                    resp = *response;
-                    co_return true;
-                }
+            // Handle routed ships first, then global ships if no route handled the request.
+            // Synchronous ships are called inline, only awaitable ships suspend.
+            for (const auto *ships: std::array<const std::vector<detail::Ship> *, 2>{routed, &ships_}) {
+                if (!ships) continue;
+                for (const auto &ship: *ships)
+                    if (ship.is_async() ? co_await ship.async_call(req, resp) : ship(req, resp))
+                        co_return;
             }
-            co_return false;
         }
 
         server::Settings settings_{server::Settings::defaults()};
-        Trie<std::vector<detail::Ship>> routes_;
+        router::Router<router::Methods<std::vector<detail::Ship>>> routes_;
+        router::FrozenRouter<router::Methods<std::vector<detail::Ship>>> frozen_;
+        bool sailing_{false};
         std::vector<detail::Ship> ships_;
     };
 
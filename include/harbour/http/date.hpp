@@ -0,0 +1,83 @@
+///  _  _             _
+/// | || | __ _  _ _ | |__  ___  _  _  _ _   A Web Server Framework For Modern C++
+/// | __ |/ _` || '_|| '_ \/ _ \| || || '_|  https://github.com/griefzz/harbour
+/// |_||_|\__,_||_|  |_.__/\___/ \_,_||_|    License: MIT
+///
+/// @file date.hpp
+/// @brief Contains the implementation of HTTP dates, as used by Last-Modified and If-Modified-Since
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include <fmt/format.h>
+
+namespace harbour::http::date {
+
+    /// @brief Point in time with the one second resolution of an HTTP date
+    using Time = std::chrono::sys_seconds;
+
+    namespace detail {
+
+        /// @brief Day names starting on Sunday
+        inline constexpr std::array<std::string_view, 7> Days{"Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat"};
+
+        /// @brief Month names starting on January
+        inline constexpr std::array<std::string_view, 12> Months{"Jan", "Feb", "Mar", "Apr", "May", "Jun",
+                                                                 "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+
+        /// @brief Parse a fixed number of digits
+        /// @param s Digits to parse
+        /// @return std::optional<int> Parsed number, empty if s contains anything but digits
+        [[nodiscard]] constexpr auto digits(std::string_view s) noexcept -> std::optional<int> {
+            int n = 0;
+            for (char c: s) {
+                if (c < '0' || c > '9') return {};
+                n = n * 10 + (c - '0');
+            }
+            return n;
+        }
+
+    }// namespace detail
+
+    /// @brief Format a time as an HTTP date
+    /// @param t Time to format
+    /// @return std::string Date such as "Sun, 06 Nov 1994 08:49:37 GMT"
+    [[nodiscard]] inline auto format(Time t) -> std::string {
+        using namespace std::chrono;
+        const auto days = floor<std::chrono::days>(t);
+        const year_month_day ymd{days};
+        const hh_mm_ss hms{t - days};
+        return fmt::format("{}, {:02} {} {:04} {:02}:{:02}:{:02} GMT",
+                           detail::Days[weekday{days}.c_encoding()], static_cast<unsigned>(ymd.day()),
+                           detail::Months[static_cast<unsigned>(ymd.month()) - 1], static_cast<int>(ymd.year()),
+                           hms.hours().count(), hms.minutes().count(), hms.seconds().count());
+    }
+
+    /// @brief Parse an HTTP date in the preferred IMF-fixdate format
+    /// @param s Date such as "Sun, 06 Nov 1994 08:49:37 GMT"
+    /// @return std::optional<Time> Parsed time, empty if s is not a valid IMF-fixdate
+    [[nodiscard]] inline auto parse(std::string_view s) -> std::optional<Time> {
+        using namespace std::chrono;
+        if (s.size() != 29 || s.substr(3, 2) != ", " || s[7] != ' ' || s[11] != ' ' || s[16] != ' ' ||
+            s[19] != ':' || s[22] != ':' || s.substr(25) != " GMT")
+            return {};
+
+        std::size_t month = 0;
+        while (month < detail::Months.size() && detail::Months[month] != s.substr(8, 3)) month++;
+        if (month == detail::Months.size()) return {};
+
+        const auto d = detail::digits(s.substr(5, 2)), y = detail::digits(s.substr(12, 4));
+        const auto h = detail::digits(s.substr(17, 2)), m = detail::digits(s.substr(20, 2)), sec = detail::digits(s.substr(23, 2));
+        if (!d || !y || !h || !m || !sec || *h > 23 || *m > 59 || *sec > 60) return {};
+
+        const year_month_day ymd{year(*y), std::chrono::month(static_cast<unsigned>(month + 1)), day(static_cast<unsigned>(*d))};
+        if (!ymd.ok()) return {};
+        return sys_days(ymd) + hours(*h) + minutes(*m) + seconds(*sec);
+    }
+
+}// namespace harbour::http::date
@@ -0,0 +1,72 @@
+///  _  _             _
+/// | || | __ _  _ _ | |__  ___  _  _  _ _   A Web Server Framework For Modern C++
+/// | __ |/ _` || '_|| '_ \/ _ \| || || '_|  https://github.com/griefzz/harbour
+/// |_||_|\__,_||_|  |_.__/\___/ \_,_||_|    License: MIT
+///
+/// @file fields.hpp
+/// @brief Contains helpers for reading HTTP header fields
+#pragma once
+
+#include <cctype>
+#include <cstddef>
+#include <optional>
+#include <string_view>
+
+#include "../request/headers.hpp"
+#include "../response/headers.hpp"
+
+namespace harbour::http::fields {
+
+    /// @brief Compare two strings ignoring ASCII case, header names are case-insensitive
+    /// @param a First string
+    /// @param b Second string
+    /// @return bool True if the strings are equal ignoring case
+    [[nodiscard]] inline auto iequals(std::string_view a, std::string_view b) noexcept -> bool {
+        if (a.size() != b.size()) return false;
+        for (std::size_t i = 0; i < a.size(); i++)
+            if (std::tolower(static_cast<unsigned char>(a[i])) != std::tolower(static_cast<unsigned char>(b[i]))) return false;
+        return true;
+    }
+
+    /// @brief Remove surrounding spaces and tabs
+    /// @param s String to trim
+    /// @return std::string_view Trimmed view of s
+    [[nodiscard]] inline auto trim(std::string_view s) noexcept -> std::string_view {
+        while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) s.remove_prefix(1);
+        while (!s.empty() && (s.back() == ' ' || s.back() == '\t')) s.remove_suffix(1);
+        return s;
+    }
+
+    /// @brief Call a function with every non-empty item of a comma separated header value
+    /// @param value Header value, for example "no-cache, max-age=0"
+    /// @param fn Function called with each trimmed item
+    inline auto for_each(std::string_view value, auto &&fn) -> void {
+        while (!value.empty()) {
+            const auto comma = value.find(',');
+            if (auto item = trim(value.substr(0, comma)); !item.empty()) fn(item);
+            if (comma == std::string_view::npos) break;
+            value.remove_prefix(comma + 1);
+        }
+    }
+
+    /// @brief Find a Response header ignoring case
+    /// @param headers Response headers to search
+    /// @param key Name of the header
+    /// @return std::optional<std::string_view> Value of the header, empty if not found
+    [[nodiscard]] inline auto find(const response::Headers &headers, std::string_view key) -> std::optional<std::string_view> {
+        for (const auto &[k, v]: headers)
+            if (iequals(k, key)) return std::string_view(v);
+        return {};
+    }
+
+    /// @brief Find a Request header ignoring case. The last matching header wins.
+    /// @param headers Request headers to search
+    /// @param key Name of the header
+    /// @return std::optional<std::string_view> Value of the header, empty if not found
+    [[nodiscard]] inline auto find(const request::InlineHeaders &headers, std::string_view key) -> std::optional<std::string_view> {
+        for (std::size_t i = headers.size(); i-- > 0;)
+            if (iequals(headers[i].key, key)) return headers[i].value;
+        return {};
+    }
+
+}// namespace harbour::http::fields
@@ -8,16 +8,33 @@
 
 #pragma once
 
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+
+// winnt.h defines DELETE as an access right
+#if defined(DELETE)
+    #undef DELETE
+#endif
+
 namespace harbour::http {
 
     /// @brief HTTP Request Method
     enum class Method : std::uint8_t {
-        GET  = 1,     ///< GET method
-        POST = 1 << 1,///< POST method
-        PUT  = 1 << 2,///< PUT method (todo)
-        HEAD = 1 << 3 ///< HEAD method (todo)
+        GET     = 1,     ///< GET method
+        POST    = 1 << 1,///< POST method
+        PUT     = 1 << 2,///< PUT method
+        HEAD    = 1 << 3,///< HEAD method
+        DELETE  = 1 << 4,///< DELETE method
+        PATCH   = 1 << 5,///< PATCH method
+        OPTIONS = 1 << 6 ///< OPTIONS method
     };
 
+    /// @brief Number of supported Methods
+    inline constexpr std::size_t MethodCount = 7;
+
     /// @brief Method constraint to allow multiple methods to be used
     using MethodConstraint = std::uint8_t;
 
@@ -40,6 +57,37 @@ namespace harbour::http {
             return static_cast<MethodConstraint>(m) & mc;
         }
 
+        /// @brief Get the dense index of a Method, its bit position
+        /// @param m Method to index
+        /// @return std::size_t Index in [0, MethodCount)
+        [[nodiscard]] constexpr auto index(Method m) noexcept -> std::size_t {
+            return static_cast<std::size_t>(std::countr_zero(static_cast<MethodConstraint>(m)));
+        }
+
+        /// @brief Get the name of a Method
+        /// @param m Method to name
+        /// @return std::string_view Method name as it appears in a request, for example "GET"
+        [[nodiscard]] constexpr auto to_string(Method m) noexcept -> std::string_view {
+            switch (m) {
+                case Method::GET:
+                    return "GET";
+                case Method::POST:
+                    return "POST";
+                case Method::PUT:
+                    return "PUT";
+                case Method::HEAD:
+                    return "HEAD";
+                case Method::DELETE:
+                    return "DELETE";
+                case Method::PATCH:
+                    return "PATCH";
+                case Method::OPTIONS:
+                    return "OPTIONS";
+                default:
+                    return "";
+            }
+        }
+
     }// namespace detail
 
 }// namespace harbour::http
\ No newline at end of file
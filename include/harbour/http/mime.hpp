@@ -0,0 +1,193 @@
+///  _  _             _
+/// | || | __ _  _ _ | |__  ___  _  _  _ _   A Web Server Framework For Modern C++
+/// | __ |/ _` || '_|| '_ \/ _ \| || || '_|  https://github.com/griefzz/harbour
+/// |_||_|\__,_||_|  |_.__/\___/ \_,_||_|    License: MIT
+///
+/// @file mime.hpp
+/// @brief Contains harbours compile-time file extension to MIME type table
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <string_view>
+
+#include "../perfect_hash.hpp"
+
+namespace harbour::http::mime {
+
+    /// @brief MIME type of a file extension
+    struct Type {
+        std::string_view extension;///< Lowercase extension without the leading '.'
+        std::string_view type;     ///< MIME type sent as the Content-Type
+    };
+
+    /// @brief MIME type sent for unknown extensions
+    inline constexpr std::string_view Default = "application/octet-stream";
+
+    /// @brief Common IANA MIME types by extension
+    inline constexpr std::array Types{
+            // Text
+            Type{"txt", "text/plain; charset=utf-8"},
+            Type{"text", "text/plain; charset=utf-8"},
+            Type{"conf", "text/plain; charset=utf-8"},
+            Type{"log", "text/plain; charset=utf-8"},
+            Type{"ini", "text/plain; charset=utf-8"},
+            Type{"c", "text/plain; charset=utf-8"},
+            Type{"cpp", "text/plain; charset=utf-8"},
+            Type{"h", "text/plain; charset=utf-8"},
+            Type{"hpp", "text/plain; charset=utf-8"},
+            Type{"html", "text/html; charset=utf-8"},
+            Type{"htm", "text/html; charset=utf-8"},
+            Type{"css", "text/css; charset=utf-8"},
+            Type{"csv", "text/csv; charset=utf-8"},
+            Type{"tsv", "text/tab-separated-values; charset=utf-8"},
+            Type{"md", "text/markdown; charset=utf-8"},
+            Type{"markdown", "text/markdown; charset=utf-8"},
+            Type{"ics", "text/calendar; charset=utf-8"},
+            Type{"vtt", "text/vtt; charset=utf-8"},
+            Type{"js", "text/javascript; charset=utf-8"},
+            Type{"mjs", "text/javascript; charset=utf-8"},
+            Type{"xml", "application/xml"},
+            Type{"xsl", "application/xml"},
+            Type{"json", "application/json"},
+            Type{"jsonld", "application/ld+json"},
+            Type{"map", "application/json"},
+            Type{"webmanifest", "application/manifest+json"},
+            Type{"yaml", "application/yaml"},
+            Type{"yml", "application/yaml"},
+            Type{"toml", "application/toml"},
+            Type{"rss", "application/rss+xml"},
+            Type{"atom", "application/atom+xml"},
+            Type{"xhtml", "application/xhtml+xml"},
+            Type{"rtf", "application/rtf"},
+
+            // Images
+            Type{"png", "image/png"},
+            Type{"apng", "image/apng"},
+            Type{"jpg", "image/jpeg"},
+            Type{"jpeg", "image/jpeg"},
+            Type{"jfif", "image/jpeg"},
+            Type{"gif", "image/gif"},
+            Type{"bmp", "image/bmp"},
+            Type{"ico", "image/vnd.microsoft.icon"},
+            Type{"cur", "image/x-icon"},
+            Type{"svg", "image/svg+xml"},
+            Type{"svgz", "image/svg+xml"},
+            Type{"webp", "image/webp"},
+            Type{"avif", "image/avif"},
+            Type{"heic", "image/heic"},
+            Type{"heif", "image/heif"},
+            Type{"tif", "image/tiff"},
+            Type{"tiff", "image/tiff"},
+            Type{"jxl", "image/jxl"},
+
+            // Audio
+            Type{"mp3", "audio/mpeg"},
+            Type{"wav", "audio/wav"},
+            Type{"weba", "audio/webm"},
+            Type{"oga", "audio/ogg"},
+            Type{"ogg", "audio/ogg"},
+            Type{"opus", "audio/ogg"},
+            Type{"flac", "audio/flac"},
+            Type{"aac", "audio/aac"},
+            Type{"m4a", "audio/mp4"},
+            Type{"mid", "audio/midi"},
+            Type{"midi", "audio/midi"},
+
+            // Video
+            Type{"mp4", "video/mp4"},
+            Type{"m4v", "video/mp4"},
+            Type{"mpeg", "video/mpeg"},
+            Type{"mpg", "video/mpeg"},
+            Type{"ogv", "video/ogg"},
+            Type{"webm", "video/webm"},
+            Type{"mov", "video/quicktime"},
+            Type{"avi", "video/x-msvideo"},
+            Type{"flv", "video/x-flv"},
+            Type{"mkv", "video/x-matroska"},
+            Type{"3gp", "video/3gpp"},
+            Type{"3g2", "video/3gpp2"},
+            Type{"ts", "video/mp2t"},
+            Type{"m3u8", "application/vnd.apple.mpegurl"},
+            Type{"mpd", "application/dash+xml"},
+
+            // Fonts
+            Type{"ttf", "font/ttf"},
+            Type{"otf", "font/otf"},
+            Type{"woff", "font/woff"},
+            Type{"woff2", "font/woff2"},
+            Type{"eot", "application/vnd.ms-fontobject"},
+
+            // Documents
+            Type{"pdf", "application/pdf"},
+            Type{"epub", "application/epub+zip"},
+            Type{"doc", "application/msword"},
+            Type{"docx", "application/vnd.openxmlformats-officedocument.wordprocessingml.document"},
+            Type{"xls", "application/vnd.ms-excel"},
+            Type{"xlsx", "application/vnd.openxmlformats-officedocument.spreadsheetml.sheet"},
+            Type{"ppt", "application/vnd.ms-powerpoint"},
+            Type{"pptx", "application/vnd.openxmlformats-officedocument.presentationml.presentation"},
+            Type{"odt", "application/vnd.oasis.opendocument.text"},
+            Type{"ods", "application/vnd.oasis.opendocument.spreadsheet"},
+            Type{"odp", "application/vnd.oasis.opendocument.presentation"},
+
+            // Archives and binaries
+            Type{"zip", "application/zip"},
+            Type{"gz", "application/gzip"},
+            Type{"tgz", "application/gzip"},
+            Type{"bz2", "application/x-bzip2"},
+            Type{"xz", "application/x-xz"},
+            Type{"zst", "application/zstd"},
+            Type{"tar", "application/x-tar"},
+            Type{"7z", "application/x-7z-compressed"},
+            Type{"rar", "application/vnd.rar"},
+            Type{"jar", "application/java-archive"},
+            Type{"wasm", "application/wasm"},
+            Type{"bin", "application/octet-stream"},
+            Type{"exe", "application/octet-stream"},
+            Type{"dll", "application/octet-stream"},
+            Type{"iso", "application/octet-stream"},
+            Type{"dmg", "application/octet-stream"},
+            Type{"deb", "application/vnd.debian.binary-package"},
+            Type{"rpm", "application/x-rpm"},
+            Type{"apk", "application/vnd.android.package-archive"},
+            Type{"swf", "application/x-shockwave-flash"},
+            Type{"ps", "application/postscript"},
+            Type{"sql", "application/sql"},
+            Type{"pem", "application/x-pem-file"},
+            Type{"crt", "application/x-x509-ca-cert"},
+    };
+
+    namespace detail {
+
+        /// @brief Extensions of every Type in table order
+        [[nodiscard]] consteval auto extensions() -> std::array<std::string_view, Types.size()> {
+            std::array<std::string_view, Types.size()> keys{};
+            for (std::size_t i = 0; i < Types.size(); i++) keys[i] = Types[i].extension;
+            return keys;
+        }
+
+        /// @brief Case-insensitive perfect hash of every extension, built at compile time
+        inline constexpr perfect_hash::FixedSet<Types.size(), perfect_hash::CaseInsensitive> Set{extensions()};
+
+    }// namespace detail
+
+    /// @brief Find the MIME type of a file extension, ignoring case
+    /// @param extension Extension with or without the leading '.', for example ".html" or "PNG"
+    /// @return std::optional<std::string_view> MIME type of the extension, empty if it is unknown
+    [[nodiscard]] constexpr auto find(std::string_view extension) noexcept -> std::optional<std::string_view> {
+        if (extension.starts_with('.')) extension.remove_prefix(1);
+        if (const auto i = detail::Set.find(extension)) return Types[*i].type;
+        return {};
+    }
+
+    /// @brief Get the MIME type of a file extension, ignoring case
+    /// @param extension Extension with or without the leading '.', for example ".html" or "PNG"
+    /// @param fallback MIME type returned for unknown extensions
+    /// @return std::string_view MIME type of the extension, or fallback if it is unknown
+    [[nodiscard]] constexpr auto get(std::string_view extension, std::string_view fallback = Default) noexcept -> std::string_view {
+        return find(extension).value_or(fallback);
+    }
+
+}// namespace harbour::http::mime
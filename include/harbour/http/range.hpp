@@ -0,0 +1,127 @@
+///  _  _             _
+/// | || | __ _  _ _ | |__  ___  _  _  _ _   A Web Server Framework For Modern C++
+/// | __ |/ _` || '_|| '_ \/ _ \| || || '_|  https://github.com/griefzz/harbour
+/// |_||_|\__,_||_|  |_.__/\___/ \_,_||_|    License: MIT
+///
+/// @file range.hpp
+/// @brief Contains the implementation of HTTP byte range parsing
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include "fields.hpp"
+
+/// @brief Most ranges accepted in a single Range header, Requests asking for more are served in full
+#ifndef HARBOUR_MAX_RANGES
+    #define HARBOUR_MAX_RANGES 16
+#endif
+
+namespace harbour::http::range {
+
+    /// @brief Satisfiable byte range of a representation
+    struct Range {
+        std::uint64_t offset{0};///< Offset of the first byte
+        std::uint64_t length{0};///< Number of bytes
+
+        /// @brief Get the offset of the last byte
+        [[nodiscard]] constexpr auto last() const noexcept -> std::uint64_t { return offset + length - 1; }
+
+        constexpr auto operator==(const Range &) const -> bool = default;
+    };
+
+    /// @brief Result of parsing a Range header
+    enum class Status {
+        Ignore,       ///< The header is missing, malformed or asks for too much, send the whole representation
+        Satisfiable,  ///< At least one range can be sent
+        Unsatisfiable ///< No range overlaps the representation, send 416 Range Not Satisfiable
+    };
+
+    namespace detail {
+
+        /// @brief Parse an unsigned decimal number
+        [[nodiscard]] inline auto number(std::string_view s) noexcept -> std::optional<std::uint64_t> {
+            std::uint64_t n = 0;
+            if (s.empty()) return {};
+            const auto [end, ec] = std::from_chars(s.data(), s.data() + s.size(), n);
+            if (ec != std::errc{} || end != s.data() + s.size()) return {};
+            return n;
+        }
+
+    }// namespace detail
+
+    /// @brief Parse a Range header against the size of a representation.
+    ///        Ranges are clamped to the representation, unsatisfiable ranges are dropped and
+    ///        overlapping or adjacent ranges are merged, in the order they were requested.
+    /// @param value Value of the Range header, for example "bytes=0-499, -500"
+    /// @param size Size of the representation in bytes
+    /// @param ranges Receives the satisfiable ranges
+    /// @return Status What to send
+    [[nodiscard]] inline auto parse(std::string_view value, std::uint64_t size, std::vector<Range> &ranges) -> Status {
+        ranges.clear();
+        value = fields::trim(value);
+        if (!value.starts_with("bytes=")) return Status::Ignore;
+        value.remove_prefix(6);
+
+        bool valid    = true;
+        std::size_t n = 0;
+        fields::for_each(value, [&](std::string_view spec) {
+            const auto dash = spec.find('-');
+            if (!valid || dash == std::string_view::npos || ++n > HARBOUR_MAX_RANGES) {
+                valid = false;
+                return;
+            }
+
+            const auto first = fields::trim(spec.substr(0, dash));
+            const auto last  = fields::trim(spec.substr(dash + 1));
+            if (first.empty()) {
+                // Suffix range, the final N bytes
+                const auto suffix = detail::number(last);
+                if (!suffix)
+                    valid = false;
+                else if (*suffix && size)
+                    ranges.push_back({size - std::min(*suffix, size), std::min(*suffix, size)});
+                return;
+            }
+
+            const auto start = detail::number(first);
+            const auto end   = last.empty() ? std::optional<std::uint64_t>(UINT64_MAX) : detail::number(last);
+            if (!start || !end || *end < *start) {
+                valid = false;
+                return;
+            }
+            if (*start < size) ranges.push_back({*start, std::min(*end, size - 1) - *start + 1});
+        });
+
+        if (!valid || n == 0) {
+            ranges.clear();
+            return Status::Ignore;
+        }
+        if (ranges.empty()) return Status::Unsatisfiable;
+
+        // Merge overlapping and adjacent ranges into the earlier one
+        for (std::size_t i = 0; i < ranges.size(); i++) {
+            for (std::size_t j = i + 1; j < ranges.size();) {
+                auto &a = ranges[i];
+                auto &b = ranges[j];
+                if (b.offset <= a.offset + a.length && a.offset <= b.offset + b.length) {
+                    const auto end = std::max(a.offset + a.length, b.offset + b.length);
+                    a.offset       = std::min(a.offset, b.offset);
+                    a.length       = end - a.offset;
+                    ranges.erase(ranges.begin() + static_cast<std::ptrdiff_t>(j));
+                    j = i + 1;
+                } else {
+                    j++;
+                }
+            }
+        }
+        return Status::Satisfiable;
+    }
+
+}// namespace harbour::http::range
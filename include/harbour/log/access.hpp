@@ -0,0 +1,382 @@
+///  _  _             _
+/// | || | __ _  _ _ | |__  ___  _  _  _ _   A Web Server Framework For Modern C++
+/// | __ |/ _` || '_|| '_ \/ _ \| || || '_|  https://github.com/griefzz/harbour
+/// |_||_|\__,_||_|  |_.__/\___/ \_,_||_|    License: MIT
+///
+/// @file access.hpp
+/// @brief Contains the implementation of harbours structured access log.
+///        Binary logs are raw FileHeaders and Records in the byte order of the host that wrote them,
+///        readers on a host of the other byte order must swap every integer field.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <asio.hpp>
+#include <ankerl/unordered_dense.h>
+#include <fmt/core.h>
+#include <fmt/format.h>
+
+#include "../http/method.hpp"
+#include "../http/status.hpp"
+#include "../memory.hpp"
+
+/// @brief Bytes of the route pattern kept per access record, longer routes are truncated
+#ifndef HARBOUR_ACCESS_ROUTE_SIZE
+    #define HARBOUR_ACCESS_ROUTE_SIZE 64
+#endif
+
+namespace harbour::log::access {
+
+    /// @brief Encoding of an access log file
+    enum class Format : std::uint8_t {
+        Binary,   ///< Fixed-size Records after a FileHeader
+        JsonLines,///< One JSON object per line
+    };
+
+    /// @brief Header at the start of every binary access log file
+    struct FileHeader {
+        std::array<char, 4> magic{'H', 'B', 'A', 'L'};///< Identifies a binary access log
+        std::uint16_t version{1};                     ///< Layout version of Record
+        std::uint16_t record_size{0};                 ///< sizeof(Record) of the writer
+    };
+
+    /// @brief One served Request, written as-is to binary logs
+    struct Record {
+        std::uint64_t timestamp{0};             ///< Microseconds since the Unix epoch when the Request was read
+        std::uint64_t bytes{0};                 ///< Bytes of the Response written to the socket
+        std::uint32_t latency{0};               ///< Microseconds from reading the Request to writing the Response
+        std::uint16_t status{0};                ///< HTTP status code
+        std::uint16_t port{0};                  ///< Peer port
+        std::array<std::uint8_t, 16> address{}; ///< Peer address, IPv4 addresses use the first 4 bytes
+        std::uint8_t family{0};                 ///< 4 or 6 for the peer address, 0 if unknown
+        http::Method method{http::Method::GET}; ///< HTTP method
+        std::uint8_t route_size{0};             ///< Bytes of route used
+        std::array<std::uint8_t, 5> reserved{}; ///< Always zero, keeps route 8 byte aligned
+        char route[HARBOUR_ACCESS_ROUTE_SIZE]{};///< Route pattern that matched, or the path if none did, zero filled
+
+        /// @brief Set the route, truncating it if it doesn't fit
+        /// @param value Route pattern or path
+        auto set_route(std::string_view value) noexcept -> void {
+            // Records are reused, clear the previous route so none of it reaches the file
+            std::fill(std::begin(route), std::end(route), '\0');
+            route_size = static_cast<std::uint8_t>(std::min(value.size(), sizeof(route)));
+            std::copy_n(value.data(), route_size, route);
+        }
+
+        /// @brief Get the route
+        [[nodiscard]] auto get_route() const noexcept -> std::string_view { return {route, route_size}; }
+
+        /// @brief Set the peer from an endpoint
+        /// @param endpoint Remote endpoint of the connection
+        auto set_peer(const asio::ip::tcp::endpoint &endpoint) noexcept -> void {
+            port = endpoint.port();
+            address.fill(0);
+            if (endpoint.address().is_v4()) {
+                const auto bytes = endpoint.address().to_v4().to_bytes();
+                std::copy(bytes.begin(), bytes.end(), address.begin());
+                family = 4;
+            } else {
+                const auto bytes = endpoint.address().to_v6().to_bytes();
+                std::copy(bytes.begin(), bytes.end(), address.begin());
+                family = 6;
+            }
+        }
+
+        /// @brief Get the peer address as text
+        [[nodiscard]] auto peer() const -> std::string {
+            if (family == 4) return asio::ip::address_v4({address[0], address[1], address[2], address[3]}).to_string();
+            if (family == 6) return asio::ip::address_v6(address).to_string();
+            return {};
+        }
+    };
+
+    static_assert(std::is_trivially_copyable_v<Record>, "Records are written to disk as raw bytes");
+    static_assert(HARBOUR_ACCESS_ROUTE_SIZE <= 255, "route_size is a single byte");
+    static_assert(HARBOUR_ACCESS_ROUTE_SIZE % 8 == 0, "Records can't end in padding");
+    static_assert(sizeof(Record) == 48 + HARBOUR_ACCESS_ROUTE_SIZE, "Every byte of a Record is a named field");
+    static_assert(std::has_unique_object_representations_v<Record>, "Records have no padding bytes");
+
+    /// @brief Append a Record as a line of JSON
+    /// @param out String to append to
+    /// @param record Record to encode
+    inline auto append_json(std::string &out, const Record &record) -> void {
+        auto it = std::back_inserter(out);
+        fmt::format_to(it, R"({{"ts":{},"method":"{}","route":")", record.timestamp, http::detail::to_string(record.method));
+        for (const auto c: record.get_route()) {
+            if (c == '"' || c == '\\')
+                fmt::format_to(it, "\\{}", c);
+            else if (static_cast<unsigned char>(c) < 0x20)
+                fmt::format_to(it, "\\u{:04x}", static_cast<unsigned>(c));
+            else
+                out += c;
+        }
+        fmt::format_to(it, R"(","status":{},"bytes":{},"latency_us":{},"peer":"{}","port":{}}})", record.status,
+                       record.bytes, record.latency, record.peer(), record.port);
+        out += '\n';
+    }
+
+    /// @brief Settings for an access Log
+    struct Settings {
+        std::filesystem::path path{"access.log"};                   ///< File to write, rotated files get .1, .2, ... appended
+        Format format{Format::Binary};                              ///< Encoding of the file
+        std::uint64_t max_bytes{64 * 1024 * 1024};                  ///< Rotate once the file would grow past this size, 0 never rotates
+        std::size_t max_files{4};                                   ///< Rotated files kept besides the current one
+        std::size_t batch{256};                                     ///< Queued records that wake the writer early
+        std::chrono::milliseconds interval{1000};                   ///< Longest time a record waits before it is written
+        std::size_t capacity{65536};                                ///< Records queued before new records are dropped
+        std::uint32_t sample{1};                                    ///< Keep 1 in sample records of routes without a rule
+        std::vector<std::pair<std::string, std::uint32_t>> routes{};///< Keep 1 in N records of a route pattern
+    };
+
+    /// @brief Counters of an access Log
+    struct Stats {
+        std::uint64_t written{0};///< Records written to disk
+        std::uint64_t sampled{0};///< Records skipped by sampling
+        std::uint64_t dropped{0};///< Records dropped because the queue was full
+        std::uint64_t rotated{0};///< Files rotated
+    };
+
+    /// @class Log
+    /// @brief Structured access log.
+    ///        The server fills a fixed-size Record per Request and queues it without formatting anything,
+    ///        a background thread swaps the queue out and encodes and writes the whole batch with one write,
+    ///        rotating the file once it grows past max_bytes. Busy routes can be sampled so they don't saturate the disk.
+    class Log {
+    public:
+        /// @brief Open the log file and start the writer
+        /// @param settings Settings to use
+        /// @throws std::system_error if the file can't be opened
+        explicit Log(Settings settings) : settings_(std::move(settings)) {
+            for (const auto &[route, every]: settings_.routes)
+                rules_.emplace(route, Rule{std::max<std::uint32_t>(every, 1), rules_.size()});
+            counters_ = std::make_unique<std::atomic<std::uint64_t>[]>(rules_.size() + 1);
+
+            queue_.reserve(settings_.batch);
+            open();
+            writer_ = std::thread([this] { run(); });
+        }
+
+        Log(const Log &)            = delete;
+        Log &operator=(const Log &) = delete;
+
+        /// @brief Write every queued record and close the file
+        ~Log() {
+            {
+                std::lock_guard lock(mutex_);
+                stopping_ = true;
+            }
+            wake_.notify_one();
+            writer_.join();
+            if (file_) std::fclose(file_);
+        }
+
+        /// @brief Decide whether a Request on a route should be recorded
+        /// @param route Route pattern that matched the Request
+        /// @return bool True if the Request should be recorded
+        [[nodiscard]] auto sample(std::string_view route) noexcept -> bool {
+            std::uint32_t every = settings_.sample;
+            std::size_t counter = rules_.size();
+            if (const auto it = rules_.find(route); it != rules_.end()) {
+                every   = it->second.every;
+                counter = it->second.counter;
+            }
+            if (every <= 1) return true;
+            if (counters_[counter].fetch_add(1, std::memory_order_relaxed) % every == 0) return true;
+            sampled_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        /// @brief Queue a Record for writing
+        /// @param record Record to queue
+        /// @return bool False if the queue was full and the Record was dropped
+        auto record(const Record &record) -> bool {
+            std::size_t queued;
+            {
+                std::lock_guard lock(mutex_);
+                if (queue_.size() >= settings_.capacity) {
+                    dropped_.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                }
+                queue_.push_back(record);
+                queued = queue_.size();
+            }
+            if (queued == settings_.batch) wake_.notify_one();
+            return true;
+        }
+
+        /// @brief Write every record queued before the call
+        auto flush() -> void {
+            std::unique_lock lock(mutex_);
+            const auto target = enqueued_ + queue_.size();
+            flush_            = true;
+            wake_.notify_one();
+            done_.wait(lock, [&] { return flushed_ >= target; });
+        }
+
+        /// @brief Get the counters of the Log
+        [[nodiscard]] auto stats() const noexcept -> Stats {
+            return {written_.load(std::memory_order_relaxed), sampled_.load(std::memory_order_relaxed),
+                    dropped_.load(std::memory_order_relaxed), rotated_.load(std::memory_order_relaxed)};
+        }
+
+    private:
+        /// @brief Sample rate of a route pattern
+        struct Rule {
+            std::uint32_t every;///< Keep 1 in every records
+            std::size_t counter;///< Index of the rule's counter
+        };
+
+        /// @brief Sample rules per route pattern, searchable with a string_view
+        using Rules = ankerl::unordered_dense::map<std::string, Rule, memory::StringHash, memory::StringEqual>;
+
+        /// @brief Open the log file for appending, starting binary files with a FileHeader
+        auto open() -> void {
+            file_ = std::fopen(settings_.path.string().c_str(), "ab");
+            if (!file_)
+                throw std::system_error(errno, std::generic_category(), fmt::format("Failed to open {}", settings_.path.string()));
+
+            std::error_code ec;
+            size_ = std::filesystem::file_size(settings_.path, ec);
+            if (ec) size_ = 0;
+            if (size_ == 0 && settings_.format == Format::Binary) {
+                const FileHeader header{.record_size = sizeof(Record)};
+                std::fwrite(&header, sizeof(header), 1, file_);
+                size_ = sizeof(header);
+            }
+        }
+
+        /// @brief Shift path.N-1 to path.N, ..., path to path.1 and open a new file
+        auto rotate() -> void {
+            std::fclose(file_);
+            file_ = nullptr;
+
+            std::error_code ec;
+            const auto name = [&](std::size_t i) {
+                auto p = settings_.path;
+                p += fmt::format(".{}", i);
+                return p;
+            };
+            if (settings_.max_files == 0) {
+                std::filesystem::remove(settings_.path, ec);
+            } else {
+                std::filesystem::remove(name(settings_.max_files), ec);
+                for (auto i = settings_.max_files - 1; i > 0; i--)
+                    std::filesystem::rename(name(i), name(i + 1), ec);
+                std::filesystem::rename(settings_.path, name(1), ec);
+            }
+            rotated_.fetch_add(1, std::memory_order_relaxed);
+            open();
+        }
+
+        /// @brief Encode and write a batch of records
+        /// @param records Records to write
+        auto write(const std::vector<Record> &records) -> void {
+            if (records.empty()) return;
+            if (!file_) {
+                try {
+                    open();
+                } catch (const std::system_error &) {
+                    // Can't reopen the log, drop the batch rather than take down the writer
+                    dropped_.fetch_add(records.size(), std::memory_order_relaxed);
+                    return;
+                }
+            }
+
+            buffer_.clear();
+            if (settings_.format == Format::Binary) {
+                const auto *bytes = reinterpret_cast<const char *>(records.data());
+                buffer_.append(bytes, records.size() * sizeof(Record));
+            } else {
+                for (const auto &record: records) append_json(buffer_, record);
+            }
+
+            // Batches larger than max_bytes still go to a fresh file instead of rotating forever
+            const std::uint64_t empty = settings_.format == Format::Binary ? sizeof(FileHeader) : 0;
+            if (settings_.max_bytes && size_ > empty && size_ + buffer_.size() > settings_.max_bytes) {
+                try {
+                    rotate();
+                } catch (const std::system_error &) {
+                    dropped_.fetch_add(records.size(), std::memory_order_relaxed);
+                    return;
+                }
+            }
+
+            std::fwrite(buffer_.data(), 1, buffer_.size(), file_);
+            std::fflush(file_);
+            size_ += buffer_.size();
+            written_.fetch_add(records.size(), std::memory_order_relaxed);
+        }
+
+        /// @brief Writer loop, wakes on a full batch, a flush or the interval
+        auto run() -> void {
+            std::vector<Record> batch;
+            batch.reserve(settings_.batch);
+
+            std::unique_lock lock(mutex_);
+            for (;;) {
+                wake_.wait_for(lock, settings_.interval, [&] {
+                    return stopping_ || flush_ || queue_.size() >= settings_.batch;
+                });
+
+                // Swap the queue out so producers keep queueing while the batch is written
+                batch.swap(queue_);
+                enqueued_ += batch.size();
+                flush_ = false;
+                const bool stopping = stopping_;
+
+                lock.unlock();
+                write(batch);
+                batch.clear();
+                lock.lock();
+
+                flushed_ = enqueued_;
+                done_.notify_all();
+                if (stopping && queue_.empty()) break;
+            }
+        }
+
+        Settings settings_;                                     ///< Settings of the Log
+        Rules rules_;                                           ///< Sample rate per route pattern
+        std::unique_ptr<std::atomic<std::uint64_t>[]> counters_;///< Records seen per rule, the last is the default
+        std::mutex mutex_;                                      ///< Guards the queue and writer state
+        std::condition_variable wake_;                          ///< Wakes the writer
+        std::condition_variable done_;                          ///< Wakes flush
+        std::vector<Record> queue_;                             ///< Records waiting for the writer
+        std::uint64_t enqueued_{0};                             ///< Records taken by the writer
+        std::uint64_t flushed_{0};                              ///< Records the writer is done with
+        bool flush_{false};                                     ///< Set by flush to write without waiting
+        bool stopping_{false};                                  ///< Set when the writer should finish
+        std::FILE *file_{nullptr};                              ///< Current log file, only touched by the writer after construction
+        std::uint64_t size_{0};                                 ///< Bytes in the current file
+        std::string buffer_;                                    ///< Encoded batch, reused between batches
+        std::atomic<std::uint64_t> written_{0};                 ///< Records written
+        std::atomic<std::uint64_t> sampled_{0};                 ///< Records skipped by sampling
+        std::atomic<std::uint64_t> dropped_{0};                 ///< Records dropped
+        std::atomic<std::uint64_t> rotated_{0};                 ///< Files rotated
+        std::thread writer_;                                    ///< Background writer, started last
+    };
+
+    /// @brief Convenience type for a std::shared_ptr<Log>, Settings are copied so Logs are shared
+    using SharedLog = std::shared_ptr<Log>;
+
+}// namespace harbour::log::access
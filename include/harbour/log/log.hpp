@@ -20,12 +20,14 @@
 #include <fmt/color.h>
 #include <fmt/ranges.h>
 
+#include "logger.hpp"
+
 namespace harbour::log {
     namespace detail {
 
-        // Internal wrapper for printing with a style
-        inline void vlog(fmt::text_style style, fmt::string_view fmt, fmt::format_args args) {
-            fmt::print(style, "{}", fmt::vformat(fmt, args));
+        // Queue a record for the writer, formatting it once into the calling thread's ring
+        inline void vlog(Level level, fmt::string_view fmt, fmt::format_args args) {
+            logger().log(level, fmt, args);
         }
 
         auto emphasis = fmt::emphasis::bold;
@@ -37,19 +39,13 @@ namespace harbour::log {
     /// @param ...args Arguments to log
     template<class... T>
     auto info(fmt::format_string<T...> fmt, T &&...args) {
-        const auto style = detail::emphasis | fg(fmt::color::gray);
-        fmt::print(style, "• ");
-        detail::vlog(style, fmt, fmt::make_format_args(args...));
-        fmt::print("\n");
+        detail::vlog(Level::Info, fmt, fmt::make_format_args(args...));
     }
 
     /// @brief Report an info log to stdout
     /// @param arg Argument to log
     auto info(const std::string_view arg) {
-        const auto style = detail::emphasis | fg(fmt::color::gray);
-        fmt::print(style, "• ");
-        fmt::print(style, fmt::runtime(arg));
-        fmt::print("\n");
+        detail::vlog(Level::Info, arg, {});
     }
 
     /// @brief Report a warning log to stdout
@@ -57,39 +53,29 @@ namespace harbour::log {
     /// @param ...args Arguments to log
     template<class... T>
     auto warn(fmt::format_string<T...> fmt, T &&...args) {
-        const auto style = detail::emphasis | fg(fmt::color::orange);
-        fmt::print(style, "• ");
-        detail::vlog(style, fmt, fmt::make_format_args(args...));
-        fmt::print("\n");
+        detail::vlog(Level::Warn, fmt, fmt::make_format_args(args...));
     }
 
     /// @brief Report a warning log to stdout
     /// @param arg Argument to log
     auto warn(const std::string_view arg) {
-        const auto style = detail::emphasis | fg(fmt::color::orange);
-        fmt::print(style, "• ");
-        fmt::print(style, fmt::runtime(arg));
-        fmt::print("\n");
+        detail::vlog(Level::Warn, arg, {});
     }
 
-    /// @brief Report a critical log to stdout
+    /// @brief Report a critical log to stdout, waiting until it has been written
     /// @param fmt Format for the log
     /// @param ...args Arguments to log
     template<class... T>
     auto critical(fmt::format_string<T...> fmt, T &&...args) {
-        const auto style = detail::emphasis | fg(fmt::color::red);
-        fmt::print(style, "• ");
-        detail::vlog(style, fmt, fmt::make_format_args(args...));
-        fmt::print("\n");
+        detail::vlog(Level::Critical, fmt, fmt::make_format_args(args...));
+        flush();
     }
 
-    /// @brief Report a critical log to stdout
+    /// @brief Report a critical log to stdout, waiting until it has been written
     /// @param arg Argument to log
     auto critical(const std::string_view arg) {
-        const auto style = detail::emphasis | fg(fmt::color::red);
-        fmt::print(style, "• ");
-        fmt::print(style, fmt::runtime(arg));
-        fmt::print("\n");
+        detail::vlog(Level::Critical, arg, {});
+        flush();
     }
 
-}// namespace harbour::log
\ No newline at end of file
+}// namespace harbour::log
@@ -0,0 +1,267 @@
+///  _  _             _
+/// | || | __ _  _ _ | |__  ___  _  _  _ _   A Web Server Framework For Modern C++
+/// | __ |/ _` || '_|| '_ \/ _ \| || || '_|  https://github.com/griefzz/harbour
+/// |_||_|\__,_||_|  |_.__/\___/ \_,_||_|    License: MIT
+///
+/// @file logger.hpp
+/// @brief Contains the implementation of harbours asynchronous log writer
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fmt/color.h>
+#include <fmt/core.h>
+#include <fmt/format.h>
+
+/// @brief Bytes of formatted text kept per log record, longer messages are truncated
+#ifndef HARBOUR_LOG_RECORD_SIZE
+    #define HARBOUR_LOG_RECORD_SIZE 256
+#endif
+
+/// @brief Records each thread can queue before new records are dropped
+#ifndef HARBOUR_LOG_QUEUE
+    #define HARBOUR_LOG_QUEUE 1024
+#endif
+
+namespace harbour::log {
+
+    /// @brief Severity of a log record
+    enum class Level : std::uint8_t {
+        Info,    ///< Normal information
+        Warn,    ///< Unexpected but recoverable issues
+        Critical,///< Catastrophic issues
+    };
+
+    /// @brief Counters of the log writer
+    struct Stats {
+        std::uint64_t written{0};///< Records written to stdout
+        std::uint64_t dropped{0};///< Records dropped because their thread's queue was full
+    };
+
+    namespace detail {
+
+        /// @brief Log record formatted by the thread that logged it
+        struct Record {
+            Level level{Level::Info};             ///< Severity
+            bool truncated{false};                ///< True if the message didn't fit
+            std::uint16_t size{0};                ///< Bytes of text used
+            char text[HARBOUR_LOG_RECORD_SIZE]{}; ///< Formatted message
+        };
+
+        /// @brief Queue of records with a single producing thread and the writer as its only consumer
+        struct Ring {
+            std::vector<Record> records = std::vector<Record>(HARBOUR_LOG_QUEUE);///< Record slots
+            std::atomic<std::size_t> head{0};                                  ///< Next record to write, owned by the writer
+            std::atomic<std::size_t> tail{0};                                  ///< Next free slot, owned by the producer
+            std::atomic<std::uint64_t> dropped{0};                             ///< Records dropped since the writer last looked
+            std::atomic<bool> orphaned{false};                                 ///< Set once the producing thread has exited
+        };
+
+        /// @class Logger
+        /// @brief Asynchronous log writer.
+        ///        Each logging thread formats its records straight into its own lock-free ring and a
+        ///        background thread drains every ring, styles the records and writes them to stdout in
+        ///        batches, so logging never waits on the terminal. A full ring drops new records and the
+        ///        writer reports how many were lost. Records are written in order per thread.
+        class Logger {
+        public:
+            Logger() : writer_([this] { run(); }) {}
+
+            Logger(const Logger &)            = delete;
+            Logger &operator=(const Logger &) = delete;
+
+            ~Logger() { stop(); }
+
+            /// @brief Format a record into the calling thread's ring
+            /// @param level Severity of the record
+            /// @param fmt Format of the message
+            /// @param args Arguments of the message
+            auto log(Level level, fmt::string_view fmt, fmt::format_args args) -> void {
+                if (stopped_.load(std::memory_order_acquire)) {
+                    // The writer is gone, write straight to stdout
+                    Record record;
+                    fill(record, level, fmt, args);
+                    std::string line;
+                    append(line, record);
+                    std::lock_guard lock(mutex_);
+                    std::fwrite(line.data(), 1, line.size(), stdout);
+                    std::fflush(stdout);
+                    return;
+                }
+
+                auto &ring       = local();
+                const auto tail  = ring.tail.load(std::memory_order_relaxed);
+                const auto head  = ring.head.load(std::memory_order_acquire);
+                if (tail - head == ring.records.size()) {
+                    ring.dropped.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+
+                fill(ring.records[tail % ring.records.size()], level, fmt, args);
+                ring.tail.store(tail + 1, std::memory_order_release);
+                queued_.fetch_add(1, std::memory_order_release);
+                queued_.notify_one();
+            }
+
+            /// @brief Wait until every record queued before the call has been written
+            auto flush() -> void {
+                const auto target = queued_.load(std::memory_order_acquire);
+                for (auto done = written_.load(std::memory_order_acquire); done < target && !stopped_.load();
+                     done      = written_.load(std::memory_order_acquire))
+                    written_.wait(done);
+            }
+
+            /// @brief Get the counters of the writer
+            [[nodiscard]] auto stats() const noexcept -> Stats {
+                return {written_.load(std::memory_order_relaxed), dropped_.load(std::memory_order_relaxed)};
+            }
+
+            /// @brief Write every queued record and stop the writer, later records are written synchronously
+            auto stop() -> void {
+                if (stopping_.exchange(true)) return;
+                queued_.fetch_add(1, std::memory_order_release);
+                queued_.notify_one();
+                writer_.join();
+                stopped_.store(true, std::memory_order_release);
+                written_.notify_all();
+            }
+
+        private:
+            /// @brief Format a message into a record, truncating it if it doesn't fit
+            static auto fill(Record &record, Level level, fmt::string_view fmt, fmt::format_args args) -> void {
+                const auto result = fmt::vformat_to_n(record.text, sizeof(record.text), fmt, args);
+                record.level      = level;
+                record.truncated  = result.size > sizeof(record.text);
+                record.size       = static_cast<std::uint16_t>(std::min(result.size, sizeof(record.text)));
+            }
+
+            /// @brief Append a styled record as a line
+            static auto append(std::string &out, const Record &record) -> void {
+                const auto color = record.level == Level::Info   ? fmt::color::gray
+                                   : record.level == Level::Warn ? fmt::color::orange
+                                                                 : fmt::color::red;
+                const auto style = fmt::emphasis::bold | fg(color);
+                fmt::format_to(std::back_inserter(out), style, "• {}{}", fmt::string_view(record.text, record.size),
+                               record.truncated ? "…" : "");
+                out += '\n';
+            }
+
+            /// @brief Get the calling thread's ring, registering it with the writer on first use
+            auto local() -> Ring & {
+                // Marks the ring orphaned when the thread exits so the writer can release it once drained
+                struct Handle {
+                    std::shared_ptr<Ring> ring;
+                    ~Handle() {
+                        if (ring) ring->orphaned.store(true, std::memory_order_release);
+                    }
+                };
+
+                thread_local Handle handle;
+                if (!handle.ring) {
+                    handle.ring = std::make_shared<Ring>();
+                    std::lock_guard lock(mutex_);
+                    rings_.push_back(handle.ring);
+                }
+                return *handle.ring;
+            }
+
+            /// @brief Write every queued record in one batch
+            /// @return bool True if anything was written
+            auto drain() -> bool {
+                std::uint64_t count = 0;
+                batch_.clear();
+                {
+                    std::lock_guard lock(mutex_);
+                    for (auto &ring: rings_) {
+                        const auto tail = ring->tail.load(std::memory_order_acquire);
+                        auto head       = ring->head.load(std::memory_order_relaxed);
+                        for (; head != tail; head++, count++)
+                            append(batch_, ring->records[head % ring->records.size()]);
+                        ring->head.store(head, std::memory_order_release);
+
+                        if (const auto lost = ring->dropped.exchange(0, std::memory_order_relaxed)) {
+                            dropped_.fetch_add(lost, std::memory_order_relaxed);
+                            append(batch_, warning(lost));
+                        }
+                    }
+
+                    // Release the rings of threads that have exited once they are empty
+                    std::erase_if(rings_, [](const auto &ring) {
+                        return ring->orphaned.load(std::memory_order_acquire) &&
+                               ring->head.load(std::memory_order_relaxed) == ring->tail.load(std::memory_order_acquire);
+                    });
+                }
+
+                if (!batch_.empty()) {
+                    std::fwrite(batch_.data(), 1, batch_.size(), stdout);
+                    std::fflush(stdout);
+                }
+                if (count) {
+                    written_.fetch_add(count, std::memory_order_release);
+                    written_.notify_all();
+                }
+                return !batch_.empty();
+            }
+
+            /// @brief Record reporting dropped records
+            [[nodiscard]] static auto warning(std::uint64_t lost) -> Record {
+                Record record;
+                fill(record, Level::Warn, "{} log records dropped", fmt::make_format_args(lost));
+                return record;
+            }
+
+            /// @brief Writer loop, sleeps until records are queued
+            auto run() -> void {
+                for (;;) {
+                    const auto seen = queued_.load(std::memory_order_acquire);
+                    if (drain()) continue;
+                    if (stopping_.load(std::memory_order_acquire)) break;
+                    queued_.wait(seen, std::memory_order_acquire);
+                }
+                drain();
+            }
+
+            std::mutex mutex_;                       ///< Guards rings_ and synchronous writes
+            std::vector<std::shared_ptr<Ring>> rings_;///< Ring of every logging thread
+            std::string batch_;                      ///< Styled records of one drain, reused between drains
+            std::atomic<std::uint64_t> queued_{0};   ///< Records queued, the writer waits on it
+            std::atomic<std::uint64_t> written_{0};  ///< Records written, flush waits on it
+            std::atomic<std::uint64_t> dropped_{0};  ///< Records dropped
+            std::atomic<bool> stopping_{false};      ///< Set when the writer should finish
+            std::atomic<bool> stopped_{false};       ///< Set once the writer has finished
+            std::thread writer_;                     ///< Background writer, started last
+        };
+
+        /// @brief Get the process-wide Logger, started on first use and stopped at exit
+        [[nodiscard]] inline auto logger() -> Logger & {
+            // Never destroyed so threads logging during static destruction still have a Logger,
+            // the writer is stopped at exit instead and later records are written synchronously
+            static auto *instance = [] {
+                auto *logger = new Logger();
+                std::atexit([] { detail::logger().stop(); });
+                return logger;
+            }();
+            return *instance;
+        }
+
+    }// namespace detail
+
+    /// @brief Wait until every record logged before the call has been written to stdout
+    inline auto flush() -> void { detail::logger().flush(); }
+
+    /// @brief Get how many records have been written and dropped
+    [[nodiscard]] inline auto stats() -> Stats { return detail::logger().stats(); }
+
+}// namespace harbour::log
@@ -0,0 +1,79 @@
+///  _  _             _
+/// | || | __ _  _ _ | |__  ___  _  _  _ _   A Web Server Framework For Modern C++
+/// | __ |/ _` || '_|| '_ \/ _ \| || || '_|  https://github.com/griefzz/harbour
+/// |_||_|\__,_||_|  |_.__/\___/ \_,_||_|    License: MIT
+///
+/// @file memory.hpp
+/// @brief Contains harbours per-connection arena and allocator-aware string maps
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include <ankerl/unordered_dense.h>
+
+/// @brief Number of bytes each connection's arena holds before spilling onto the heap
+#ifndef HARBOUR_ARENA_SIZE
+    #define HARBOUR_ARENA_SIZE 4096
+#endif
+
+namespace harbour::memory {
+
+    /// @brief Allocator for Request and Response data, allocating from a connection's Arena when given one
+    using Allocator = std::pmr::polymorphic_allocator<>;
+
+    /// @brief Transparent string hash so owned string maps can be searched with a string_view
+    struct StringHash {
+        using is_transparent = void;///< Enable heterogeneous lookup
+        using is_avalanching = void;///< Mark the hash as high quality for unordered_dense
+
+        [[nodiscard]] auto operator()(std::string_view s) const noexcept -> std::uint64_t {
+            return ankerl::unordered_dense::hash<std::string_view>{}(s);
+        }
+    };
+
+    /// @brief Transparent string equality so strings with different allocators compare equal
+    struct StringEqual {
+        using is_transparent = void;///< Enable heterogeneous lookup
+
+        [[nodiscard]] auto operator()(std::string_view a, std::string_view b) const noexcept -> bool {
+            return a == b;
+        }
+    };
+
+    /// @brief Map of owned strings allocated through an Allocator, searchable with any string type
+    using StringMap = ankerl::unordered_dense::map<std::pmr::string, std::pmr::string, StringHash, StringEqual,
+                                                   std::pmr::polymorphic_allocator<std::pair<std::pmr::string, std::pmr::string>>>;
+
+    /// @class Arena
+    /// @brief Monotonic memory for a single connection.
+    ///        Allocations are carved out of an inline buffer and are only freed all at once by reset,
+    ///        which the server calls between keep-alive requests once the Request and Response are gone.
+    ///        Requests needing more than HARBOUR_ARENA_SIZE bytes spill onto the heap until the next reset.
+    class Arena {
+    public:
+        Arena() = default;
+
+        Arena(const Arena &)            = delete;
+        Arena &operator=(const Arena &) = delete;
+
+        /// @brief Get the memory resource of the Arena
+        [[nodiscard]] auto resource() noexcept -> std::pmr::memory_resource * { return &resource_; }
+
+        /// @brief Get an Allocator for the Arena
+        [[nodiscard]] auto allocator() noexcept -> Allocator { return Allocator(&resource_); }
+
+        /// @brief Free everything allocated from the Arena
+        auto reset() noexcept -> void { resource_.release(); }
+
+    private:
+        alignas(std::max_align_t) std::byte buffer_[HARBOUR_ARENA_SIZE];                                     ///< Inline storage
+        std::pmr::monotonic_buffer_resource resource_{buffer_, sizeof(buffer_), std::pmr::new_delete_resource()};///< Resource over buffer_
+    };
+
+}// namespace harbour::memory
@@ -0,0 +1,412 @@
+///  _  _             _
+/// | || | __ _  _ _ | |__  ___  _  _  _ _   A Web Server Framework For Modern C++
+/// | __ |/ _` || '_|| '_ \/ _ \| || || '_|  https://github.com/griefzz/harbour
+/// |_||_|\__,_||_|  |_.__/\___/ \_,_||_|    License: MIT
+///
+/// @file cache.hpp
+/// @brief Contains the implementation of harbours sharded in-memory Response cache
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <charconv>
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <asio/awaitable.hpp>
+#include <ankerl/unordered_dense.h>
+
+#include <harbour/ship.hpp>
+#include <harbour/memory.hpp>
+#include <harbour/request/request.hpp>
+#include <harbour/response/response.hpp>
+#include <harbour/http/fields.hpp>
+
+#include "etag.hpp"
+
+namespace harbour::middleware {
+
+    namespace cache {
+
+        /// @brief Clock used for cache freshness
+        using Clock = std::chrono::steady_clock;
+
+        /// @brief Settings for a cache Store
+        struct Settings {
+            std::size_t capacity{64 * 1024 * 1024};///< Byte budget shared by every shard
+            std::size_t shards{16};                ///< Number of independently locked shards
+        };
+
+        /// @brief Cached Response, or the Vary header names of a Response when response is empty
+        struct Entry {
+            std::shared_ptr<const std::string> response;    ///< Pre-serialized head and body
+            std::shared_ptr<const std::string> not_modified;///< Pre-serialized 304 Not Modified, set if the Response has an ETag
+            std::optional<etag::Validators> validators;     ///< ETag and Last-Modified of the Response
+            http::Status status{http::Status::OK};          ///< Status of the cached Response
+            std::vector<std::string> vary;                  ///< Request headers the Response varies on
+            Clock::time_point expires;                      ///< Time the entry stops being fresh
+
+            /// @brief Check if the entry is still fresh
+            /// @param now Current time
+            [[nodiscard]] auto fresh(Clock::time_point now) const noexcept -> bool { return now < expires; }
+        };
+
+        /// @class Store
+        /// @brief Sharded map of cache entries with CLOCK eviction and a byte budget.
+        ///        Lookups take a shared lock on a single shard and only mark the entry as referenced,
+        ///        so readers never block each other. Inserts take an exclusive lock on their shard and
+        ///        sweep the clock hand over unreferenced entries until the shard fits its share of the budget.
+        class Store {
+        public:
+            /// @brief Construct a Store
+            /// @param settings Byte budget and shard count
+            explicit Store(const Settings &settings = {})
+                : shard_count_(settings.shards ? settings.shards : 1),
+                  shard_budget_(settings.capacity / shard_count_),
+                  shards_(std::make_unique<Shard[]>(shard_count_)) {}
+
+            /// @brief Find a fresh entry
+            /// @param key Key of the entry
+            /// @param now Current time
+            /// @return std::shared_ptr<const Entry> The entry, empty if missing or stale
+            [[nodiscard]] auto get(std::string_view key, Clock::time_point now = Clock::now()) const -> std::shared_ptr<const Entry> {
+                const auto &shard = shard_for(key);
+                std::shared_lock lock(shard.mutex);
+                auto it = shard.index.find(key);
+                if (it == shard.index.end()) return {};
+
+                const auto &slot = *shard.slots[it->second];
+                if (!slot.entry->fresh(now)) return {};
+                slot.referenced.store(true, std::memory_order_relaxed);
+                return slot.entry;
+            }
+
+            /// @brief Insert or replace an entry, evicting entries until its shard fits the budget
+            /// @param key Key of the entry
+            /// @param entry Entry to store
+            /// @param now Current time, expired entries are evicted first
+            auto put(std::string_view key, Entry entry, Clock::time_point now = Clock::now()) -> void {
+                const auto bytes = sizeof(Slot) + sizeof(Entry) + key.size() * 2 + weight(entry);
+                if (bytes > shard_budget_) return;
+
+                auto &shard = shard_for(key);
+                std::unique_lock lock(shard.mutex);
+                if (auto it = shard.index.find(key); it != shard.index.end()) {
+                    auto &slot = *shard.slots[it->second];
+                    shard.bytes -= slot.bytes;
+                    slot.entry = std::make_shared<const Entry>(std::move(entry));
+                    slot.bytes = bytes;
+                    shard.bytes += bytes;
+                } else {
+                    auto slot   = std::make_unique<Slot>();
+                    slot->key   = std::string(key);
+                    slot->entry = std::make_shared<const Entry>(std::move(entry));
+                    slot->bytes = bytes;
+                    shard.index.emplace(slot->key, shard.slots.size());
+                    shard.slots.push_back(std::move(slot));
+                    shard.bytes += bytes;
+                }
+
+                evict(shard, now);
+            }
+
+            /// @brief Get the number of bytes held by the Store
+            [[nodiscard]] auto bytes() const -> std::size_t {
+                std::size_t n = 0;
+                for (std::size_t i = 0; i < shard_count_; i++) {
+                    std::shared_lock lock(shards_[i].mutex);
+                    n += shards_[i].bytes;
+                }
+                return n;
+            }
+
+            /// @brief Get the number of entries held by the Store
+            [[nodiscard]] auto size() const -> std::size_t {
+                std::size_t n = 0;
+                for (std::size_t i = 0; i < shard_count_; i++) {
+                    std::shared_lock lock(shards_[i].mutex);
+                    n += shards_[i].slots.size();
+                }
+                return n;
+            }
+
+        private:
+            /// @brief Stored entry and its clock state
+            struct Slot {
+                std::string key;                            ///< Key of the entry, the index views it
+                std::shared_ptr<const Entry> entry;         ///< Stored entry
+                std::size_t bytes{0};                       ///< Bytes charged to the shard for the entry
+                mutable std::atomic<bool> referenced{false};///< Set on lookup, cleared by the clock hand
+            };
+
+            /// @brief Key to slot index, keys view the key of their Slot
+            using Index = ankerl::unordered_dense::map<std::string_view, std::size_t, memory::StringHash, memory::StringEqual>;
+
+            /// @brief Independently locked part of the Store
+            struct Shard {
+                mutable std::shared_mutex mutex;         ///< Guards every member
+                Index index;                             ///< Key to slot index
+                std::vector<std::unique_ptr<Slot>> slots;///< Clock ring
+                std::size_t hand{0};                     ///< Clock hand
+                std::size_t bytes{0};                    ///< Bytes held
+            };
+
+            /// @brief Get the number of bytes an entry holds
+            [[nodiscard]] static auto weight(const Entry &entry) noexcept -> std::size_t {
+                auto n = entry.response ? entry.response->size() : 0;
+                if (entry.not_modified) n += entry.not_modified->size();
+                for (const auto &v: entry.vary) n += v.size();
+                return n;
+            }
+
+            /// @brief Get the shard a key belongs to
+            [[nodiscard]] auto shard_for(std::string_view key) const -> Shard & {
+                return shards_[memory::StringHash{}(key) % shard_count_];
+            }
+
+            /// @brief Remove a slot, moving the last slot into its place
+            /// @param shard Shard to remove from, must be locked exclusively
+            /// @param i Index of the slot
+            static auto evict_slot(Shard &shard, std::size_t i) -> void {
+                shard.bytes -= shard.slots[i]->bytes;
+                shard.index.erase(std::string_view(shard.slots[i]->key));
+                if (i + 1 != shard.slots.size()) {
+                    shard.slots[i]                                     = std::move(shard.slots.back());
+                    shard.index[std::string_view(shard.slots[i]->key)] = i;
+                }
+                shard.slots.pop_back();
+            }
+
+            /// @brief Sweep the clock hand until the shard fits its budget.
+            ///        Expired entries are evicted on sight, referenced entries get a second chance.
+            /// @param shard Shard to sweep, must be locked exclusively
+            /// @param now Current time
+            auto evict(Shard &shard, Clock::time_point now) const -> void {
+                while (shard.bytes > shard_budget_ && !shard.slots.empty()) {
+                    if (shard.hand >= shard.slots.size()) shard.hand = 0;
+                    auto &slot = *shard.slots[shard.hand];
+                    if (slot.entry->fresh(now) && slot.referenced.exchange(false, std::memory_order_relaxed))
+                        shard.hand++;
+                    else
+                        evict_slot(shard, shard.hand);
+                }
+            }
+
+            std::size_t shard_count_;        ///< Number of shards
+            std::size_t shard_budget_;       ///< Byte budget of each shard
+            std::unique_ptr<Shard[]> shards_;///< Shards
+        };
+
+        namespace detail {
+
+            namespace fields = http::fields;
+
+            /// @brief Get how long a Response may be cached from its Cache-Control header.
+            ///        s-maxage takes precedence over max-age, no-store, no-cache and private forbid caching.
+            /// @param resp Response to check
+            /// @return std::optional<std::chrono::seconds> Freshness lifetime, empty if the Response can't be cached
+            [[nodiscard]] inline auto freshness(const Response &resp) -> std::optional<std::chrono::seconds> {
+                const auto value = fields::find(resp.headers, "Cache-Control");
+                if (!value) return {};
+
+                bool forbidden = false;
+                std::optional<long long> max_age, s_maxage;
+                fields::for_each(*value, [&](std::string_view item) {
+                    const auto eq   = item.find('=');
+                    const auto name = fields::trim(item.substr(0, eq));
+                    if (fields::iequals(name, "no-store") || fields::iequals(name, "no-cache") || fields::iequals(name, "private")) {
+                        forbidden = true;
+                    } else if (eq != std::string_view::npos) {
+                        auto arg = fields::trim(item.substr(eq + 1));
+                        if (arg.size() >= 2 && arg.front() == '"' && arg.back() == '"') arg = arg.substr(1, arg.size() - 2);
+                        long long n = 0;
+                        if (std::from_chars(arg.data(), arg.data() + arg.size(), n).ec != std::errc{}) return;
+                        if (fields::iequals(name, "s-maxage"))
+                            s_maxage = n;
+                        else if (fields::iequals(name, "max-age"))
+                            max_age = n;
+                    }
+                });
+
+                const auto age = s_maxage ? s_maxage : max_age;
+                if (forbidden || !age || *age <= 0) return {};
+                return std::chrono::seconds(*age);
+            }
+
+            /// @brief Check if a Cache-Control header has any of the given directives
+            /// @param value Value of the Cache-Control header, empty if there is none
+            /// @param names Names of the directives
+            /// @return bool True if one of the directives is present
+            [[nodiscard]] inline auto has_directive(std::optional<std::string_view> value, std::initializer_list<std::string_view> names) -> bool {
+                bool found = false;
+                if (value)
+                    fields::for_each(*value, [&](std::string_view item) {
+                        const auto name = fields::trim(item.substr(0, item.find('=')));
+                        for (const auto n: names) found = found || fields::iequals(name, n);
+                    });
+                return found;
+            }
+
+            /// @brief Check if the Request allows its Response to be stored (RFC 9111 3.5 and 5.2.1.5).
+            ///        Requests marked no-store are never stored, Responses to Requests carrying an Authorization header
+            ///        are only stored if they are marked public, s-maxage or must-revalidate.
+            /// @param req Request the Response answers
+            /// @param resp Response to store
+            /// @return bool True if the Response may be stored
+            [[nodiscard]] inline auto storable(const Request &req, const Response &resp) -> bool {
+                if (has_directive(fields::find(req.headers, "Cache-Control"), {"no-store"})) return false;
+                if (!fields::find(req.headers, "Authorization")) return true;
+                return has_directive(fields::find(resp.headers, "Cache-Control"), {"public", "s-maxage", "must-revalidate"});
+            }
+
+            /// @brief Build the key of a Request from its method and target
+            [[nodiscard]] inline auto key(const Request &req) -> std::string {
+                std::string k(http::detail::to_string(req.method));
+                k += ' ';
+                k += req.url;
+                return k;
+            }
+
+            /// @brief Extend a Request key with the values of the headers a Response varies on
+            [[nodiscard]] inline auto vary_key(std::string k, const Request &req, const std::vector<std::string> &vary) -> std::string {
+                for (const auto &name: vary) {
+                    k += '\n';
+                    k += name;
+                    k += ':';
+                    k += fields::find(req.headers, name).value_or("");
+                }
+                return k;
+            }
+
+        }// namespace detail
+
+    }// namespace cache
+
+    /// @class Cache
+    /// @brief Ship caching the Responses of its Ships in memory.
+    ///        GET Responses with a Cache-Control max-age or s-maxage are stored pre-serialized, keyed on
+    ///        the method, path, query string and the Request headers named by the Response's Vary header.
+    ///        A cache hit sends the stored bytes without running the Ships or serializing a Response.
+    ///        Responses setting cookies, streamed from files or Streams, or marked no-store, no-cache or private are never stored.
+    ///        Neither are Responses to Requests marked no-store, or to Requests with an Authorization header unless
+    ///        the Response is marked public, s-maxage or must-revalidate.
+    ///        Responses carrying an ETag, for example from an inner ETag Ship, also answer conditional GETs from the cache.
+    ///        Copies of a Cache share the same Store.
+    class Cache {
+    public:
+        /// @brief Cache the Responses of Ships in a new Store
+        /// @param ship Ships to run on a cache miss
+        explicit Cache(detail::ShipConcept auto... ship) : Cache(cache::Settings{}, std::move(ship)...) {}
+
+        /// @brief Cache the Responses of Ships in a new Store
+        /// @param settings Byte budget and shard count of the Store
+        /// @param ship Ships to run on a cache miss
+        explicit Cache(const cache::Settings &settings, detail::ShipConcept auto... ship)
+            : Cache(std::make_shared<cache::Store>(settings), std::move(ship)...) {}
+
+        /// @brief Cache the Responses of Ships in an existing Store, sharing it with other Caches
+        /// @param store Store to cache Responses in
+        /// @param ship Ships to run on a cache miss
+        explicit Cache(std::shared_ptr<cache::Store> store, detail::ShipConcept auto... ship) : store(std::move(store)) {
+            (ships.emplace_back(detail::make_ship(ship)), ...);
+        }
+
+        /// @brief Send a cached Response, or run the Ships and cache their Response
+        /// @param req Request to handle
+        /// @param resp Response to handle, receives the cached or produced Response
+        /// @return detail::Handled True if the Response came from the cache or a Ship
+        auto operator()(const Request &req, Response &resp) -> asio::awaitable<detail::Handled> {
+            if (req.method != http::Method::GET) co_return co_await run(req, resp);
+
+            const auto now = cache::Clock::now();
+            auto key       = cache::detail::key(req);
+            if (auto entry = lookup(key, req, now)) {
+                if (entry->validators && etag::not_modified(req, *entry->validators)) {
+                    resp.status     = http::Status::NotModified;
+                    resp.serialized = entry->not_modified;
+                } else {
+                    resp.status     = entry->status;
+                    resp.serialized = entry->response;
+                }
+                co_return detail::Handled{true};
+            }
+
+            auto handled = co_await run(req, resp);
+            if (handled.value) store_response(std::move(key), req, resp, now);
+            co_return handled;
+        }
+
+        std::shared_ptr<cache::Store> store;///< Store shared by copies of the Cache
+        std::vector<detail::Ship> ships;    ///< Ships to run on a cache miss
+
+    private:
+        /// @brief Run the Ships until one of them produces a Response
+        auto run(const Request &req, Response &resp) const -> asio::awaitable<detail::Handled> {
+            for (const auto &ship: ships)
+                if (ship.is_async() ? co_await ship.async_call(req, resp) : ship(req, resp))
+                    co_return detail::Handled{true};
+            co_return detail::Handled{false};
+        }
+
+        /// @brief Find a fresh cached Response for a Request
+        auto lookup(const std::string &key, const Request &req, cache::Clock::time_point now) const -> std::shared_ptr<const cache::Entry> {
+            auto entry = store->get(key, now);
+            if (!entry || entry->response) return entry;
+
+            // The Response varies on Request headers, look it up by their values
+            entry = store->get(cache::detail::vary_key(key, req, entry->vary), now);
+            return entry && entry->response ? entry : nullptr;
+        }
+
+        /// @brief Store a Response if its headers allow it
+        auto store_response(std::string key, const Request &req, const Response &resp, cache::Clock::time_point now) -> void {
+            if (resp.serialized || resp.data.file() || resp.data.stream() || !resp.cookies.data.empty()) return;
+            if (resp.status == http::Status::NotModified || resp.status == http::Status::PartialContent) return;
+            if (!cache::detail::storable(req, resp)) return;
+
+            const auto age = cache::detail::freshness(resp);
+            if (!age) return;
+
+            std::vector<std::string> vary;
+            bool any = false;
+            if (const auto value = http::fields::find(resp.headers, "Vary"))
+                http::fields::for_each(*value, [&](std::string_view name) {
+                    any |= name == "*";
+                    vary.emplace_back(name);
+                });
+            if (any) return;
+
+            cache::Entry entry;
+            entry.response = std::make_shared<const std::string>(resp.string());
+            entry.status   = resp.status;
+            entry.expires  = now + *age;
+
+            // Clients revalidating with the ETag get a stored 304 instead of the body
+            if ((entry.validators = etag::from_headers(resp))) {
+                auto not_modified = resp;
+                etag::make_not_modified(not_modified);
+                entry.not_modified = std::make_shared<const std::string>(not_modified.string());
+            }
+
+            if (vary.empty()) {
+                store->put(key, std::move(entry), now);
+            } else {
+                // Remember which headers the Response varies on under the plain key
+                const auto full = cache::detail::vary_key(key, req, vary);
+                cache::Entry record;
+                record.vary    = std::move(vary);
+                record.expires = entry.expires;
+                store->put(key, std::move(record), now);
+                store->put(full, std::move(entry), now);
+            }
+        }
+    };
+
+}// namespace harbour::middleware
@@ -0,0 +1,173 @@
+///  _  _             _
+/// | || | __ _  _ _ | |__  ___  _  _  _ _   A Web Server Framework For Modern C++
+/// | __ |/ _` || '_|| '_ \/ _ \| || || '_|  https://github.com/griefzz/harbour
+/// |_||_|\__,_||_|  |_.__/\___/ \_,_||_|    License: MIT
+///
+/// @file etag.hpp
+/// @brief Contains the implementation of harbours ETag and conditional GET middleware
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include <asio/awaitable.hpp>
+#include <ankerl/unordered_dense.h>
+#include <fmt/format.h>
+
+#include <harbour/ship.hpp>
+#include <harbour/request/request.hpp>
+#include <harbour/response/response.hpp>
+#include <harbour/http/date.hpp>
+#include <harbour/http/fields.hpp>
+
+namespace harbour::middleware {
+
+    namespace etag {
+
+        /// @brief Validators of a Response compared against conditional Request headers
+        struct Validators {
+            std::string tag;                        ///< Entity tag including its quotes
+            std::optional<http::date::Time> modified;///< Last modification time, if known
+        };
+
+        /// @brief Compute a strong entity tag from a body with a fast non-cryptographic hash
+        /// @param body Body to hash
+        /// @return std::string Quoted entity tag
+        [[nodiscard]] inline auto hash(std::string_view body) -> std::string {
+            return fmt::format("\"{:016x}\"", ankerl::unordered_dense::hash<std::string_view>{}(body));
+        }
+
+        /// @brief Compute the validators of a File region from its modification time and size, without reading it
+        /// @param file File region to stat
+        /// @return std::optional<Validators> Validators of the file, empty if it can't be stat'd
+        [[nodiscard]] inline auto of(const response::File &file) -> std::optional<Validators> {
+            std::error_code ec;
+            const auto mtime = std::filesystem::last_write_time(file.path, ec);
+            if (ec) return {};
+
+#if defined(_MSC_VER)
+            const auto sys = std::chrono::clock_cast<std::chrono::system_clock>(mtime);
+#else
+            const auto sys = std::chrono::file_clock::to_sys(mtime);
+#endif
+            const auto modified = std::chrono::floor<std::chrono::seconds>(sys);
+            const auto ticks    = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(sys.time_since_epoch()).count());
+            return Validators{fmt::format("\"{:x}-{:x}-{:x}\"", ticks, file.offset, file.length), modified};
+        }
+
+        /// @brief Check if an If-None-Match header matches an entity tag, using the weak comparison
+        /// @param if_none_match Value of the If-None-Match header
+        /// @param tag Entity tag to compare with
+        /// @return bool True if any listed tag matches, or the header is "*"
+        [[nodiscard]] inline auto matches(std::string_view if_none_match, std::string_view tag) -> bool {
+            const auto opaque = [](std::string_view t) { return t.starts_with("W/") ? t.substr(2) : t; };
+            bool match        = false;
+            http::fields::for_each(if_none_match, [&](std::string_view item) {
+                match |= item == "*" || opaque(item) == opaque(tag);
+            });
+            return match;
+        }
+
+        /// @brief Check if a Request's conditional headers say the client already has the Response.
+        ///        If-None-Match takes precedence, If-Modified-Since is only used without it.
+        /// @param req Request to check
+        /// @param validators Validators of the Response
+        /// @return bool True if the Response can be answered with 304 Not Modified
+        [[nodiscard]] inline auto not_modified(const Request &req, const Validators &validators) -> bool {
+            if (const auto if_none_match = http::fields::find(req.headers, "If-None-Match"))
+                return matches(*if_none_match, validators.tag);
+
+            if (const auto if_modified_since = http::fields::find(req.headers, "If-Modified-Since"); if_modified_since && validators.modified)
+                if (const auto since = http::date::parse(*if_modified_since))
+                    return *validators.modified <= *since;
+
+            return false;
+        }
+
+        /// @brief Read the validators a Response already carries in its ETag and Last-Modified headers
+        /// @param resp Response to read
+        /// @return std::optional<Validators> Validators of the Response, empty if it has no ETag
+        [[nodiscard]] inline auto from_headers(const Response &resp) -> std::optional<Validators> {
+            const auto tag = http::fields::find(resp.headers, "ETag");
+            if (!tag) return {};
+
+            Validators v{std::string(*tag), {}};
+            if (const auto modified = http::fields::find(resp.headers, "Last-Modified"))
+                v.modified = http::date::parse(*modified);
+            return v;
+        }
+
+        /// @brief Turn a Response into a 304 Not Modified, keeping its headers but dropping its body
+        /// @param resp Response to change
+        inline auto make_not_modified(Response &resp) -> void {
+            resp.status = http::Status::NotModified;
+            resp.data   = std::nullopt;
+        }
+
+    }// namespace etag
+
+    /// @class ETag
+    /// @brief Ship adding entity tags to the Responses of its Ships and answering conditional GETs.
+    ///        In-memory bodies are tagged with a hash of their contents, File bodies with their modification time
+    ///        and size so the file is never read. Requests whose If-None-Match or If-Modified-Since show the client
+    ///        already has the Response are answered with a bodyless 304 Not Modified.
+    ///        Responses that already set an ETag keep it.
+    class ETag {
+    public:
+        /// @brief Tag the Responses of Ships
+        /// @param ship Ships to run
+        explicit ETag(detail::ShipConcept auto... ship) {
+            (ships.emplace_back(detail::make_ship(ship)), ...);
+        }
+
+        /// @brief Run the Ships then tag their Response
+        /// @param req Request to handle
+        /// @param resp Response to handle, receives the tagged Response or a 304 Not Modified
+        /// @return detail::Handled True if a Ship produced a Response
+        auto operator()(const Request &req, Response &resp) -> asio::awaitable<detail::Handled> {
+            bool handled = false;
+            for (const auto &ship: ships)
+                if (ship.is_async() ? co_await ship.async_call(req, resp) : ship(req, resp)) {
+                    handled = true;
+                    break;
+                }
+
+            tag(req, resp);
+            co_return detail::Handled{handled};
+        }
+
+        /// @brief Tag a Response and answer 304 Not Modified if the Request allows it
+        /// @param req Request the Response answers
+        /// @param resp Response to tag
+        static auto tag(const Request &req, Response &resp) -> void {
+            if ((req.method != http::Method::GET && req.method != http::Method::HEAD) ||
+                resp.status != http::Status::OK || resp.serialized || !resp.data || resp.data.stream())
+                return;
+
+            auto validators = etag::from_headers(resp);
+            if (!validators) {
+                if (const auto *file = resp.data.file())
+                    validators = etag::of(*file);
+                else
+                    validators = etag::Validators{etag::hash(resp.data.view()), {}};
+                if (!validators) return;
+
+                resp["ETag"] = validators->tag;
+                if (validators->modified && !http::fields::find(resp.headers, "Last-Modified"))
+                    resp["Last-Modified"] = http::date::format(*validators->modified);
+            }
+
+            if (etag::not_modified(req, *validators))
+                etag::make_not_modified(resp);
+        }
+
+        std::vector<detail::Ship> ships;///< Ships whose Responses are tagged
+    };
+
+}// namespace harbour::middleware
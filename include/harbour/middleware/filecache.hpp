@@ -0,0 +1,292 @@
+///  _  _             _
+/// | || | __ _  _ _ | |__  ___  _  _  _ _   A Web Server Framework For Modern C++
+/// | __ |/ _` || '_|| '_ \/ _ \| || || '_|  https://github.com/griefzz/harbour
+/// |_||_|\__,_||_|  |_.__/\___/ \_,_||_|    License: MIT
+///
+/// @file filecache.hpp
+/// @brief Contains the implementation of harbours in-memory file content and metadata cache
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <system_error>
+
+#include <ankerl/unordered_dense.h>
+
+#include <harbour/memory.hpp>
+#include <harbour/response/body.hpp>
+
+#include "etag.hpp"
+
+#if defined(__linux__)
+    #include <cerrno>
+    #include <fcntl.h>
+    #include <sys/inotify.h>
+    #include <unistd.h>
+#endif
+
+namespace harbour::middleware::files {
+
+    /// @brief Settings for a file Cache
+    struct Settings {
+        std::size_t capacity{32 * 1024 * 1024};///< Byte budget for cached file contents
+        std::size_t max_file_size{256 * 1024}; ///< Largest file whose contents are cached, larger files only cache metadata
+    };
+
+    /// @brief Cached metadata of a regular file, and its contents if the file is small
+    struct Entry {
+        response::Body::Shared content;///< Contents of the file, empty if the file is too large to cache
+        std::uint64_t size{0};         ///< Size of the file in bytes
+        etag::Validators validators;   ///< ETag and modification time of the file
+    };
+
+    /// @class Cache
+    /// @brief Cache of file metadata and small file contents with a byte budget.
+    ///        On Linux every directory holding a cached file is watched with inotify and pending events are
+    ///        drained before each lookup, so a hit costs no disk I/O and changed files are reloaded on their next use.
+    ///        Files in directories that couldn't be watched, and every file elsewhere, check their modification time on each hit instead.
+    ///        Files are read without holding the Cache's lock, which is only taken to look up and install entries.
+    ///        The contents of the least recently used files are dropped when the budget is exceeded, their metadata
+    ///        stays cached so later hits stream them from disk without touching the blocking Pool.
+    class Cache {
+    public:
+        /// @brief Construct a Cache
+        /// @param settings Byte budget and largest cached file
+        explicit Cache(const Settings &settings = {}) : settings_(settings) {
+#if defined(__linux__)
+            fd_ = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+#endif
+        }
+
+        Cache(const Cache &)            = delete;
+        Cache &operator=(const Cache &) = delete;
+
+        ~Cache() {
+#if defined(__linux__)
+            if (fd_ >= 0) ::close(fd_);
+#endif
+        }
+
+        /// @brief Get the cached entry of a file without loading it
+        /// @param path Path of the file
+        /// @return std::shared_ptr<const Entry> Entry of the file, empty if it isn't cached or has changed
+        [[nodiscard]] auto find(const std::filesystem::path &path) -> std::shared_ptr<const Entry> {
+            const auto key = path.lexically_normal().string();
+
+            std::shared_ptr<const Entry> entry;
+            bool watched = false;
+            {
+                std::lock_guard lock(mutex_);
+                drain();
+                auto it = entries_.find(key);
+                if (it == entries_.end()) return {};
+                if (it->second.entry->content) recency_.splice(recency_.begin(), recency_, it->second.recency);
+                entry   = it->second.entry;
+                watched = it->second.watched;
+            }
+            return watched || fresh(path, *entry) ? entry : nullptr;
+        }
+
+        /// @brief Get the cached entry of a file, loading it on a miss.
+        ///        A miss reads the file on the calling thread, so call it from a blocking Pool.
+        /// @param path Path of the file
+        /// @return std::shared_ptr<const Entry> Entry of the file, empty if it isn't a readable regular file
+        [[nodiscard]] auto get(const std::filesystem::path &path) -> std::shared_ptr<const Entry> {
+            if (auto entry = find(path)) return entry;
+
+            const auto normal = path.lexically_normal();
+            const auto key    = normal.string();
+
+            // Watch before loading so changes made while the file is read aren't missed
+            bool watched = false;
+            std::uint64_t changes = 0;
+            {
+                std::lock_guard lock(mutex_);
+                watched = watch(normal.parent_path());
+                changes = changes_;
+            }
+
+            auto entry = load(path);
+
+            std::lock_guard lock(mutex_);
+            drain();
+            if (!entry) {
+                erase(key);
+                return {};
+            }
+
+            // A change seen while the file was read may have come after the read, so don't keep what was read
+            if (changes != changes_) return entry;
+
+            erase(key);
+            auto &slot = entries_[key] = Slot{entry, {}, watched};
+            if (entry->content) {
+                bytes_ += entry->content->size();
+                slot.recency = recency_.insert(recency_.begin(), key);
+            }
+            evict();
+            return entry;
+        }
+
+        /// @brief Get the number of content bytes held by the Cache
+        [[nodiscard]] auto bytes() const -> std::size_t {
+            std::lock_guard lock(mutex_);
+            return bytes_;
+        }
+
+    private:
+        /// @brief Keys of entries holding contents, most recently used first
+        using Recency = std::list<std::string>;
+
+        /// @brief Cached entry and its place in the recency list
+        struct Slot {
+            std::shared_ptr<const Entry> entry;///< Cached entry
+            Recency::iterator recency;         ///< Position in recency_, only valid if the entry holds contents
+            bool watched{false};               ///< Whether inotify reports changes to the file
+        };
+
+        /// @brief Read the metadata of a file and its contents if it's small enough
+        [[nodiscard]] auto load(const std::filesystem::path &path) const -> std::shared_ptr<const Entry> {
+            std::error_code ec;
+            if (!std::filesystem::is_regular_file(path, ec)) return {};
+            const auto size = std::filesystem::file_size(path, ec);
+            if (ec) return {};
+
+            auto validators = etag::of(response::File{path, 0, size});
+            if (!validators) return {};
+
+            auto entry        = std::make_shared<Entry>();
+            entry->size       = size;
+            entry->validators = std::move(*validators);
+            if (size <= settings_.max_file_size && size <= settings_.capacity) {
+                std::string content(static_cast<std::size_t>(size), '\0');
+                std::ifstream in(path, std::ios::binary);
+                if (!in.read(content.data(), static_cast<std::streamsize>(content.size()))) return {};
+                entry->content = std::make_shared<const std::string>(std::move(content));
+            }
+            return entry;
+        }
+
+        /// @brief Check that a cached entry of an unwatched file still describes the file
+        [[nodiscard]] static auto fresh(const std::filesystem::path &path, const Entry &entry) -> bool {
+            const auto current = etag::of(response::File{path, 0, entry.size});
+            return current && current->tag == entry.validators.tag;
+        }
+
+        /// @brief Release the contents held by a slot
+        auto release(const Slot &slot) -> void {
+            if (!slot.entry->content) return;
+            bytes_ -= slot.entry->content->size();
+            recency_.erase(slot.recency);
+        }
+
+        /// @brief Remove the entry of a key
+        auto erase(const std::string &key) -> void {
+            auto it = entries_.find(key);
+            if (it == entries_.end()) return;
+            release(it->second);
+            entries_.erase(it);
+        }
+
+        /// @brief Drop the contents of the least recently used files until the Cache fits its budget, keeping their metadata
+        auto evict() -> void {
+            while (bytes_ > settings_.capacity && !recency_.empty()) {
+                auto &slot = entries_.find(recency_.back())->second;
+                release(slot);
+
+                // Readers may still hold the old entry, so replace it rather than modify it
+                auto metadata     = std::make_shared<Entry>(*slot.entry);
+                metadata->content = nullptr;
+                slot.entry        = std::move(metadata);
+            }
+        }
+
+        /// @brief Watch a directory for changes to the files in it
+        /// @param dir Normalized directory, empty for the working directory
+        /// @return bool True if the directory is watched, false if its files must check their modification time
+        auto watch([[maybe_unused]] const std::filesystem::path &dir) -> bool {
+#if defined(__linux__)
+            if (fd_ < 0) return false;
+            constexpr auto mask = IN_MODIFY | IN_CLOSE_WRITE | IN_ATTRIB | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF;
+            const auto wd = ::inotify_add_watch(fd_, dir.empty() ? "." : dir.c_str(), mask);
+            if (wd < 0) return false;
+            watches_[wd] = dir;
+            return true;
+#else
+            return false;
+#endif
+        }
+
+        /// @brief Apply pending inotify events, removing the entries of changed files
+        auto drain() -> void {
+#if defined(__linux__)
+            if (fd_ < 0) return;
+            alignas(inotify_event) char buffer[4096];
+            for (;;) {
+                const auto n = ::read(fd_, buffer, sizeof(buffer));
+                if (n <= 0) break;
+                for (auto *p = buffer; p < buffer + n;) {
+                    const auto *event = reinterpret_cast<const inotify_event *>(p);
+                    p += sizeof(inotify_event) + event->len;
+                    changes_++;
+
+                    if (event->mask & IN_Q_OVERFLOW) {
+                        entries_.clear();
+                        recency_.clear();
+                        bytes_ = 0;
+                        continue;
+                    }
+
+                    auto it = watches_.find(event->wd);
+                    if (it == watches_.end()) continue;
+
+                    if (event->mask & IN_IGNORED) {
+                        // The directory itself is gone, forget every file in it
+                        erase_prefix(it->second);
+                        watches_.erase(it);
+                    } else if (event->len) {
+                        const auto path = (it->second / event->name).string();
+                        if (event->mask & IN_ISDIR)
+                            erase_prefix(path);
+                        else
+                            erase(path);
+                    }
+                }
+            }
+#endif
+        }
+
+        /// @brief Remove the entries of every file under a directory
+        auto erase_prefix(const std::filesystem::path &dir) -> void {
+            const auto prefix = (dir / "").string();
+            for (auto it = entries_.begin(); it != entries_.end();) {
+                if (it->first.starts_with(prefix)) {
+                    release(it->second);
+                    it = entries_.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        }
+
+        using Entries = ankerl::unordered_dense::map<std::string, Slot, memory::StringHash, memory::StringEqual>;
+
+        Settings settings_;       ///< Byte budget and largest cached file
+        mutable std::mutex mutex_;///< Guards every member below
+        Entries entries_;         ///< Path to cached entry
+        Recency recency_;         ///< Keys of entries holding contents, least recently used last
+        std::size_t bytes_{0};    ///< Content bytes held
+        std::uint64_t changes_{0};///< Number of inotify events applied
+#if defined(__linux__)
+        int fd_{-1};                                                      ///< inotify descriptor
+        ankerl::unordered_dense::map<int, std::filesystem::path> watches_;///< Watch descriptor to watched directory
+#endif
+    };
+
+}// namespace harbour::middleware::files
@@ -8,17 +8,25 @@
 #pragma once
 
 #include <filesystem>
+#include <memory>
 #include <optional>
 #include <string_view>
-#include <ranges>
+#include <system_error>
 #include <vector>
 #include <utility>
 
+#include <fmt/format.h>
+
 #include <asio/awaitable.hpp>
 
 #include "../request/request.hpp"
 #include "../response/response.hpp"
-#include "../template.hpp"
+#include "../http/date.hpp"
+#include "../http/fields.hpp"
+#include "../http/mime.hpp"
+#include "../http/range.hpp"
+#include "../offload.hpp"
+#include "filecache.hpp"
 
 namespace harbour::middleware {
 
@@ -27,63 +35,19 @@ namespace harbour::middleware {
         explicit FileServer() = default;
         explicit FileServer(const std::string &working_directory) : working_directory(working_directory) {}
 
-        /// @brief Accepted MIME Types
-        using MimeTypes = std::vector<std::pair<std::vector<std::string_view>, std::string_view>>;
-        static auto AcceptedMimeTypes() -> const MimeTypes & {
-            static const MimeTypes mimes = {{{".txt", ".text", ".conf", ".log", ".ini"}, "text/plain; charset=utf-8"},
-                                            {{".html", ".htm"}, "text/html; charset=utf-8"},
-                                            {{".pdf"}, "application/pdf"},
-                                            {{".jpg", ".jpeg"}, "image/jpeg"},
-                                            {{".png"}, "image/png"},
-                                            {{".gif"}, "image/gif"},
-                                            {{".mp3"}, "audio/mpeg"},
-                                            {{".mp4"}, "video/mp4"},
-                                            {{".json"}, "application/json"},
-                                            {{".xml"}, "application/xml"},
-                                            {{".zip"}, "application/zip"},
-                                            {{".css"}, "text/css"},
-                                            {{".doc", ".docx"}, "application/msword"},
-                                            {{".xls", ".xlsx"}, "application/vnd.ms-excel"},
-                                            {{".ppt", ".pptx"}, "application/vnd.ms-powerpoint"},
-                                            {{".wav"}, "audio/wav"},
-                                            {{".avi"}, "video/x-msvideo"},
-                                            {{".bmp"}, "image/bmp"},
-                                            {{".csv"}, "text/csv"},
-                                            {{".js"}, "application/javascript"},
-                                            {{".ico"}, "image/x-icon"},
-                                            {{".svg", ".svgz"}, "image/svg+xml"},
-                                            {{".c", ".cpp", ".h", ".hpp"}, "text/html; charset=utf-8"},
-                                            {{".tar"}, "application/x-tar"},
-                                            {{".7z"}, "application/x-7z-compressed"},
-                                            {{".rar"}, "application/x-rar-compressed"},
-                                            {{".rtf"}, "application/rtf"},
-                                            {{".ogg"}, "audio/ogg"},
-                                            {{".ogv"}, "video/ogg"},
-                                            {{".webm"}, "video/webm"},
-                                            {{".flv"}, "video/x-flv"},
-                                            {{".mkv"}, "video/x-matroska"},
-                                            {{".eot"}, "application/vnd.ms-fontobject"},
-                                            {{".ttf"}, "font/ttf"},
-                                            {{".woff"}, "font/woff"},
-                                            {{".woff2"}, "font/woff2"},
-                                            {{".otf"}, "font/otf"},
-                                            {{".md"}, "text/markdown"}};
-
-            return mimes;
+        /// @brief Serve files from a directory with a file Cache of a custom size
+        /// @param working_directory Directory to serve files from
+        /// @param settings Byte budget and largest cached file
+        explicit FileServer(const std::string &working_directory, const files::Settings &settings)
+            : working_directory(working_directory), cache(std::make_shared<files::Cache>(settings)) {}
+
+        /// @brief Get the MIME type of a file extension
+        /// @param ext Extension of the file, for example ".html"
+        /// @return std::string_view MIME type of the extension, application/octet-stream if it is unknown
+        static constexpr auto get_mime_type(const std::string_view ext) noexcept -> std::string_view {
+            return http::mime::get(ext);
         }
 
-        auto get_mime_type(const std::string_view ext) const -> std::string_view {
-            for (const auto &mimes: AcceptedMimeTypes()) {
-                const auto &extensions = mimes.first;
-                if (std::ranges::find(extensions, ext) != extensions.end()) {
-                    return mimes.second;
-                }
-            }
-
-            log::warn("Invalid mime type for: {}", ext);
-            return "text/plain";
-        };
-
         /// @brief Serve a file to the user if it exists, otherwise return nothing
         /// @param req Request to use for parsing out the file path
         /// @return Response containing file data on success, nothing on an error
@@ -102,12 +66,24 @@ namespace harbour::middleware {
             if (path.string().ends_with("/"))
                 path = path / "index.html";
 
-            if (std::filesystem::exists(path)) {
-                if (auto file = co_await tmpl::load_file_async(path.string(), asio::use_awaitable)) {
-                    resp.data            = *file;
-                    resp["Content-Type"] = get_mime_type(path.extension().string());
-                    co_return std::nullopt;
-                }
+            // Small files are sent from the shared cached contents, larger files are streamed from disk.
+            // Misses read the file on the blocking Pool so the connection's thread never waits on the disk
+            auto entry = cache->find(path);
+            if (!entry) entry = co_await offload([&] { return cache->get(path); });
+            if (entry) {
+                if (entry->content)
+                    resp.data = entry->content;
+                else
+                    resp.data = response::File{path, 0, entry->size};
+                const auto mime       = get_mime_type(path.extension().string());
+                resp["Content-Type"]  = mime;
+                resp["ETag"]          = entry->validators.tag;
+                resp["Accept-Ranges"] = "bytes";
+                if (entry->validators.modified)
+                    resp["Last-Modified"] = http::date::format(*entry->validators.modified);
+                if (req.method == http::Method::GET)
+                    serve_ranges(req, resp, path, *entry, mime);
+                co_return std::nullopt;
             }
 
 
@@ -116,7 +92,80 @@ namespace harbour::middleware {
         }
 
     private:
-        std::filesystem::path working_directory{std::filesystem::current_path()};
+        /// @brief Check an If-Range header, ranges are only sent if the client's copy is still current
+        /// @param if_range Value of the If-Range header, an entity tag or an HTTP date
+        /// @param validators Validators of the file
+        /// @return bool True if the ranges may be sent
+        static auto if_range_matches(std::string_view if_range, const etag::Validators &validators) -> bool {
+            if_range = http::fields::trim(if_range);
+            if (if_range.starts_with('"')) return if_range == validators.tag;
+            if (if_range.starts_with("W/")) return false;
+
+            const auto date = http::date::parse(if_range);
+            return date && validators.modified && *date == *validators.modified;
+        }
+
+        /// @brief Answer a Range Request with the requested slices of a file.
+        ///        A single range is sent as a slice of the cached contents or a File region,
+        ///        multiple ranges are sent as multipart/byteranges whose parts of uncached files are still sent from disk.
+        ///        Requests without a usable Range header keep the full Response.
+        /// @param req Request containing the Range header
+        /// @param resp Response holding the full file
+        /// @param path Path of the file
+        /// @param entry Cached entry of the file
+        /// @param mime Content-Type of the file
+        static auto serve_ranges(const Request &req, Response &resp, const std::filesystem::path &path,
+                                 const files::Entry &entry, std::string_view mime) -> void {
+            const auto header = http::fields::find(req.headers, "Range");
+            if (!header) return;
+            if (const auto if_range = http::fields::find(req.headers, "If-Range"); if_range && !if_range_matches(*if_range, entry.validators))
+                return;
+
+            std::vector<http::range::Range> ranges;
+            switch (http::range::parse(*header, entry.size, ranges)) {
+                case http::range::Status::Ignore:
+                    return;
+                case http::range::Status::Unsatisfiable:
+                    resp.status           = http::Status::RangeNotSatisfiable;
+                    resp.data             = std::nullopt;
+                    resp["Content-Range"] = fmt::format("bytes */{}", entry.size);
+                    return;
+                case http::range::Status::Satisfiable:
+                    break;
+            }
+
+            resp.status = http::Status::PartialContent;
+            if (ranges.size() == 1) {
+                // Slice the shared contents if they're cached, otherwise send the region straight from the file
+                const auto &r = ranges.front();
+                if (entry.content)
+                    resp.data = response::Body(entry.content, static_cast<std::size_t>(r.offset), static_cast<std::size_t>(r.length));
+                else
+                    resp.data = response::File{path, r.offset, r.length};
+                resp["Content-Range"] = fmt::format("bytes {}-{}/{}", r.offset, r.last(), entry.size);
+                return;
+            }
+
+            // The boundary only has to be absent from the parts, derive it from the file's entity tag
+            const auto boundary = etag::hash(entry.validators.tag).substr(1, 16);
+            response::Body::Parts parts;
+            for (const auto &r: ranges) {
+                parts.emplace_back(fmt::format("--{}\r\nContent-Type: {}\r\nContent-Range: bytes {}-{}/{}\r\n\r\n",
+                                               boundary, mime, r.offset, r.last(), entry.size));
+                if (entry.content)
+                    parts.emplace_back(std::string(std::string_view(*entry.content).substr(r.offset, r.length)));
+                else
+                    parts.emplace_back(response::File{path, r.offset, r.length});
+                parts.emplace_back(std::string("\r\n"));
+            }
+            parts.back() = fmt::format("\r\n--{}--\r\n", boundary);
+
+            resp.data            = std::move(parts);
+            resp["Content-Type"] = fmt::format("multipart/byteranges; boundary={}", boundary);
+        }
+
+        std::filesystem::path working_directory{std::filesystem::current_path()};///< Directory to serve files from
+        std::shared_ptr<files::Cache> cache{std::make_shared<files::Cache>()};  ///< Cached file contents and metadata, shared by copies
     };
 
 }// namespace harbour::middleware
\ No newline at end of file
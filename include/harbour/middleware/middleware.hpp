@@ -8,7 +8,6 @@
 #pragma once
 
 #include <vector>
-#include <optional>
 
 #include <asio/awaitable.hpp>
 
@@ -19,6 +18,9 @@
 #include "files.hpp"
 #include "verbose.hpp"
 #include "basicauth.hpp"
+#include "cache.hpp"
+#include "etag.hpp"
+#include "pipeline.hpp"
 
 namespace harbour {
 
@@ -31,26 +33,22 @@ namespace harbour {
             (ships.emplace_back(detail::make_ship(ship)), ...);
         }
 
-        /// @brief Process the middleware chain
+        /// @brief Process the middleware chain.
+        ///        The middleware runs once, then the Ships run in order.
         /// @param req Request used in the chain
-        /// @param resp Response used in the chain
-        /// @return Response for middleware chain if valid, empty Response type otherwise
-        auto operator()(const Request &req, Response &resp) -> asio::awaitable<std::optional<Response>> {
-            for (auto &&ship: ships) {
-                // Exit on the first instance of a valid Response from the middleware
-                if (auto v = co_await detail::ShipHandler(req, resp, middleware)) {
-                    resp = *v;
+        /// @param resp Response used in the chain, receives the Response of the chain
+        /// @return detail::Handled Always handled, the chain ends the Ships docked after it
+        auto operator()(const Request &req, Response &resp) -> asio::awaitable<detail::Handled> {
+            // Exit on a valid Response from the middleware
+            if (middleware.is_async() ? co_await middleware.async_call(req, resp) : middleware(req, resp))
+                co_return detail::Handled{true};
+
+            // Exit on the first instance of a valid Response from our Ships
+            for (const auto &ship: ships)
+                if (ship.is_async() ? co_await ship.async_call(req, resp) : ship(req, resp))
                     break;
-                }
 
-                // Exit on the first instance of a valid Response from our Ships
-                if (auto v = co_await detail::ShipHandler(req, resp, ship)) {
-                    resp = *v;
-                    break;
-                }
-            }
-
-            co_return resp;
+            co_return detail::Handled{true};
         }
 
         detail::Ship middleware;        ///< Middleware Ship to use
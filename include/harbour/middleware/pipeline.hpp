@@ -0,0 +1,112 @@
+///  _  _             _
+/// | || | __ _  _ _ | |__  ___  _  _  _ _   A Web Server Framework For Modern C++
+/// | __ |/ _` || '_|| '_ \/ _ \| || || '_|  https://github.com/griefzz/harbour
+/// |_||_|\__,_||_|  |_.__/\___/ \_,_||_|    License: MIT
+///
+/// @file pipeline.hpp
+/// @brief Contains the implementation of harbours compile-time Ship pipelines
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include <asio/awaitable.hpp>
+
+#include <harbour/ship.hpp>
+#include <harbour/request/request.hpp>
+#include <harbour/response/response.hpp>
+
+namespace harbour {
+
+    /// @class Pipeline
+    /// @brief Ships composed at compile-time into a single Ship.
+    ///        Ships run in order until one of them produces a Response.
+    ///        Runs of synchronous Ships are folded into one expression the compiler can inline,
+    ///        each awaitable Ship is awaited directly from a single coroutine per awaitable Ship.
+    ///        A Pipeline without awaitable Ships never creates a coroutine frame.
+    /// @tparam Ships Types of the composed Ships.
+    template<typename... Ships>
+        requires((!detail::is_ship<Ships> && detail::ShipConcept<Ships>) && ...)
+    class Pipeline {
+        /// @brief Number of composed Ships
+        static constexpr std::size_t Size = sizeof...(Ships);
+
+        /// @brief Which of the composed Ships have to be awaited
+        static constexpr std::array<bool, Size> awaitables{detail::is_awaitable<detail::ship_result_t<Ships>>::value...};
+
+        /// @brief Find the first awaitable Ship at or after an index
+        /// @param i Index to start searching from
+        /// @return std::size_t Index of the awaitable Ship, Size if there is none
+        static constexpr auto next_async(std::size_t i) -> std::size_t {
+            while (i < Size && !awaitables[i]) i++;
+            return i;
+        }
+
+    public:
+        /// @brief True if the Pipeline has to be awaited
+        static constexpr bool is_async = next_async(0) != Size;
+
+        /// @brief Compose Ships into a Pipeline
+        /// @param ships Ships to run in order
+        explicit Pipeline(Ships... ships) : ships_(std::move(ships)...) {}
+
+        /// @brief Run the Pipeline
+        /// @param req Request to handle
+        /// @param resp Response to handle, receives the Response produced by the Pipeline
+        /// @return detail::Handled, or awaitable<detail::Handled> if any Ship is awaitable
+        auto operator()(const Request &req, Response &resp) { return run<0>(req, resp); }
+
+    private:
+        /// @brief Run the Pipeline starting at a Ship
+        /// @tparam I Index of the first Ship to run
+        template<std::size_t I>
+        auto run(const Request &req, Response &resp) {
+            constexpr auto J = next_async(I);
+            if constexpr (J == Size)
+                return detail::Handled{run_sync<I>(req, resp, std::make_index_sequence<J - I>{})};
+            else
+                return run_async<I, J>(req, resp);
+        }
+
+        /// @brief Run a span of synchronous Ships, stopping at the first Response
+        /// @tparam I Index of the first Ship in the span
+        /// @return bool True if a Ship produced a Response
+        template<std::size_t I, std::size_t... K>
+        auto run_sync(const Request &req, Response &resp, std::index_sequence<K...>) -> bool {
+            return (detail::call_ship(std::get<I + K>(ships_), req, resp) || ...);
+        }
+
+        /// @brief Run the synchronous Ships before an awaitable Ship, the awaitable Ship and then the rest of the Pipeline
+        /// @tparam I Index of the first Ship to run
+        /// @tparam J Index of the awaitable Ship
+        template<std::size_t I, std::size_t J>
+        auto run_async(const Request &req, Response &resp) -> asio::awaitable<detail::Handled> {
+            if (run_sync<I>(req, resp, std::make_index_sequence<J - I>{}))
+                co_return detail::Handled{true};
+
+            auto &ship = std::get<J>(ships_);
+            if constexpr (std::is_same_v<detail::ship_result_t<decltype(ship)>, asio::awaitable<void>>)
+                co_await detail::invoke_ship(ship, req, resp);
+            else if (detail::store_result(co_await detail::invoke_ship(ship, req, resp), resp))
+                co_return detail::Handled{true};
+
+            if constexpr (next_async(J + 1) == Size)
+                co_return run<J + 1>(req, resp);
+            else
+                co_return co_await run<J + 1>(req, resp);
+        }
+
+        std::tuple<Ships...> ships_;///< Ships to run in order
+    };
+
+    /// @brief Compose Ships into a Pipeline
+    /// @param ships Ships to run in order until one of them produces a Response
+    /// @return Pipeline A single Ship running every Ship given
+    auto pipeline(detail::ShipConcept auto... ships) {
+        return Pipeline<decltype(ships)...>(std::move(ships)...);
+    }
+
+}// namespace harbour
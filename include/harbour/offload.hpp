@@ -0,0 +1,140 @@
+///  _  _             _
+/// | || | __ _  _ _ | |__  ___  _  _  _ _   A Web Server Framework For Modern C++
+/// | __ |/ _` || '_|| '_ \/ _ \| || || '_|  https://github.com/griefzz/harbour
+/// |_||_|\__,_||_|  |_.__/\___/ \_,_||_|    License: MIT
+///
+/// @file offload.hpp
+/// @brief Contains the implementation of harbours offload awaitable and blocking Ships
+
+#pragma once
+
+#include <exception>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+#include <asio/associated_allocator.hpp>
+#include <asio/async_result.hpp>
+#include <asio/awaitable.hpp>
+#include <asio/bind_allocator.hpp>
+#include <asio/executor_work_guard.hpp>
+#include <asio/post.hpp>
+#include <asio/recycling_allocator.hpp>
+#include <asio/use_awaitable.hpp>
+
+#include "pool.hpp"
+#include "ship.hpp"
+
+namespace harbour {
+
+    namespace detail {
+
+        /// @brief Value carried back from an offloaded callable, std::monostate for void
+        template<typename R>
+        using offload_value_t = std::conditional_t<std::is_void_v<R>, std::monostate, R>;
+
+    }// namespace detail
+
+    /// @brief Run a blocking callable on a Pool and resume on the awaiting coroutine's executor.
+    ///        Callables only ever run on the Pool's workers, even once its queue is past capacity, so at most
+    ///        Settings::threads of them run at once and a Pool doubles as a concurrency limit for whatever it guards,
+    ///        such as a database connection.
+    /// @param pool Pool to run the callable on
+    /// @param fn Callable to run, its exceptions are rethrown in the awaiting coroutine
+    /// @return asio::awaitable<R> Result of the callable
+    template<typename Fn, typename R = std::invoke_result_t<Fn &>>
+        requires(!std::is_reference_v<R>)
+    auto offload(pool::Pool &pool, Fn fn) -> asio::awaitable<R> {
+        using Value     = detail::offload_value_t<R>;
+        using Signature = void(std::exception_ptr, std::optional<Value>);
+
+        auto init = [&pool](asio::completion_handler_for<Signature> auto handler, Fn fn) {
+            auto work = asio::make_work_guard(handler);
+
+            pool.post([handler = std::move(handler), work = std::move(work), fn = std::move(fn)]() mutable {
+                std::exception_ptr error;
+                std::optional<Value> value;
+                try {
+                    if constexpr (std::is_void_v<R>) {
+                        fn();
+                        value.emplace();
+                    } else {
+                        value.emplace(fn());
+                    }
+                } catch (...) {
+                    error = std::current_exception();
+                }
+
+                // Complete on the awaiting coroutine's executor, not on the worker
+                auto alloc = asio::get_associated_allocator(handler, asio::recycling_allocator<void>());
+                asio::post(work.get_executor(),
+                           asio::bind_allocator(alloc,
+                                                [handler = std::move(handler),
+                                                 error,
+                                                 value = std::move(value)]() mutable {
+                                                    std::move(handler)(error, std::move(value));
+                                                }));
+            });
+        };
+
+        auto result = co_await asio::async_initiate<const asio::use_awaitable_t<> &, Signature>(
+                init, asio::use_awaitable, std::move(fn));
+        if constexpr (!std::is_void_v<R>) co_return std::move(*result);
+    }
+
+    /// @brief Run a blocking callable on the shared blocking Pool and resume on the awaiting coroutine's executor
+    /// @param fn Callable to run, its exceptions are rethrown in the awaiting coroutine
+    /// @return asio::awaitable<R> Result of the callable
+    template<typename Fn, typename R = std::invoke_result_t<Fn &>>
+        requires(!std::is_reference_v<R>)
+    auto offload(Fn fn) -> asio::awaitable<R> {
+        return offload(pool::blocking(), std::move(fn));
+    }
+
+    /// @class Blocking
+    /// @brief Ship that runs a synchronous Ship on a Pool, keeping slow calls off the connection's thread
+    /// @tparam S Synchronous Ship to run
+    template<typename S>
+    class Blocking {
+        static_assert(!detail::is_ship<S> && !detail::is_awaitable<detail::ship_result_t<S>>::value,
+                      "blocking() runs synchronous Ships, awaitable Ships should co_await offload() themselves");
+
+    public:
+        /// @brief Construct a Blocking Ship
+        /// @param pool Pool to run the Ship on
+        /// @param ship Synchronous Ship to run
+        Blocking(pool::Pool &pool, S ship) : pool_(&pool), ship_(std::move(ship)) {}
+
+        /// @brief Run the Ship on the Pool
+        /// @param req Request to handle
+        /// @param resp Response to handle, receives the Response produced by the Ship
+        /// @return detail::Handled True if the Ship produced a Response
+        auto operator()(const Request &req, Response &resp) -> asio::awaitable<detail::Handled> {
+            // The Request and Response outlive the offload since this coroutine is suspended until it completes
+            co_return detail::Handled{co_await offload(*pool_, [&] { return detail::call_ship(ship_, req, resp); })};
+        }
+
+    private:
+        pool::Pool *pool_;///< Pool the Ship runs on
+        S ship_;          ///< Synchronous Ship
+    };
+
+    /// @brief Dock a synchronous Ship so it runs on the shared blocking Pool, for example dock("/", blocking(Index))
+    /// @param ship Synchronous Ship to run
+    /// @return Blocking Ship wrapping ship
+    template<detail::ShipConcept S>
+    auto blocking(S &&ship) -> Blocking<std::decay_t<S>> {
+        return {pool::blocking(), std::forward<S>(ship)};
+    }
+
+    /// @brief Dock a synchronous Ship so it runs on a given Pool, whose thread count limits how many run at once
+    /// @param pool Pool to run the Ship on
+    /// @param ship Synchronous Ship to run
+    /// @return Blocking Ship wrapping ship
+    template<detail::ShipConcept S>
+    auto blocking(pool::Pool &pool, S &&ship) -> Blocking<std::decay_t<S>> {
+        return {pool, std::forward<S>(ship)};
+    }
+
+}// namespace harbour
@@ -0,0 +1,255 @@
+///  _  _             _
+/// | || | __ _  _ _ | |__  ___  _  _  _ _   A Web Server Framework For Modern C++
+/// | __ |/ _` || '_|| '_ \/ _ \| || || '_|  https://github.com/griefzz/harbour
+/// |_||_|\__,_||_|  |_.__/\___/ \_,_||_|    License: MIT
+///
+/// @file perfect_hash.hpp
+/// @brief Contains the implementation of harbours minimal perfect hash sets
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace harbour::perfect_hash {
+
+    /// @brief Finalizer from MurmurHash3, spreads every input bit over the output
+    [[nodiscard]] constexpr auto mix(std::uint64_t h) noexcept -> std::uint64_t {
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ULL;
+        h ^= h >> 33;
+        return h;
+    }
+
+    /// @brief Exact byte-wise key hashing and comparison
+    struct Exact {
+        /// @brief FNV-1a hash of a key
+        [[nodiscard]] static constexpr auto hash(std::string_view key) noexcept -> std::uint64_t {
+            std::uint64_t h = 0xcbf29ce484222325ULL;
+            for (const auto c: key) {
+                h ^= static_cast<std::uint8_t>(c);
+                h *= 0x100000001b3ULL;
+            }
+            return h;
+        }
+
+        /// @brief Compare two keys
+        [[nodiscard]] static constexpr auto equal(std::string_view a, std::string_view b) noexcept -> bool {
+            return a == b;
+        }
+    };
+
+    /// @brief ASCII case-insensitive key hashing and comparison, for keys such as file extensions and header names
+    struct CaseInsensitive {
+        /// @brief Lowercase an ASCII character
+        [[nodiscard]] static constexpr auto lower(char c) noexcept -> char {
+            return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+        }
+
+        /// @brief FNV-1a hash of a lowercased key
+        [[nodiscard]] static constexpr auto hash(std::string_view key) noexcept -> std::uint64_t {
+            std::uint64_t h = 0xcbf29ce484222325ULL;
+            for (const auto c: key) {
+                h ^= static_cast<std::uint8_t>(lower(c));
+                h *= 0x100000001b3ULL;
+            }
+            return h;
+        }
+
+        /// @brief Compare two keys ignoring ASCII case
+        [[nodiscard]] static constexpr auto equal(std::string_view a, std::string_view b) noexcept -> bool {
+            return std::equal(a.begin(), a.end(), b.begin(), b.end(), [](char x, char y) { return lower(x) == lower(y); });
+        }
+    };
+
+    namespace detail {
+
+        /// @brief Marker for a slot that has not been assigned yet
+        inline constexpr auto Empty = std::numeric_limits<std::uint32_t>::max();
+
+        /// @brief Number of seeds to try for a bucket before giving up
+        inline constexpr std::int32_t MaxSeed = 1 << 20;
+
+        /// @brief Slot of a key hash for a given bucket seed
+        [[nodiscard]] constexpr auto slot(std::uint64_t h, std::int32_t seed, std::size_t n) noexcept -> std::size_t {
+            if (seed < 0) return static_cast<std::size_t>(-seed - 1);
+            return mix(h ^ (static_cast<std::uint64_t>(seed) * 0x9e3779b97f4a7c15ULL)) % n;
+        }
+
+        /// @brief Build a minimal perfect hash using hash-and-displace (CHD).
+        ///        Keys are grouped into buckets, then the largest buckets are placed first by
+        ///        searching for a seed that maps all of their keys to free slots. Buckets with
+        ///        a single key store their slot directly as a negative seed.
+        /// @tparam Traits Key hashing and comparison policy
+        /// @param keys Keys to hash, must be unique
+        /// @param seeds Per bucket seeds to fill, same size as keys
+        /// @param slots Slot to key index table to fill, same size as keys
+        /// @return bool True on success, false if the keys contain a duplicate
+        template<typename Traits, typename Keys, typename Seeds, typename Slots>
+        constexpr auto build(const Keys &keys, Seeds &seeds, Slots &slots) -> bool {
+            const auto n = keys.size();
+            std::fill(seeds.begin(), seeds.end(), 0);
+            std::fill(slots.begin(), slots.end(), Empty);
+            if (n == 0) return true;
+
+            // Group keys into buckets with a counting sort
+            std::vector<std::uint64_t> hashes(n);
+            std::vector<std::uint32_t> start(n + 1), members(n);
+            for (std::size_t i = 0; i < n; i++) {
+                hashes[i] = Traits::hash(keys[i]);
+                start[mix(hashes[i]) % n + 1]++;
+            }
+            std::partial_sum(start.begin(), start.end(), start.begin());
+            {
+                auto fill = start;
+                for (std::size_t i = 0; i < n; i++)
+                    members[fill[mix(hashes[i]) % n]++] = static_cast<std::uint32_t>(i);
+            }
+
+            // Place the largest buckets first
+            std::vector<std::uint32_t> order(n);
+            std::iota(order.begin(), order.end(), 0u);
+            std::sort(order.begin(), order.end(), [&](auto a, auto b) {
+                return start[a + 1] - start[a] > start[b + 1] - start[b];
+            });
+
+            std::vector<char> taken(n);
+            std::vector<std::size_t> candidate(n);
+            std::size_t free = 0;
+            for (const auto bucket: order) {
+                const auto begin = start[bucket];
+                const auto size  = start[bucket + 1] - begin;
+                if (size == 0) break;
+
+                // Single key buckets take the next free slot directly
+                if (size == 1) {
+                    while (taken[free]) free++;
+                    taken[free]   = 1;
+                    slots[free]   = members[begin];
+                    seeds[bucket] = -static_cast<std::int32_t>(free) - 1;
+                    continue;
+                }
+
+                // Duplicate keys always share a bucket and can never be separated
+                for (std::size_t i = 0; i < size; i++)
+                    for (std::size_t j = i + 1; j < size; j++)
+                        if (Traits::equal(keys[members[begin + i]], keys[members[begin + j]]))
+                            return false;
+
+                for (std::int32_t seed = 1;; seed++) {
+                    if (seed == MaxSeed) return false;
+
+                    std::size_t placed = 0;
+                    for (; placed < size; placed++) {
+                        const auto s = slot(hashes[members[begin + placed]], seed, n);
+                        if (taken[s] || std::find(candidate.begin(), candidate.begin() + placed, s) != candidate.begin() + placed)
+                            break;
+                        candidate[placed] = s;
+                    }
+
+                    if (placed == size) {
+                        for (std::size_t i = 0; i < size; i++) {
+                            taken[candidate[i]] = 1;
+                            slots[candidate[i]] = members[begin + i];
+                        }
+                        seeds[bucket] = seed;
+                        break;
+                    }
+                }
+            }
+
+            return true;
+        }
+
+        /// @brief Find the index of a key in a minimal perfect hash
+        /// @return std::optional<std::size_t> Index of the key in keys, empty if the key isnt in the set
+        template<typename Traits, typename Keys, typename Seeds, typename Slots>
+        [[nodiscard]] constexpr auto find(const Keys &keys, const Seeds &seeds, const Slots &slots,
+                                          std::string_view key) noexcept -> std::optional<std::size_t> {
+            const auto n = keys.size();
+            if (n == 0) return {};
+
+            const auto h     = Traits::hash(key);
+            const auto index = slots[slot(h, seeds[mix(h) % n], n)];
+            if (Traits::equal(keys[index], key)) return index;
+            return {};
+        }
+
+    }// namespace detail
+
+    /// @class FixedSet
+    /// @brief Minimal perfect hash set of N keys that can be built at compile time.
+    ///        A lookup costs one hash of the key, two table reads and one comparison.
+    /// @tparam N Number of keys
+    /// @tparam Traits Key hashing and comparison policy
+    template<std::size_t N, typename Traits = Exact>
+    class FixedSet {
+    public:
+        /// @brief Build the set from its keys
+        /// @param keys Keys of the set, must be unique
+        /// @throws std::invalid_argument if the keys contain a duplicate, a compile error in a constant expression
+        constexpr explicit FixedSet(const std::array<std::string_view, N> &keys) : keys_(keys) {
+            if (!detail::build<Traits>(keys_, seeds_, slots_))
+                throw std::invalid_argument("perfect_hash::FixedSet keys must be unique");
+        }
+
+        /// @brief Find the index of a key
+        /// @param key Key to find
+        /// @return std::optional<std::size_t> Index of the key in keys(), empty if the key isnt in the set
+        [[nodiscard]] constexpr auto find(std::string_view key) const noexcept -> std::optional<std::size_t> {
+            return detail::find<Traits>(keys_, seeds_, slots_, key);
+        }
+
+        /// @brief Get the keys of the set in their original order
+        [[nodiscard]] constexpr auto keys() const noexcept -> const std::array<std::string_view, N> & { return keys_; }
+
+    private:
+        std::array<std::string_view, N> keys_{};///< Keys in their original order
+        std::array<std::int32_t, N> seeds_{};   ///< Per bucket seeds
+        std::array<std::uint32_t, N> slots_{};  ///< Slot to key index table
+    };
+
+    /// @class Set
+    /// @brief Minimal perfect hash set built at runtime from a fixed list of keys
+    /// @tparam Traits Key hashing and comparison policy
+    template<typename Traits = Exact>
+    class Set {
+    public:
+        Set() = default;
+
+        /// @brief Build the set from its keys
+        /// @param keys Keys of the set, must be unique
+        /// @throws std::invalid_argument if the keys contain a duplicate
+        explicit Set(std::vector<std::string> keys)
+            : keys_(std::move(keys)), seeds_(keys_.size()), slots_(keys_.size()) {
+            if (!detail::build<Traits>(keys_, seeds_, slots_))
+                throw std::invalid_argument("perfect_hash::Set keys must be unique");
+        }
+
+        /// @brief Find the index of a key
+        /// @param key Key to find
+        /// @return std::optional<std::size_t> Index of the key in keys(), empty if the key isnt in the set
+        [[nodiscard]] auto find(std::string_view key) const noexcept -> std::optional<std::size_t> {
+            return detail::find<Traits>(keys_, seeds_, slots_, key);
+        }
+
+        /// @brief Get the keys of the set in their original order
+        [[nodiscard]] auto keys() const noexcept -> const std::vector<std::string> & { return keys_; }
+
+    private:
+        std::vector<std::string> keys_;   ///< Keys in their original order
+        std::vector<std::int32_t> seeds_; ///< Per bucket seeds
+        std::vector<std::uint32_t> slots_;///< Slot to key index table
+    };
+
+}// namespace harbour::perfect_hash
@@ -0,0 +1,261 @@
+///  _  _             _
+/// | || | __ _  _ _ | |__  ___  _  _  _ _   A Web Server Framework For Modern C++
+/// | __ |/ _` || '_|| '_ \/ _ \| || || '_|  https://github.com/griefzz/harbour
+/// |_||_|\__,_||_|  |_.__/\___/ \_,_||_|    License: MIT
+///
+/// @file pool.hpp
+/// @brief Contains the implementation of harbours bounded work-stealing pool for blocking tasks
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/// @brief Number of worker threads in the shared blocking pool, 0 picks one per hardware thread (at least 4)
+#ifndef HARBOUR_BLOCKING_THREADS
+    #define HARBOUR_BLOCKING_THREADS 0
+#endif
+
+/// @brief Tasks queued on the shared blocking pool before further tasks are counted as overflowed
+#ifndef HARBOUR_BLOCKING_QUEUE
+    #define HARBOUR_BLOCKING_QUEUE 1024
+#endif
+
+namespace harbour::pool {
+
+    /// @brief Move-only type erased task
+    class Task {
+    public:
+        Task() = default;
+
+        template<typename Fn>
+            requires(!std::is_same_v<std::remove_cvref_t<Fn>, Task> && std::is_invocable_v<std::decay_t<Fn> &>)
+        Task(Fn &&fn) : impl_(std::make_unique<Model<std::decay_t<Fn>>>(std::forward<Fn>(fn))) {}
+
+        /// @brief Run the task
+        auto operator()() -> void { impl_->run(); }
+
+        /// @brief Check if the Task holds a callable
+        explicit operator bool() const noexcept { return impl_ != nullptr; }
+
+    private:
+        struct Concept {
+            virtual ~Concept()     = default;
+            virtual auto run() -> void = 0;
+        };
+
+        template<typename Fn>
+        struct Model final : Concept {
+            explicit Model(Fn &&fn) : fn(std::move(fn)) {}
+            explicit Model(const Fn &fn) : fn(fn) {}
+            auto run() -> void override { fn(); }
+            Fn fn;
+        };
+
+        std::unique_ptr<Concept> impl_;
+    };
+
+    /// @brief Settings for a Pool
+    struct Settings {
+        std::size_t threads{4};    ///< Number of worker threads, the most tasks that run at once
+        std::size_t capacity{1024};///< Soft limit on queued tasks, tasks queued past it are counted as overflowed
+    };
+
+    /// @brief Snapshot of a Pool's counters
+    struct Stats {
+        std::size_t threads{0};     ///< Number of worker threads
+        std::size_t queued{0};      ///< Tasks waiting for a worker
+        std::size_t running{0};     ///< Tasks being run by a worker
+        std::size_t max_queued{0};  ///< Deepest the queue has been
+        std::uint64_t submitted{0}; ///< Tasks handed to the Pool
+        std::uint64_t completed{0}; ///< Tasks finished by a worker
+        std::uint64_t stolen{0};    ///< Tasks a worker took from another worker's queue
+        std::uint64_t overflowed{0};///< Tasks queued while the queue was past its capacity
+    };
+
+    /// @class Pool
+    /// @brief Fixed set of threads for blocking work such as file reads, template rendering and database calls,
+    ///        keeping it off the threads running the io_context.
+    ///        Each worker owns a queue: tasks posted from a worker go to its own queue and are taken newest first,
+    ///        tasks posted from anywhere else are spread across the queues, and idle workers steal the oldest task
+    ///        of another worker. Tasks only ever run on a worker, never on the thread that posted them, so a post
+    ///        from the io_context never blocks it. Settings::capacity is a soft limit: tasks posted past it are still
+    ///        queued and counted in Stats::overflowed, a sign the Pool needs more threads or its callers need slowing down.
+    class Pool {
+    public:
+        /// @brief Construct a Pool and start its workers
+        /// @param settings Number of workers and queue capacity
+        explicit Pool(const Settings &settings = {})
+            : capacity_(std::max<std::size_t>(settings.capacity, 1)),
+              queues_(std::max<std::size_t>(settings.threads, 1)) {
+            workers_.reserve(queues_.size());
+            for (std::size_t i = 0; i < queues_.size(); i++)
+                workers_.emplace_back([this, i] { work(i); });
+        }
+
+        Pool(const Pool &)            = delete;
+        Pool &operator=(const Pool &) = delete;
+
+        /// @brief Run every queued task, then stop and join the workers
+        ~Pool() {
+            {
+                std::lock_guard lock(sleep_);
+                stopping_ = true;
+            }
+            wake_.notify_all();
+            for (auto &worker: workers_) worker.join();
+        }
+
+        /// @brief Queue a task for a worker, even when the queue is past its capacity
+        /// @param task Task to run
+        auto post(Task task) -> void {
+            submitted_.fetch_add(1, std::memory_order_relaxed);
+
+            const auto depth = queued_.fetch_add(1, std::memory_order_acq_rel) + 1;
+            if (depth > capacity_) overflowed_.fetch_add(1, std::memory_order_relaxed);
+
+            auto seen = max_queued_.load(std::memory_order_relaxed);
+            while (depth > seen && !max_queued_.compare_exchange_weak(seen, depth, std::memory_order_relaxed)) {}
+
+            const auto index = current() == this ? worker_index()
+                                                  : next_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+            {
+                std::lock_guard lock(queues_[index].mutex);
+                queues_[index].tasks.push_back(std::move(task));
+            }
+
+            // Lock before notifying so a worker checking for work can't miss the wakeup
+            { std::lock_guard lock(sleep_); }
+            wake_.notify_one();
+        }
+
+        /// @brief Get a snapshot of the Pool's counters
+        [[nodiscard]] auto stats() const noexcept -> Stats {
+            return {.threads    = workers_.size(),
+                    .queued     = queued_.load(std::memory_order_relaxed),
+                    .running    = running_.load(std::memory_order_relaxed),
+                    .max_queued = max_queued_.load(std::memory_order_relaxed),
+                    .submitted  = submitted_.load(std::memory_order_relaxed),
+                    .completed  = completed_.load(std::memory_order_relaxed),
+                    .stolen     = stolen_.load(std::memory_order_relaxed),
+                    .overflowed = overflowed_.load(std::memory_order_relaxed)};
+        }
+
+        /// @brief Get the number of worker threads
+        [[nodiscard]] auto size() const noexcept -> std::size_t { return workers_.size(); }
+
+        /// @brief Check if the calling thread is one of this Pool's workers
+        [[nodiscard]] auto on_worker() const noexcept -> bool { return current() == this; }
+
+    private:
+        /// @brief Queue owned by a single worker
+        struct Queue {
+            std::mutex mutex;       ///< Guards tasks
+            std::deque<Task> tasks; ///< Queued tasks, the owner takes from the back and thieves from the front
+        };
+
+        /// @brief Pool the calling thread works for
+        static auto current() noexcept -> const Pool *& {
+            thread_local const Pool *pool = nullptr;
+            return pool;
+        }
+
+        /// @brief Index of the calling worker thread
+        static auto worker_index() noexcept -> std::size_t & {
+            thread_local std::size_t index = 0;
+            return index;
+        }
+
+        /// @brief Take a task from a worker's own queue, or steal one from another
+        auto take(std::size_t self, Task &task) -> bool {
+            {
+                auto &own = queues_[self];
+                std::lock_guard lock(own.mutex);
+                if (!own.tasks.empty()) {
+                    task = std::move(own.tasks.back());
+                    own.tasks.pop_back();
+                    return true;
+                }
+            }
+
+            for (std::size_t i = 1; i < queues_.size(); i++) {
+                auto &victim = queues_[(self + i) % queues_.size()];
+                std::lock_guard lock(victim.mutex);
+                if (!victim.tasks.empty()) {
+                    task = std::move(victim.tasks.front());
+                    victim.tasks.pop_front();
+                    stolen_.fetch_add(1, std::memory_order_relaxed);
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        /// @brief Worker loop, runs tasks until the Pool stops and every queue is empty
+        auto work(std::size_t self) -> void {
+            current()      = this;
+            worker_index() = self;
+
+            for (;;) {
+                Task task;
+                if (take(self, task)) {
+                    queued_.fetch_sub(1, std::memory_order_acq_rel);
+                    running_.fetch_add(1, std::memory_order_relaxed);
+                    try {
+                        task();
+                    } catch (...) {
+                        // Tasks report their own errors, a throwing task must not take a worker down with it
+                    }
+                    running_.fetch_sub(1, std::memory_order_relaxed);
+                    completed_.fetch_add(1, std::memory_order_relaxed);
+                    continue;
+                }
+
+                std::unique_lock lock(sleep_);
+                wake_.wait(lock, [this] { return stopping_ || queued_.load(std::memory_order_acquire) > 0; });
+                if (stopping_ && queued_.load(std::memory_order_acquire) == 0) return;
+            }
+        }
+
+        std::size_t capacity_;       ///< Soft limit on queued tasks
+        std::vector<Queue> queues_;  ///< One queue per worker
+        std::vector<std::thread> workers_;///< Worker threads
+
+        std::mutex sleep_;               ///< Guards stopping_ and pairs with wake_
+        std::condition_variable wake_;   ///< Wakes idle workers
+        bool stopping_{false};           ///< Set once the Pool is being destroyed
+
+        std::atomic<std::size_t> next_{0};        ///< Round robin queue for tasks posted from outside the Pool
+        std::atomic<std::size_t> queued_{0};      ///< Tasks waiting for a worker
+        std::atomic<std::size_t> running_{0};     ///< Tasks being run
+        std::atomic<std::size_t> max_queued_{0};  ///< Deepest the queue has been
+        std::atomic<std::uint64_t> submitted_{0}; ///< Tasks handed to the Pool
+        std::atomic<std::uint64_t> completed_{0}; ///< Tasks finished by a worker
+        std::atomic<std::uint64_t> stolen_{0};    ///< Tasks stolen from another worker
+        std::atomic<std::uint64_t> overflowed_{0};///< Tasks queued past the capacity
+    };
+
+    /// @brief Get the Pool shared by file loading, template rendering and offloaded Ships.
+    ///        Sized by HARBOUR_BLOCKING_THREADS and HARBOUR_BLOCKING_QUEUE, started on first use.
+    [[nodiscard]] inline auto blocking() -> Pool & {
+        static Pool pool([] {
+            Settings settings;
+            settings.threads  = HARBOUR_BLOCKING_THREADS ? static_cast<std::size_t>(HARBOUR_BLOCKING_THREADS)
+                                                         : std::max<std::size_t>(4, std::thread::hardware_concurrency());
+            settings.capacity = HARBOUR_BLOCKING_QUEUE;
+            return settings;
+        }());
+        return pool;
+    }
+
+}// namespace harbour::pool
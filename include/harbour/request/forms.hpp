@@ -11,14 +11,16 @@
 #include <string>
 
 #include "headers.hpp"
+#include "../memory.hpp"
 
 namespace harbour::request::detail::FormData {
 
     /// @brief Parse form data from a HTTP Request
     /// @param data Form data string for example: 'name=bob&id=123'
+    /// @param alloc Allocator for the map
     /// @return request::Headers Parsed form data as a map
-    static auto parse(const std::string_view data) -> request::Headers {
-        request::Headers form;
+    static auto parse(const std::string_view data, memory::Allocator alloc = {}) -> request::Headers {
+        request::Headers form(alloc);
         size_t start = 0;
         size_t end   = 0;
 
@@ -0,0 +1,119 @@
+///  _  _             _
+/// | || | __ _  _ _ | |__  ___  _  _  _ _   A Web Server Framework For Modern C++
+/// | __ |/ _` || '_|| '_ \/ _ \| || || '_|  https://github.com/griefzz/harbour
+/// |_||_|\__,_||_|  |_.__/\___/ \_,_||_|    License: MIT
+///
+/// @file framing.hpp
+/// @brief Contains the implementation of harbours http request framing
+
+#pragma once
+
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+#include "../http/fields.hpp"
+
+namespace harbour::request {
+
+    /// @brief State of the first http request in a buffer
+    enum class Framing : std::uint8_t {
+        Complete,///< The whole request is buffered
+        Partial, ///< More bytes are needed
+        Invalid  ///< The framing headers are malformed or conflict
+    };
+
+    namespace detail {
+
+        /// @brief Find the end of a chunked body
+        /// @param data Buffered bytes
+        /// @param pos Start of the body
+        /// @param length Set to the length of the request if it is complete
+        /// @return Framing State of the body
+        [[nodiscard]] inline auto chunked_length(std::string_view data, std::size_t pos, std::size_t &length) noexcept -> Framing {
+            for (;;) {
+                const auto eol = data.find("\r\n", pos);
+                if (eol == std::string_view::npos) return Framing::Partial;
+
+                // Chunk size in hex, optionally followed by extensions
+                const auto line      = data.substr(pos, eol - pos);
+                std::uint64_t size   = 0;
+                const auto [ptr, ec] = std::from_chars(line.data(), line.data() + line.size(), size, 16);
+                if (ec != std::errc{} || ptr == line.data()) return Framing::Invalid;
+                if (ptr != line.data() + line.size() && *ptr != ';' && *ptr != ' ' && *ptr != '\t') return Framing::Invalid;
+                pos = eol + 2;
+
+                // The last chunk is followed by optional trailers and a blank line
+                if (size == 0) {
+                    if (data.substr(pos).starts_with("\r\n")) {
+                        length = pos + 2;
+                        return Framing::Complete;
+                    }
+                    const auto end = data.find("\r\n\r\n", pos);
+                    if (end == std::string_view::npos) return Framing::Partial;
+                    length = end + 4;
+                    return Framing::Complete;
+                }
+
+                if (size > data.size() || data.size() - pos < size + 2) return Framing::Partial;
+                if (data.substr(pos + size, 2) != "\r\n") return Framing::Invalid;
+                pos += size + 2;
+            }
+        }
+
+    }// namespace detail
+
+    /// @brief Find the length of the first http request in a buffer.
+    ///        The request ends after its head, then Content-Length bytes or the last chunk of a chunked body.
+    ///        Bytes after it belong to the next pipelined request.
+    /// @param data Buffered bytes, starting at a request
+    /// @param length Set to the length of the request if it is complete
+    /// @return Framing Complete if the request is buffered, Partial if more bytes are needed, Invalid if it can't be framed
+    [[nodiscard]] inline auto frame(std::string_view data, std::size_t &length) noexcept -> Framing {
+        const auto end = data.find("\r\n\r\n");
+        if (end == std::string_view::npos) return Framing::Partial;
+
+        std::optional<std::uint64_t> content_length;
+        bool chunked = false;
+
+        // Every line of the head after the request line
+        auto pos = data.find("\r\n") + 2;
+        while (pos < end + 2) {
+            const auto eol  = data.find("\r\n", pos);
+            const auto line = data.substr(pos, eol - pos);
+            pos             = eol + 2;
+
+            const auto colon = line.find(':');
+            if (colon == std::string_view::npos) continue;// Left for the parser to reject
+            const auto name  = line.substr(0, colon);
+            const auto value = http::fields::trim(line.substr(colon + 1));
+
+            if (http::fields::iequals(name, "Content-Length")) {
+                std::uint64_t n      = 0;
+                const auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), n);
+                if (ec != std::errc{} || ptr != value.data() + value.size() || value.empty()) return Framing::Invalid;
+                if (content_length && *content_length != n) return Framing::Invalid;
+                content_length = n;
+            } else if (http::fields::iequals(name, "Transfer-Encoding")) {
+                // Only chunked bodies can be framed, and it must be the last coding
+                const auto last = value.substr(value.rfind(',') == std::string_view::npos ? 0 : value.rfind(',') + 1);
+                if (!http::fields::iequals(http::fields::trim(last), "chunked")) return Framing::Invalid;
+                chunked = true;
+            }
+        }
+
+        // A request with both could be framed differently by a proxy in front of us
+        if (chunked && content_length) return Framing::Invalid;
+        if (chunked) return detail::chunked_length(data, end + 4, length);
+
+        length = end + 4;
+        if (content_length) {
+            if (data.size() - length < *content_length) return Framing::Partial;
+            length += static_cast<std::size_t>(*content_length);
+        }
+        return Framing::Complete;
+    }
+
+}// namespace harbour::request
@@ -8,6 +8,11 @@
 
 #pragma once
 
+#include <array>
+#include <functional>
+#include <memory_resource>
+#include <vector>
+#include <optional>
 #include <string_view>
 
 #include <ankerl/unordered_dense.h>
@@ -15,10 +20,88 @@
 #include <fmt/base.h>
 #include <fmt/format.h>
 
+/// @brief Number of Request headers stored inline before spilling onto the heap
+#ifndef HARBOUR_MAX_INLINE_HEADERS
+    #define HARBOUR_MAX_INLINE_HEADERS 32
+#endif
+
 namespace harbour::request {
 
     /// @brief @brief Constant Header map containing key/values for Request
-    using Headers = ankerl::unordered_dense::map<std::string_view, std::string_view>;
+    using Headers = ankerl::unordered_dense::map<std::string_view, std::string_view,
+                                                 ankerl::unordered_dense::hash<std::string_view>, std::equal_to<std::string_view>,
+                                                 std::pmr::polymorphic_allocator<std::pair<std::string_view, std::string_view>>>;
+
+    /// @brief Single Request header as views into the raw Request data
+    struct Header {
+        std::string_view key;  ///< Header field name
+        std::string_view value;///< Header field value
+    };
+
+    /// @brief Fixed capacity list of Request headers.
+    ///        The first N headers are stored inline, any headers past that
+    ///        spill into a heap allocated overflow vector.
+    /// @tparam N Number of headers to store inline
+    template<std::size_t N>
+    class HeaderList {
+    public:
+        /// @brief Append a header to the list
+        /// @param header Header to append
+        constexpr auto push_back(const Header &header) -> void {
+            if (size_ < N)
+                inline_[size_] = header;
+            else
+                overflow_.push_back(header);
+            size_++;
+        }
+
+        /// @brief Access a header by index
+        /// @param i Index of the header
+        /// @return Reference to the header
+        [[nodiscard]] constexpr auto operator[](std::size_t i) noexcept -> Header & {
+            return i < N ? inline_[i] : overflow_[i - N];
+        }
+
+        /// @brief Access a header by index
+        /// @param i Index of the header
+        /// @return Reference to the header
+        [[nodiscard]] constexpr auto operator[](std::size_t i) const noexcept -> const Header & {
+            return i < N ? inline_[i] : overflow_[i - N];
+        }
+
+        /// @brief Find the value of a header by key. The last matching header wins.
+        /// @param key Key of the header to find
+        /// @return std::optional<std::string_view> Value of the header, empty if not found
+        [[nodiscard]] constexpr auto find(std::string_view key) const noexcept -> std::optional<std::string_view> {
+            for (std::size_t i = size_; i-- > 0;) {
+                const auto &h = (*this)[i];
+                if (h.key == key) return h.value;
+            }
+            return {};
+        }
+
+        /// @brief Get the number of headers in the list
+        /// @return Number of headers
+        [[nodiscard]] constexpr auto size() const noexcept -> std::size_t { return size_; }
+
+        /// @brief Check if the list contains no headers
+        /// @return True if empty, false otherwise
+        [[nodiscard]] constexpr auto empty() const noexcept -> bool { return size_ == 0; }
+
+        /// @brief Remove every header from the list
+        constexpr auto clear() noexcept -> void {
+            overflow_.clear();
+            size_ = 0;
+        }
+
+    private:
+        std::array<Header, N> inline_{};///< Inline header storage
+        std::vector<Header> overflow_{};///< Overflow storage for headers past N
+        std::size_t size_{0};           ///< Number of headers in the list
+    };
+
+    /// @brief Default HeaderList used by Request
+    using InlineHeaders = HeaderList<HARBOUR_MAX_INLINE_HEADERS>;
 
 }// namespace harbour::request
 
@@ -32,4 +115,4 @@ struct fmt::formatter<harbour::request::Headers> : formatter<string_view> {
 
         return formatter<string_view>::format(s, ctx);
     }
-};
\ No newline at end of file
+};
@@ -8,22 +8,25 @@
 
 #pragma once
 
+#include <cstdint>
 #include <span>
-#include <vector>
 
 #include <llhttp.h>
 
+#include "headers.hpp"
 #include "../http/method.hpp"
+#include "../log/log.hpp"
 
 namespace harbour::request::detail {
 
     /// @brief Structure to hold request data.
     struct RequestData {
-        std::span<const char> path;                 //< URL path for the parser callbacks
-        std::span<const char> data;                 //< Request body for callbacks
-        std::vector<std::span<const char>> keys{};  //< Keys returned from parser callbacks
-        std::vector<std::span<const char>> values{};//< Values returned from parser callbacks
-        http::Method method;                        //< Method returned from parser callbacks
+        std::span<const char> path;//< URL path for the parser callbacks
+        std::span<const char> data;//< Request body for callbacks
+        InlineHeaders headers{};   //< Headers returned from parser callbacks
+        std::size_t values{0};     //< Number of header values returned from parser callbacks
+        http::Method method;       //< Method returned from parser callbacks
+        std::uint8_t version{1};   //< Minor HTTP version, 0 for HTTP/1.0 and 1 for HTTP/1.1
     };
 
     /// @brief Callback function for URL parsing.
@@ -44,7 +47,7 @@ namespace harbour::request::detail {
     /// @return HPE_OK on success.
     int on_header_field(llhttp_t *p, const char *at, size_t length) {
         auto req = static_cast<RequestData *>(p->data);
-        req->keys.emplace_back(at, length);
+        req->headers.push_back({std::string_view(at, length), {}});
         return HPE_OK;
     }
 
@@ -55,7 +58,9 @@ namespace harbour::request::detail {
     /// @return HPE_OK on success.
     int on_header_value(llhttp_t *p, const char *at, size_t length) {
         auto req = static_cast<RequestData *>(p->data);
-        req->values.emplace_back(at, length);
+        if (req->values < req->headers.size())
+            req->headers[req->values].value = std::string_view(at, length);
+        req->values++;
         return HPE_OK;
     }
 
@@ -82,15 +87,66 @@ namespace harbour::request::detail {
             case HTTP_POST:
                 req->method = http::Method::POST;
                 return HPE_OK;
-            case HTTP_PUT:// TODO
+            case HTTP_PUT:
                 req->method = http::Method::PUT;
-                return HPE_INVALID_METHOD;
-            case HTTP_HEAD:// TODO
+                return HPE_OK;
+            case HTTP_HEAD:
                 req->method = http::Method::HEAD;
-                return HPE_INVALID_METHOD;
+                return HPE_OK;
+            case HTTP_DELETE:
+                req->method = http::Method::DELETE;
+                return HPE_OK;
+            case HTTP_PATCH:
+                req->method = http::Method::PATCH;
+                return HPE_OK;
+            case HTTP_OPTIONS:
+                req->method = http::Method::OPTIONS;
+                return HPE_OK;
             default:
                 return HPE_INVALID_METHOD;
         }
     }
 
-}// namespace harbour::request::detail
\ No newline at end of file
+    /// @brief Get the llhttp settings shared by every Request parse.
+    ///        The settings are only initialized once instead of on every Request.
+    /// @return const llhttp_settings_t& Reference to the static parser settings
+    inline auto parser_settings() -> const llhttp_settings_t & {
+        static const llhttp_settings_t settings = [] {
+            llhttp_settings_t s;
+            llhttp_settings_init(&s);
+            s.on_url             = on_url;
+            s.on_method_complete = on_method_complete;
+            s.on_header_field    = on_header_field;
+            s.on_header_value    = on_header_value;
+            s.on_body            = on_body;
+            return s;
+        }();
+
+        return settings;
+    }
+
+    /// @brief Parse raw http request data into RequestData using llhttp
+    /// @param req_data RequestData to fill from the parser callbacks
+    /// @param data The string data to parse.
+    /// @param n The length of our string data.
+    /// @return bool True if the request was parsed, false otherwise
+    inline auto parse_llhttp(RequestData &req_data, const char *data, std::size_t n) -> bool {
+        // Initialize llparse using the shared parser settings
+        llhttp_t parser;
+        llhttp_init(&parser, HTTP_REQUEST, &parser_settings());
+
+        // Store the RequestData object inside llparse for use in the callbacks
+        parser.data = static_cast<void *>(&req_data);
+
+        // Execute HTTP parser
+        enum llhttp_errno err = llhttp_execute(&parser, data, n);
+        if (err != HPE_OK && err != HPE_PAUSED_UPGRADE) {
+            log::warn("Parse error: {} {}", llhttp_errno_name(err), parser.reason);
+            return false;
+        }
+
+        req_data.version = parser.http_minor;
+        return true;
+    }
+
+}// namespace harbour::request::detail
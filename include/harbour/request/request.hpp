@@ -13,12 +13,17 @@
 #include <iostream>
 #include <vector>
 #include <span>
+#include <tuple>
 
 #include <llhttp.h>
 
 #include "parser.hpp"
+#include "simd.hpp"
+#include "url.hpp"
 #include "forms.hpp"
 #include "headers.hpp"
+#include "../memory.hpp"
+#include "../router/params.hpp"
 #include "../http/method.hpp"
 #include "../server/socket.hpp"
 #include "../log/log.hpp"
@@ -27,21 +32,24 @@ namespace harbour {
 
     /// @brief Represents an HTTP request.
     struct Request {
-        /// @brief Optional route information type containing the Key and Value for a route as a pair
-        using Route = std::optional<std::pair<std::string, std::string>>;
+        /// @brief Optional route information type containing the Key and Value of the first route parameter as a pair
+        using Route = std::optional<std::pair<std::string_view, std::string_view>>;
 
         /// @brief Creates a Request object from raw http request data.
         /// @param sock The underlying socket connection.
         /// @param data The string data to parse.
         /// @param n The length of our string data.
+        /// @param alloc Allocator for the lazily built maps, usually the connection's Arena
         /// @return std::optional<Request> The parsed Request object, or std::nullopt if parsing fails.
-        [[nodiscard]] static auto create(server::SharedSocket socket, const char *data, std::size_t n) -> std::optional<Request>;
+        [[nodiscard]] static auto create(server::SharedSocket socket, const char *data, std::size_t n,
+                                         memory::Allocator alloc = {}) -> std::optional<Request>;
 
         /// @brief Access a form value by key
         /// @param key The key of the form value to access
         /// @return std::optional<std::string> The value of the form data, or std::nullopt if the key is not found.
         [[nodiscard]] auto form(auto &&key) const -> std::optional<std::string_view> {
-            if (auto it = forms.find(key); it != forms.end())
+            const auto &f = forms();
+            if (auto it = f.find(key); it != f.end())
                 return it->second;
             else
                 return {};
@@ -51,47 +59,101 @@ namespace harbour {
         /// @param key The key of the header to access.
         /// @return std::optional<std::string> The value of the header, or std::nullopt if the key is not found.
         [[nodiscard]] auto header(auto &&key) const -> std::optional<std::string_view> {
-            if (auto it = headers.find(key); it != headers.end())
+            return headers.find(key);
+        }
+
+        /// @brief Access a route parameter by name.
+        /// @param name The name of the parameter in the docked route, for example 'id' for '/users/:id'
+        /// @return std::optional<std::string_view> The raw value from the path, or std::nullopt if the parameter is not found.
+        [[nodiscard]] auto param(std::string_view name) const noexcept -> std::optional<std::string_view> {
+            return params.get(name);
+        }
+
+        /// @brief Access a percent-decoded query parameter by key.
+        /// @param key The key of the query parameter to access.
+        /// @return std::optional<std::string_view> The decoded value, or std::nullopt if the key is not found.
+        [[nodiscard]] auto query(std::string_view key) const -> std::optional<std::string_view> {
+            const auto &q = queries();
+            if (auto it = q.find(key); it != q.end())
                 return it->second;
             else
                 return {};
         }
 
-        Route route;                ///< Trie routing data if it exists
-        http::Method method;        ///< The HTTP method of the request
-        request::Headers headers{}; ///< The headers of the request
-        request::Headers forms{};   ///< The parsed form of the request
-        std::string_view data{};    ///< The full data of the request
-        std::string_view path{};    ///< The path of the request
-        std::string_view body{};    ///< The body of the request
-        server::SharedSocket socket;///< The underlying socket connection
-    };
+        /// @brief Get the percent-decoded query parameters. They are only parsed on first access.
+        /// @return const request::Query& Map of decoded query keys to decoded query values
+        [[nodiscard]] auto queries() const -> const request::Query & {
+            if (!queries_)
+                queries_ = request::url::parse_query(query_string, resource_);
+            return *queries_;
+        }
 
-    auto Request::create(server::SharedSocket socket, const char *data, std::size_t n) -> std::optional<Request> {
-        using namespace request::detail;
+        /// @brief Get the Request headers as a map. The map is only built on first access.
+        /// @return const request::Headers& Map of header keys to header values
+        [[nodiscard]] auto header_map() const -> const request::Headers & {
+            if (!header_map_) {
+                header_map_.emplace(resource_);
+                header_map_->reserve(headers.size());
+                for (std::size_t i = 0; i < headers.size(); i++)
+                    (*header_map_)[headers[i].key] = headers[i].value;
+            }
+            return *header_map_;
+        }
 
-        // Initialize llparse
-        llhttp_settings_t settings;
-        llhttp_settings_init(&settings);
-        settings.on_url             = on_url;
-        settings.on_method_complete = on_method_complete;
-        settings.on_header_field    = on_header_field;
-        settings.on_header_value    = on_header_value;
-        settings.on_body            = on_body;
+        /// @brief Get the parsed form data of a POST Request. The form is only parsed on first access.
+        /// @return const request::Headers& Map of form keys to form values
+        [[nodiscard]] auto forms() const -> const request::Headers & {
+            if (!forms_) {
+                if (method == http::Method::POST)
+                    forms_ = request::detail::FormData::parse(body, resource_);
+                else
+                    forms_.emplace(resource_);
+            }
+            return *forms_;
+        }
 
-        llhttp_t parser;
-        llhttp_init(&parser, HTTP_REQUEST, &settings);
+        Route route;                    ///< First route parameter if it exists
+        router::Params params;          ///< All route parameters captured from the path
+        std::string_view pattern{};     ///< The route pattern that matched the path, empty if none did
+        http::Method method;            ///< The HTTP method of the request
+        std::uint8_t version{1};        ///< Minor HTTP version of the request, 0 for HTTP/1.0 and 1 for HTTP/1.1
+        request::InlineHeaders headers; ///< The headers of the request
+        std::string_view data{};        ///< The full data of the request
+        std::string_view url{};         ///< The raw request target, query string included
+        std::string_view path{};        ///< The path of the request without the query string
+        std::string_view query_string{};///< The raw query string of the request
+        std::string_view body{};        ///< The body of the request
+        server::SharedSocket socket;    ///< The underlying socket connection
+
+    private:
+        std::pmr::memory_resource *resource_{std::pmr::get_default_resource()};///< Memory for the lazily built maps
+        mutable std::optional<request::Headers> header_map_;                  ///< Lazily built header map
+        mutable std::optional<request::Headers> forms_;                       ///< Lazily parsed form data
+        mutable std::optional<request::Query> queries_;                       ///< Lazily parsed query parameters
+    };
 
-        // Store the RequestData object inside llparse for use in the callbacks
-        RequestData req_data;
-        parser.data = static_cast<void *>(&req_data);
+    auto Request::create(server::SharedSocket socket, const char *data, std::size_t n, memory::Allocator alloc) -> std::optional<Request> {
+        using namespace request::detail;
 
         // Execute HTTP parser
-        enum llhttp_errno err = llhttp_execute(&parser, data, n);
-        if (err != HPE_OK && err != HPE_PAUSED_UPGRADE) {
-            log::warn("Parse error: {} {}", llhttp_errno_name(err), parser.reason);
-            return {};
+        RequestData req_data;
+#if defined(HARBOUR_SIMD_PARSER)
+        switch (parse_simd(req_data, data, n)) {
+            case ParseResult::Ok:
+                break;
+            case ParseResult::Fallback:
+                // Let llhttp handle anything the SIMD parser doesnt support
+                req_data = RequestData{};
+                if (!parse_llhttp(req_data, data, n))
+                    return {};
+                break;
+            default:
+                return {};
         }
+#else
+        if (!parse_llhttp(req_data, data, n))
+            return {};
+#endif
 
         // Validate the HTTP request
         Request req;
@@ -101,14 +163,15 @@ namespace harbour {
             return {};
 
         // Must have exactly the same number of header keys as header values
-        if (req_data.keys.size() != req_data.values.size())
+        if (req_data.headers.size() != req_data.values)
             return {};
 
         // Set the HTTP full data
         req.data = std::string_view(data, n);
 
-        // Set the HTTP url path
-        req.path = std::string_view(req_data.path.begin(), req_data.path.end());
+        // Set the HTTP url and split it into its path and query string
+        req.url                              = std::string_view(req_data.path.begin(), req_data.path.end());
+        std::tie(req.path, req.query_string) = request::url::split(req.url);
 
         // Set the HTTP body
         req.body = std::string_view(req_data.data.begin(), req_data.data.end());
@@ -116,20 +179,17 @@ namespace harbour {
         // Set the HTTP method
         req.method = req_data.method;
 
-        // Assemble Request headers from returned callback data
-        for (std::size_t i = 0; i < req_data.keys.size(); i++) {
-            const auto k   = std::string_view(req_data.keys[i].begin(), req_data.keys[i].end());
-            const auto v   = std::string_view(req_data.values[i].begin(), req_data.values[i].end());
-            req.headers[k] = v;
-        }
+        // Set the HTTP version
+        req.version = req_data.version;
 
-        // Parse form data if the method is POST
-        if (req.method == http::Method::POST) {
-            req.forms = FormData::parse(req.data);
-        }
+        // Move the parsed headers into the Request, the header map is built lazily
+        req.headers = std::move(req_data.headers);
 
         // Assign underlying socket
-        req.socket = socket;
+        req.socket = std::move(socket);
+
+        // Lazily built maps allocate from the caller's memory
+        req.resource_ = alloc.resource();
 
         return req;
     }
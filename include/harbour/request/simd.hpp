@@ -0,0 +1,220 @@
+///  _  _             _
+/// | || | __ _  _ _ | |__  ___  _  _  _ _   A Web Server Framework For Modern C++
+/// | __ |/ _` || '_|| '_ \/ _ \| || || '_|  https://github.com/griefzz/harbour
+/// |_||_|\__,_||_|  |_.__/\___/ \_,_||_|    License: MIT
+///
+/// @file simd.hpp
+/// @brief Contains the implementation of harbours SIMD http request parser
+
+#pragma once
+
+#include <array>
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <charconv>
+#include <optional>
+#include <string_view>
+
+#if defined(__AVX2__) || defined(__SSE4_2__) || defined(__SSE2__) || defined(_M_X64)
+    #include <immintrin.h>
+#endif
+
+#include "parser.hpp"
+#include "../http/method.hpp"
+
+namespace harbour::request::detail {
+
+    /// @brief Result of parsing a Request with the SIMD parser
+    enum class ParseResult {
+        Ok,     ///< Request was parsed successfully
+        Error,  ///< Request was malformed or incomplete
+        Fallback///< Request uses a feature the SIMD parser doesnt handle (Transfer-Encoding)
+    };
+
+    namespace simd {
+
+        /// @brief Find the first byte in [p, end) that is <= Max or is DEL (0x7f).
+        ///        Uses AVX2 or SSE4.2 when available, with a scalar fallback for the tail.
+        /// @tparam Max Largest control byte to stop on
+        /// @param p Start of the data to search
+        /// @param end End of the data to search
+        /// @return const char* Pointer to the first delimiter, end if none was found
+        template<std::uint8_t Max>
+        [[nodiscard]] inline auto find_delimiter(const char *p, const char *end) noexcept -> const char * {
+#if defined(__AVX2__)
+            const auto max = _mm256_set1_epi8(static_cast<char>(Max));
+            const auto del = _mm256_set1_epi8(0x7f);
+            for (; end - p >= 32; p += 32) {
+                const auto v   = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+                const auto ctl = _mm256_cmpeq_epi8(_mm256_min_epu8(v, max), v);// v <= Max
+                const auto hit = _mm256_or_si256(ctl, _mm256_cmpeq_epi8(v, del));
+                if (const auto mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(hit)))
+                    return p + std::countr_zero(mask);
+            }
+#elif defined(__SSE4_2__)
+            alignas(16) static constexpr char ranges[16] = {'\x00', static_cast<char>(Max), '\x7f', '\x7f'};
+            const auto r = _mm_load_si128(reinterpret_cast<const __m128i *>(ranges));
+            for (; end - p >= 16; p += 16) {
+                const auto v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+                const auto i = _mm_cmpestri(r, 4, v, 16, _SIDD_UBYTE_OPS | _SIDD_CMP_RANGES | _SIDD_LEAST_SIGNIFICANT);
+                if (i != 16) return p + i;
+            }
+#elif defined(__SSE2__) || defined(_M_X64)
+            const auto max = _mm_set1_epi8(static_cast<char>(Max));
+            const auto del = _mm_set1_epi8(0x7f);
+            for (; end - p >= 16; p += 16) {
+                const auto v   = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+                const auto ctl = _mm_cmpeq_epi8(_mm_min_epu8(v, max), v);// v <= Max
+                const auto hit = _mm_or_si128(ctl, _mm_cmpeq_epi8(v, del));
+                if (const auto mask = static_cast<std::uint32_t>(_mm_movemask_epi8(hit)))
+                    return p + std::countr_zero(mask);
+            }
+#endif
+            for (; p < end; p++) {
+                const auto c = static_cast<std::uint8_t>(*p);
+                if (c <= Max || c == 0x7f) return p;
+            }
+
+            return end;
+        }
+
+        /// @brief Lookup table of valid RFC 9110 token characters used for methods and header names
+        inline constexpr auto TokenTable = [] {
+            std::array<bool, 256> table{};
+            for (char c = '0'; c <= '9'; c++) table[static_cast<std::uint8_t>(c)] = true;
+            for (char c = 'a'; c <= 'z'; c++) table[static_cast<std::uint8_t>(c)] = true;
+            for (char c = 'A'; c <= 'Z'; c++) table[static_cast<std::uint8_t>(c)] = true;
+            for (char c: std::string_view("!#$%&'*+-.^_`|~")) table[static_cast<std::uint8_t>(c)] = true;
+            return table;
+        }();
+
+        /// @brief Check if a character is a valid token character
+        [[nodiscard]] constexpr auto is_token(char c) noexcept -> bool {
+            return TokenTable[static_cast<std::uint8_t>(c)];
+        }
+
+        /// @brief Case insensitive comparison of two ASCII strings
+        [[nodiscard]] constexpr auto iequals(std::string_view a, std::string_view b) noexcept -> bool {
+            if (a.size() != b.size()) return false;
+            for (std::size_t i = 0; i < a.size(); i++)
+                if ((a[i] | 0x20) != (b[i] | 0x20)) return false;
+            return true;
+        }
+
+        /// @brief Convert a method token into a Method, matching the methods llhttp accepts
+        /// @param m Method token to convert
+        /// @return std::optional<http::Method> Method on success, empty if unsupported
+        [[nodiscard]] constexpr auto to_method(std::string_view m) noexcept -> std::optional<http::Method> {
+            if (m == "GET") return http::Method::GET;
+            if (m == "POST") return http::Method::POST;
+            if (m == "PUT") return http::Method::PUT;
+            if (m == "HEAD") return http::Method::HEAD;
+            if (m == "DELETE") return http::Method::DELETE;
+            if (m == "PATCH") return http::Method::PATCH;
+            if (m == "OPTIONS") return http::Method::OPTIONS;
+            return {};
+        }
+
+    }// namespace simd
+
+    /// @brief Parse raw http request data into RequestData using SIMD delimiter search.
+    ///        Produces the same RequestData as parse_llhttp for complete HTTP/1.x requests.
+    ///        Incomplete request heads are rejected and requests using Transfer-Encoding
+    ///        are handed back to the caller to parse with llhttp.
+    /// @param req_data RequestData to fill
+    /// @param data The string data to parse.
+    /// @param n The length of our string data.
+    /// @return ParseResult Result of the parse
+    inline auto parse_simd(RequestData &req_data, const char *data, std::size_t n) -> ParseResult {
+        using namespace simd;
+
+        const char *p   = data;
+        const char *end = data + n;
+
+        // Method
+        const char *start = p;
+        while (p < end && is_token(*p)) p++;
+        if (p == end || *p != ' ') return ParseResult::Error;
+
+        const auto method = to_method(std::string_view(start, p));
+        if (!method) return ParseResult::Error;
+        req_data.method = *method;
+        p++;
+
+        // Request target
+        start = p;
+        p     = find_delimiter<0x20>(p, end);
+        if (p == end || *p != ' ' || p == start) return ParseResult::Error;
+        req_data.path = std::span(start, p);
+        p++;
+
+        // HTTP version
+        constexpr std::string_view version = "HTTP/1.";
+        if (end - p < 10 || std::string_view(p, version.size()) != version) return ParseResult::Error;
+        p += version.size();
+        if ((*p != '0' && *p != '1') || p[1] != '\r' || p[2] != '\n') return ParseResult::Error;
+        req_data.version = static_cast<std::uint8_t>(*p - '0');
+        p += 3;
+
+        // Headers
+        std::optional<std::size_t> content_length;
+        for (;;) {
+            if (end - p < 2) return ParseResult::Error;
+            if (p[0] == '\r' && p[1] == '\n') {
+                p += 2;
+                break;
+            }
+
+            // Header name
+            start = p;
+            while (p < end && is_token(*p)) p++;
+            if (p == end || *p != ':' || p == start) return ParseResult::Error;
+            const auto key = std::string_view(start, p);
+            p++;
+
+            // Skip leading whitespace
+            while (p < end && (*p == ' ' || *p == '\t')) p++;
+
+            // Header value, tabs are the only control byte allowed inside a value
+            start = p;
+            for (;;) {
+                p = find_delimiter<0x1f>(p, end);
+                if (p == end || *p != '\t') break;
+                p++;
+            }
+            if (end - p < 2 || p[0] != '\r' || p[1] != '\n') return ParseResult::Error;
+
+            // Trim trailing whitespace
+            const char *value_end = p;
+            while (value_end > start && (value_end[-1] == ' ' || value_end[-1] == '\t')) value_end--;
+            const auto value = std::string_view(start, value_end);
+            p += 2;
+
+            req_data.headers.push_back({key, value});
+            req_data.values++;
+
+            if (iequals(key, "Transfer-Encoding"))
+                return ParseResult::Fallback;
+
+            if (iequals(key, "Content-Length")) {
+                std::size_t length = 0;
+                auto [ptr, ec]     = std::from_chars(value.data(), value.data() + value.size(), length);
+                if (ec != std::errc{} || ptr != value.data() + value.size() || value.empty())
+                    return ParseResult::Error;
+                if (content_length && *content_length != length)
+                    return ParseResult::Error;
+                content_length = length;
+            }
+        }
+
+        // Body, any bytes after Content-Length are left for a pipelined request
+        if (content_length) {
+            const auto available = static_cast<std::size_t>(end - p);
+            req_data.data        = std::span(p, std::min(*content_length, available));
+        }
+
+        return ParseResult::Ok;
+    }
+
+}// namespace harbour::request::detail
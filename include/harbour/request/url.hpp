@@ -0,0 +1,158 @@
+///  _  _             _
+/// | || | __ _  _ _ | |__  ___  _  _  _ _   A Web Server Framework For Modern C++
+/// | __ |/ _` || '_|| '_ \/ _ \| || || '_|  https://github.com/griefzz/harbour
+/// |_||_|\__,_||_|  |_.__/\___/ \_,_||_|    License: MIT
+///
+/// @file url.hpp
+/// @brief Contains the implementation of harbours URL decomposition and percent-decoding
+
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <optional>
+#include <utility>
+
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64)
+    #include <immintrin.h>
+#endif
+
+#include "../memory.hpp"
+
+namespace harbour::request {
+
+    /// @brief Map of percent-decoded query parameters
+    using Query = memory::StringMap;
+
+    namespace url {
+
+        /// @brief Split a request target into its path and query string.
+        ///        Any fragment is dropped from the query string.
+        /// @param target Request target, for example '/users?id=1'
+        /// @return std::pair<std::string_view, std::string_view> Path and query string
+        [[nodiscard]] constexpr auto split(std::string_view target) noexcept -> std::pair<std::string_view, std::string_view> {
+            const auto fragment = target.find('#');
+            if (fragment != std::string_view::npos)
+                target = target.substr(0, fragment);
+
+            const auto question = target.find('?');
+            if (question == std::string_view::npos)
+                return {target, {}};
+
+            return {target.substr(0, question), target.substr(question + 1)};
+        }
+
+        namespace detail {
+
+            /// @brief Convert a hex digit to its value
+            /// @return Value of the digit, or -1 if c isnt a hex digit
+            [[nodiscard]] constexpr auto hex(char c) noexcept -> int {
+                if (c >= '0' && c <= '9') return c - '0';
+                if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+                if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+                return -1;
+            }
+
+            /// @brief Find the next byte that needs decoding ('%' and optionally '+')
+            /// @param p Start of the data to search
+            /// @param end End of the data to search
+            /// @param plus True if '+' should also be found
+            /// @return const char* Pointer to the next escape, end if none was found
+            [[nodiscard]] inline auto find_escape(const char *p, const char *end, bool plus) noexcept -> const char * {
+                const char alt = plus ? '+' : '%';
+#if defined(__AVX2__)
+                const auto pct = _mm256_set1_epi8('%');
+                const auto add = _mm256_set1_epi8(alt);
+                for (; end - p >= 32; p += 32) {
+                    const auto v   = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+                    const auto hit = _mm256_or_si256(_mm256_cmpeq_epi8(v, pct), _mm256_cmpeq_epi8(v, add));
+                    if (const auto mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(hit)))
+                        return p + std::countr_zero(mask);
+                }
+#elif defined(__SSE2__) || defined(_M_X64)
+                const auto pct = _mm_set1_epi8('%');
+                const auto add = _mm_set1_epi8(alt);
+                for (; end - p >= 16; p += 16) {
+                    const auto v   = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+                    const auto hit = _mm_or_si128(_mm_cmpeq_epi8(v, pct), _mm_cmpeq_epi8(v, add));
+                    if (const auto mask = static_cast<std::uint32_t>(_mm_movemask_epi8(hit)))
+                        return p + std::countr_zero(mask);
+                }
+#endif
+                for (; p < end; p++)
+                    if (*p == '%' || *p == alt) return p;
+
+                return end;
+            }
+
+        }// namespace detail
+
+        /// @brief Percent-decode a string. Runs without escapes are copied in bulk,
+        ///        invalid escapes are kept as is.
+        /// @param in String to decode
+        /// @param out String to append the decoded result to
+        /// @param plus True to decode '+' as a space (application/x-www-form-urlencoded)
+        template<typename Alloc>
+        auto decode(std::string_view in, std::basic_string<char, std::char_traits<char>, Alloc> &out, bool plus = true) -> void {
+            const char *p   = in.data();
+            const char *end = in.data() + in.size();
+            out.reserve(out.size() + in.size());
+
+            while (p < end) {
+                const char *next = detail::find_escape(p, end, plus);
+                out.append(p, next);
+                if (next == end) break;
+
+                if (*next == '+') {
+                    out.push_back(' ');
+                    p = next + 1;
+                } else if (end - next >= 3 && detail::hex(next[1]) >= 0 && detail::hex(next[2]) >= 0) {
+                    out.push_back(static_cast<char>(detail::hex(next[1]) << 4 | detail::hex(next[2])));
+                    p = next + 3;
+                } else {
+                    out.push_back('%');
+                    p = next + 1;
+                }
+            }
+        }
+
+        /// @brief Percent-decode a string
+        /// @param in String to decode
+        /// @param plus True to decode '+' as a space (application/x-www-form-urlencoded)
+        /// @return std::string Decoded string
+        [[nodiscard]] inline auto decode(std::string_view in, bool plus = true) -> std::string {
+            std::string out;
+            decode(in, out, plus);
+            return out;
+        }
+
+        /// @brief Parse a query string into a map of percent-decoded keys and values
+        /// @param query Query string, for example 'id=1&name=bob%20smith'
+        /// @param alloc Allocator for the map
+        /// @return Query Map of decoded query parameters
+        [[nodiscard]] inline auto parse_query(std::string_view query, memory::Allocator alloc = {}) -> Query {
+            Query params(alloc);
+            while (!query.empty()) {
+                const auto amp  = query.find('&');
+                const auto pair = query.substr(0, amp);
+                query           = amp == std::string_view::npos ? std::string_view{} : query.substr(amp + 1);
+                if (pair.empty()) continue;
+
+                const auto equal = pair.find('=');
+                std::pmr::string key(alloc);
+                std::pmr::string value(alloc);
+                decode(pair.substr(0, equal), key);
+                if (equal != std::string_view::npos)
+                    decode(pair.substr(equal + 1), value);
+
+                params.insert_or_assign(std::move(key), std::move(value));
+            }
+
+            return params;
+        }
+
+    }// namespace url
+
+}// namespace harbour::request
@@ -0,0 +1,219 @@
+///  _  _             _
+/// | || | __ _  _ _ | |__  ___  _  _  _ _   A Web Server Framework For Modern C++
+/// | __ |/ _` || '_|| '_ \/ _ \| || || '_|  https://github.com/griefzz/harbour
+/// |_||_|\__,_||_|  |_.__/\___/ \_,_||_|    License: MIT
+///
+/// @file body.hpp
+/// @brief Contains the implementation of harbours HTTP Response body
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace harbour::response {
+
+    /// @brief String literal that lives for the whole program, sent without being copied.
+    ///        The constructor is consteval so only compile-time strings are accepted.
+    struct Static {
+        /// @brief Construct from a string literal
+        /// @param s String literal
+        consteval Static(const char *s) : view(s) {}
+
+        std::string_view view;///< View of the literal
+    };
+
+    /// @brief Region of a file sent straight from disk
+    struct File {
+        std::filesystem::path path;///< Path of the file
+        std::uint64_t offset{0};   ///< Offset of the first byte to send
+        std::uint64_t length{0};   ///< Number of bytes to send
+    };
+
+    /// @brief Body generated in chunks while the Response is written, so a large body is never held in memory whole.
+    ///        Each call appends the next chunk, stopping once the buffer holds about limit bytes,
+    ///        and returns false once the body is complete. A Stream can only be sent once.
+    struct Stream {
+        std::function<bool(std::string &buffer, std::size_t limit)> next;///< Append the next chunk to buffer
+    };
+
+    /// @class Body
+    /// @brief Body of a Response.
+    ///        A Body owns a string, shares an immutable string or a slice of one, views a Static string,
+    ///        refers to a File region, is a list of owned and File parts sent one after another or is a Stream.
+    ///        Only owned strings are copied with the Response, shared and static bodies are sent to every
+    ///        client from the same memory, files are streamed from disk and Streams are generated chunk by chunk
+    ///        when the Response is written.
+    class Body {
+    public:
+        /// @brief Immutable string shared between Responses, for cached content
+        using Shared = std::shared_ptr<const std::string>;
+
+        /// @brief Part of a multipart body, either in memory or a File region
+        using Part = std::variant<std::string, File>;
+
+        /// @brief Parts of a multipart body, in the order they are sent
+        using Parts = std::vector<Part>;
+
+        Body() = default;
+
+        /// @brief Empty body
+        Body(std::nullopt_t) noexcept {}
+
+        /// @brief Owned body
+        /// @param s String to own
+        Body(std::string s) noexcept : body_(std::move(s)) {}
+
+        /// @brief Owned copy of a string
+        /// @param s String to copy
+        Body(std::string_view s) : body_(std::string(s)) {}
+
+        /// @brief Owned copy of a C-string
+        /// @param s C-string to copy
+        Body(const char *s) : body_(std::string(s)) {}
+
+        /// @brief Body viewing a string literal
+        /// @param s String literal
+        Body(Static s) noexcept : body_(s.view) {}
+
+        /// @brief Body sharing an immutable string
+        /// @param s String to share, an empty pointer is an empty body
+        Body(Shared s) noexcept {
+            if (s) body_ = std::move(s);
+        }
+
+        /// @brief Body sharing a slice of an immutable string
+        /// @param s String to share
+        /// @param offset Offset of the first byte of the slice
+        /// @param length Number of bytes in the slice
+        Body(Shared s, std::size_t offset, std::size_t length) noexcept {
+            if (s) {
+                const auto view = std::string_view(*s).substr(offset, length);
+                body_           = Slice{std::move(s), view};
+            }
+        }
+
+        /// @brief Body streamed from a file region
+        /// @param f File region to send
+        Body(File f) noexcept : body_(std::move(f)) {}
+
+        /// @brief Body made of parts sent one after another
+        /// @param p Parts to send
+        Body(Parts p) noexcept : body_(std::move(p)) {}
+
+        /// @brief Body generated while the Response is written, sent with chunked transfer encoding
+        /// @param s Stream generating the body
+        Body(Stream s) noexcept : body_(std::move(s)) {}
+
+        /// @brief Check if there is a body
+        [[nodiscard]] auto has_value() const noexcept -> bool { return !std::holds_alternative<std::monostate>(body_); }
+
+        /// @brief Check if there is a body
+        [[nodiscard]] explicit operator bool() const noexcept { return has_value(); }
+
+        /// @brief Get the size of the body in bytes, zero for a Stream since its size isn't known until it is sent
+        [[nodiscard]] auto size() const noexcept -> std::size_t {
+            if (const auto *f = file()) return static_cast<std::size_t>(f->length);
+            if (const auto *p = parts()) {
+                std::size_t n = 0;
+                for (const auto &part: *p)
+                    n += std::visit([](const auto &b) -> std::size_t {
+                        if constexpr (std::is_same_v<std::decay_t<decltype(b)>, File>)
+                            return static_cast<std::size_t>(b.length);
+                        else
+                            return b.size();
+                    },
+                                    part);
+                return n;
+            }
+            return view().size();
+        }
+
+        /// @brief Get a view of an in-memory body
+        /// @return std::string_view View of the body, empty for File and multipart bodies
+        [[nodiscard]] auto view() const noexcept -> std::string_view {
+            return std::visit([](const auto &b) -> std::string_view {
+                using T = std::decay_t<decltype(b)>;
+                if constexpr (std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view>)
+                    return b;
+                else if constexpr (std::is_same_v<T, Shared>)
+                    return *b;
+                else if constexpr (std::is_same_v<T, Slice>)
+                    return b.view;
+                else
+                    return {};
+            },
+                              body_);
+        }
+
+        /// @brief Get a view of an in-memory body
+        [[nodiscard]] auto operator*() const noexcept -> std::string_view { return view(); }
+
+        /// @brief Get the File region of the body
+        /// @return const File* The File region, nullptr if the body is in memory
+        [[nodiscard]] auto file() const noexcept -> const File * { return std::get_if<File>(&body_); }
+
+        /// @brief Get the parts of a multipart body
+        /// @return const Parts* The parts, nullptr if the body is not multipart
+        [[nodiscard]] auto parts() const noexcept -> const Parts * { return std::get_if<Parts>(&body_); }
+
+        /// @brief Get the Stream generating the body
+        /// @return const Stream* The Stream, nullptr if the body isn't streamed
+        [[nodiscard]] auto stream() const noexcept -> const Stream * { return std::get_if<Stream>(&body_); }
+
+        /// @brief Copy the body into a string, reading File bodies from disk and running Streams to completion
+        /// @return std::string Contents of the body
+        [[nodiscard]] auto string() const -> std::string {
+            if (const auto *f = file()) return read(*f);
+            if (const auto *st = stream()) {
+                std::string s;
+                while (st->next && st->next(s, s.size() + 64 * 1024)) {}
+                return s;
+            }
+            if (const auto *p = parts()) {
+                std::string s;
+                for (const auto &part: *p) {
+                    if (const auto *f = std::get_if<File>(&part))
+                        s += read(*f);
+                    else
+                        s += std::get<std::string>(part);
+                }
+                return s;
+            }
+            return std::string(view());
+        }
+
+        /// @brief Compare an in-memory body to a string
+        [[nodiscard]] auto operator==(std::string_view s) const noexcept -> bool { return has_value() && !file() && !parts() && !stream() && view() == s; }
+
+    private:
+        /// @brief Slice of a shared string, keeping the string alive
+        struct Slice {
+            Shared owner;         ///< String the slice views
+            std::string_view view;///< Viewed bytes
+        };
+
+        /// @brief Read a File region from disk
+        [[nodiscard]] static auto read(const File &f) -> std::string {
+            std::string s(static_cast<std::size_t>(f.length), '\0');
+            std::ifstream in(f.path, std::ios::binary);
+            in.seekg(static_cast<std::streamoff>(f.offset));
+            in.read(s.data(), static_cast<std::streamsize>(s.size()));
+            s.resize(static_cast<std::size_t>(in.gcount()));
+            return s;
+        }
+
+        std::variant<std::monostate, std::string, Shared, Slice, std::string_view, File, Parts, Stream> body_;///< Body storage
+    };
+
+}// namespace harbour::response
@@ -10,15 +10,15 @@
 
 #include <string>
 
-#include <ankerl/unordered_dense.h>
-
 #include <fmt/base.h>
 #include <fmt/format.h>
 
+#include "../memory.hpp"
+
 namespace harbour::response {
 
     /// @brief Header map containing key/values for Response
-    using Headers = ankerl::unordered_dense::map<std::string, std::string>;
+    using Headers = memory::StringMap;
 
 }// namespace harbour::response
 
@@ -8,13 +8,17 @@
 
 #pragma once
 
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <optional>
 
 #include <fmt/core.h>
 #include <fmt/format.h>
 
+#include "body.hpp"
 #include "headers.hpp"
+#include "../memory.hpp"
 #include "../http/status.hpp"
 #include "../json.hpp"
 #include "../cookies/cookies.hpp"
@@ -26,11 +30,17 @@ namespace harbour {
         http::Status status{http::Status::OK};///< HTTP status code
         response::Headers headers;            ///< HTTP headers.
         Cookies cookies;                      ///< Cookie data
-        std::optional<std::string> data;      ///< Optional response data.
+        response::Body data;                  ///< Optional response data.
+        response::Body::Shared serialized;    ///< Pre-serialized Response sent as-is instead of the fields above, set by caches.
 
         /// @brief Default constructor.
         [[nodiscard]] Response() = default;
 
+        /// @brief Constructor allocating headers and cookies through an allocator, usually the connection's Arena.
+        ///        A Response moved out of an Arena keeps allocating from it, copy it if it must outlive the request.
+        /// @param alloc Allocator to use.
+        [[nodiscard]] explicit Response(const memory::Allocator &alloc) : headers(alloc), cookies{cookies::Map(alloc), {}} {}
+
         /// @brief Constructor with status.
         /// @param status HTTP status code.
         [[nodiscard]] Response(http::Status status) : status(status) {}
@@ -39,6 +49,10 @@ namespace harbour {
         /// @param data Response data as a string.
         [[nodiscard]] Response(const std::string &data) : status(http::Status::OK), data(data) { headers["Content-Type"] = "text/html; charset=utf-8"; }
 
+        /// @brief Constructor taking ownership of string data.
+        /// @param data Response data as a string.
+        [[nodiscard]] Response(std::string &&data) : status(http::Status::OK), data(std::move(data)) { headers["Content-Type"] = "text/html; charset=utf-8"; }
+
         /// @brief Constructor with string_view data.
         /// @param data Response data as a string.
         [[nodiscard]] Response(std::string_view data) : status(http::Status::OK), data(data) { headers["Content-Type"] = "text/html; charset=utf-8"; }
@@ -47,6 +61,18 @@ namespace harbour {
         /// @param data Response data as a C-string.
         [[nodiscard]] Response(const char *data) : status(http::Status::OK), data(data) { headers["Content-Type"] = "text/html; charset=utf-8"; }
 
+        /// @brief Constructor with a string literal, sent without being copied.
+        /// @param data Response data as a string literal, for example response::Static("Hello").
+        [[nodiscard]] Response(response::Static data) : status(http::Status::OK), data(data) { headers["Content-Type"] = "text/html; charset=utf-8"; }
+
+        /// @brief Constructor with shared immutable data, sent to every client without being copied.
+        /// @param data Response data shared with other Responses.
+        [[nodiscard]] Response(response::Body::Shared data) : status(http::Status::OK), data(std::move(data)) { headers["Content-Type"] = "text/html; charset=utf-8"; }
+
+        /// @brief Constructor with a file region, streamed from disk when the Response is written.
+        /// @param file File region to send, the Content-Type is left for the caller to set.
+        [[nodiscard]] Response(response::File file) : status(http::Status::OK), data(std::move(file)) {}
+
         /// @brief Constructor with JSON data.
         /// @param js Response data as JSON.
         [[nodiscard]] Response(const json &js) : status(http::Status::OK), data(js.data) { headers["Content-Type"] = "application/json"; }
@@ -59,6 +85,14 @@ namespace harbour {
             return *this;
         }
 
+        /// @brief Set the response body.
+        /// @param body Owned, shared, static or file body.
+        /// @return Reference to the modified Response object.
+        [[nodiscard]] auto with_body(response::Body body) noexcept -> Response & {
+            this->data = std::move(body);
+            return *this;
+        }
+
         /// @brief Set HTTP status.
         /// @param status HTTP status code.
         /// @return Reference to the modified Response object.
@@ -112,13 +146,15 @@ namespace harbour {
         /// @brief Access header value by key.
         /// @param key Header key.
         /// @return Reference to the header value.
-        constexpr auto operator[](const auto &key) -> std::string & {
+        constexpr auto operator[](const auto &key) -> std::pmr::string & {
             return headers[key];
         }
 
-        /// @brief Convert the response to a string.
-        /// @return Response as a string.
-        [[nodiscard]] auto string() -> std::string {
+        /// @brief Convert the status line and headers to a string, ending with the blank line before the body.
+        /// @param keep_alive Whether the connection stays open after this Response
+        /// @param version Minor HTTP version of the Request, HTTP/1.0 clients can't read chunked Streams
+        /// @return Response head as a string.
+        [[nodiscard]] auto head(bool keep_alive = true, std::uint8_t version = 1) const -> std::string {
             std::string resp;
 
             // Status
@@ -133,16 +169,44 @@ namespace harbour {
                 resp += fmt::format("Set-Cookie: {}\n", cookies);
 
             // Connection
-            resp += fmt::format("Connection: keep-alive\n");
-
-            // Data
-            if (data)
-                resp += fmt::format("Content-Length: {}\n\n{}", data->size(), *data);
+            resp += keep_alive ? "Connection: keep-alive\n" : "Connection: close\n";
+
+            // Data length, the body itself is written after the head. Streams are sent in chunks of unknown length,
+            // or to HTTP/1.0 clients as raw bytes ended by closing the connection.
+            // Empty bodies still need a length so the client knows the Response is over, except for statuses that never have one
+            const auto code = static_cast<int>(status);
+            if (data.stream())
+                resp += version >= 1 ? "Transfer-Encoding: chunked\n\n" : "\n";
+            else if (data)
+                resp += fmt::format("Content-Length: {}\n\n", data.size());
+            else if (code >= 200 && code != 204 && code != 304)
+                resp += "Content-Length: 0\n\n";
             else
                 resp += "\n";
 
             return resp;
         }
+
+        /// @brief Convert the response to a string.
+        ///        The body is copied after the head, use head() and data to send the body without copying it.
+        /// @param keep_alive Whether the connection stays open after this Response
+        /// @return Response as a string.
+        [[nodiscard]] auto string(bool keep_alive = true) const -> std::string {
+            if (serialized) {
+                if (keep_alive) return *serialized;
+
+                // Pre-serialized Responses are written for a connection that stays open
+                constexpr std::string_view open = "Connection: keep-alive\n";
+                auto resp                       = *serialized;
+                if (const auto pos = resp.find(open); pos < resp.find("\n\n"))
+                    resp.replace(pos, open.size(), "Connection: close\n");
+                return resp;
+            }
+
+            auto resp = head(keep_alive);
+            if (data) resp += data.string();
+            return resp;
+        }
     };
 
 }// namespace harbour
\ No newline at end of file
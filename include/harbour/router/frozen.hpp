@@ -0,0 +1,167 @@
+///  _  _             _
+/// | || | __ _  _ _ | |__  ___  _  _  _ _   A Web Server Framework For Modern C++
+/// | __ |/ _` || '_|| '_ \/ _ \| || || '_|  https://github.com/griefzz/harbour
+/// |_||_|\__,_||_|  |_.__/\___/ \_,_||_|    License: MIT
+///
+/// @file frozen.hpp
+/// @brief Contains the implementation of harbours flattened read-only route table
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "radix.hpp"
+#include "../perfect_hash.hpp"
+
+namespace harbour::router {
+
+    /// @class FrozenRouter
+    /// @brief Read-only copy of a Router flattened into contiguous arrays.
+    ///        Nodes are laid out breadth-first so the children of a node are adjacent,
+    ///        static children first (sorted by their first byte), then the parameter
+    ///        and catch-all children. Edge labels live in a single string and the first
+    ///        byte of every node in a parallel array, so a lookup touches a handful of cache lines.
+    ///        Routes without parameters are also placed in a minimal perfect hash so they
+    ///        resolve with a single hash and compare before the tree is walked.
+    ///        Route data is not copied, the table points back into the Router it was built
+    ///        from, which must outlive it and must be rebuilt into a new table after an insert.
+    /// @tparam T The type of data stored on each route.
+    template<typename T>
+    class FrozenRouter {
+        using Source = typename Router<T>::Node;
+
+        /// @brief Flattened node of the route table
+        struct Node {
+            std::uint32_t prefix;  ///< Offset of the edge label in labels_
+            std::uint32_t length;  ///< Length of the edge label
+            std::uint32_t children;///< Index of the first child in nodes_
+            std::uint16_t statics; ///< Number of static children
+            bool param;            ///< True if a ':name' child follows the static children
+            bool wildcard;         ///< True if a '*name' child follows the parameter child
+            Source *route;         ///< Route data of the node, nullptr if no route ends here
+        };
+
+    public:
+        FrozenRouter() = default;
+
+        /// @brief Flatten a Router into a read-only route table
+        /// @param router Router to flatten, it must outlive the table
+        explicit FrozenRouter(Router<T> &router) {
+            std::deque<Source *> queue{&router.root()};
+            std::vector<std::string> patterns;
+            nodes_.push_back({});
+
+            for (std::uint32_t i = 0; !queue.empty(); i++) {
+                auto *source = queue.front();
+                queue.pop_front();
+
+                auto &node    = nodes_[i];
+                node.prefix   = static_cast<std::uint32_t>(labels_.size());
+                node.length   = static_cast<std::uint32_t>(source->prefix.size());
+                node.children = static_cast<std::uint32_t>(nodes_.size());
+                node.statics  = static_cast<std::uint16_t>(source->children.size());
+                node.param    = source->param != nullptr;
+                node.wildcard = source->wildcard != nullptr;
+                node.route    = source->value ? source : nullptr;
+                labels_ += source->prefix;
+
+                if (source->value && source->names.empty()) {
+                    patterns.push_back(source->pattern);
+                    statics_.push_back(source);
+                }
+
+                for (auto &child: source->children) queue.push_back(child.get());
+                if (source->param) queue.push_back(source->param.get());
+                if (source->wildcard) queue.push_back(source->wildcard.get());
+
+                // Reserve the children now so each node's children stay adjacent
+                const auto count = node.statics + node.param + node.wildcard;
+                firsts_.push_back(source->prefix.empty() ? '\0' : source->prefix[0]);
+                nodes_.resize(nodes_.size() + count);
+            }
+
+            static_set_ = perfect_hash::Set<>(std::move(patterns));
+        }
+
+        /// @brief Matches a path against the table without allocating.
+        /// @param path The path to match, parameters are returned as views into it
+        /// @return std::optional<Match<T>> The matched route, std::nullopt if no route matched
+        [[nodiscard]] auto match(std::string_view path) const noexcept -> std::optional<Match<T>> {
+            if (nodes_.empty()) return {};
+
+            // Static routes resolve through the perfect hash
+            path = detail::trim(path);
+            if (auto i = static_set_.find(path)) {
+                auto *route = statics_[*i];
+                return Match<T>{&*route->value, route->pattern, {}};
+            }
+
+            Params params;
+            if (auto route = find(0, path, params)) {
+                for (std::size_t i = 0; i < params.size(); i++)
+                    params[i].name = route->names[i];
+                return Match<T>{&*route->value, route->pattern, params};
+            }
+
+            return {};
+        }
+
+        /// @brief Number of nodes in the table
+        [[nodiscard]] auto size() const noexcept -> std::size_t { return nodes_.size(); }
+
+    private:
+        /// @brief Find the route for a path, backtracking from static to param to catch-all
+        /// @param index Index of the node whose label has already been consumed
+        /// @param path Remaining path to match
+        /// @param params Parameters captured so far
+        /// @return Source* Matched route, nullptr if no route matched
+        [[nodiscard]] auto find(std::uint32_t index, std::string_view path, Params &params) const noexcept -> Source * {
+            const auto &node = nodes_[index];
+
+            if (path.empty()) {
+                if (node.route) return node.route;
+            } else {
+                // Static children first, scanning the contiguous first bytes
+                const auto first = std::string_view(firsts_).substr(node.children, node.statics);
+                if (const auto i = first.find(path[0]); i != std::string_view::npos) {
+                    const auto child = node.children + static_cast<std::uint32_t>(i);
+                    const auto label = std::string_view(labels_).substr(nodes_[child].prefix, nodes_[child].length);
+                    if (path.starts_with(label))
+                        if (auto found = find(child, path.substr(label.size()), params))
+                            return found;
+                }
+
+                // Then a parameter capturing one segment
+                if (node.param && path[0] != '/') {
+                    const auto end = path.find('/');
+                    params.push_back(path.substr(0, end));
+                    if (auto found = find(node.children + node.statics, end == std::string_view::npos ? std::string_view{} : path.substr(end), params))
+                        return found;
+                    params.pop_back();
+                }
+            }
+
+            // Finally a catch-all capturing the rest of the path
+            if (node.wildcard) {
+                if (auto *route = nodes_[node.children + node.statics + node.param].route) {
+                    params.push_back(path);
+                    return route;
+                }
+            }
+
+            return nullptr;
+        }
+
+        std::vector<Node> nodes_;       ///< Nodes in breadth-first order
+        std::string firsts_;            ///< First byte of each node's edge label, parallel to nodes_
+        std::string labels_;            ///< Concatenated edge labels
+        perfect_hash::Set<> static_set_;///< Perfect hash of the static route patterns
+        std::vector<Source *> statics_; ///< Static routes in the order of static_set_
+    };
+
+}// namespace harbour::router
@@ -0,0 +1,90 @@
+///  _  _             _
+/// | || | __ _  _ _ | |__  ___  _  _  _ _   A Web Server Framework For Modern C++
+/// | __ |/ _` || '_|| '_ \/ _ \| || || '_|  https://github.com/griefzz/harbour
+/// |_||_|\__,_||_|  |_.__/\___/ \_,_||_|    License: MIT
+///
+/// @file methods.hpp
+/// @brief Contains the implementation of harbours per-method route handlers
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../http/method.hpp"
+
+namespace harbour::router {
+
+    /// @class Methods
+    /// @brief Handlers of a single route, one slot per http::Method.
+    ///        Handlers docked with a Method constraint take their Methods' slots, a handler
+    ///        docked without a constraint serves every Method that has no handler of its own.
+    ///        HEAD falls back to the GET handler before the unconstrained one.
+    ///        Dispatch is one array index and the Allow header is kept precomputed.
+    /// @tparam T The type of handler stored on the route.
+    template<typename T>
+    class Methods {
+    public:
+        /// @brief Insert a handler, replacing the handlers of the Methods it covers
+        /// @param method Optional Method constraint of the handler, every Method if empty
+        /// @param value Handler to insert
+        auto insert(std::optional<http::MethodConstraint> method, T &&value) -> void {
+            handlers_.push_back(std::make_unique<T>(std::forward<T>(value)));
+            auto *handler = handlers_.back().get();
+
+            if (!method)
+                any_ = handler;
+            else
+                for (std::size_t i = 0; i < http::MethodCount; i++)
+                    if (*method & (1 << i)) slots_[i] = handler;
+
+            update();
+        }
+
+        /// @brief Find the handler for a Method
+        /// @param m Method of the Request
+        /// @return T* Handler of the Method, nullptr if the Method isnt allowed
+        [[nodiscard]] auto find(http::Method m) const noexcept -> T * {
+            return dispatch_[http::detail::index(m)];
+        }
+
+        /// @brief Get the value of the Allow header for the route, OPTIONS is always allowed
+        /// @return std::string_view Allowed Methods, for example "GET, POST, OPTIONS"
+        [[nodiscard]] auto allow() const noexcept -> std::string_view { return allow_; }
+
+    private:
+        /// @brief Rebuild the dispatch table and Allow header, dropping handlers that were replaced
+        auto update() -> void {
+            allow_.clear();
+            const auto get = slots_[http::detail::index(http::Method::GET)];
+            for (std::size_t i = 0; i < http::MethodCount; i++) {
+                const auto m = static_cast<http::Method>(1 << i);
+                dispatch_[i] = slots_[i] ? slots_[i] : any_;
+
+                // HEAD is answered like GET unless it has a handler of its own, the server leaves out the body
+                if (m == http::Method::HEAD && !slots_[i] && get) dispatch_[i] = get;
+
+                if (dispatch_[i] || m == http::Method::OPTIONS) {
+                    if (!allow_.empty()) allow_ += ", ";
+                    allow_ += http::detail::to_string(m);
+                }
+            }
+
+            std::erase_if(handlers_, [&](const auto &handler) {
+                return handler.get() != any_ && std::find(slots_.begin(), slots_.end(), handler.get()) == slots_.end();
+            });
+        }
+
+        std::vector<std::unique_ptr<T>> handlers_;     ///< Handlers owned by the route
+        std::array<T *, http::MethodCount> slots_{};   ///< Handlers docked with a Method constraint
+        std::array<T *, http::MethodCount> dispatch_{};///< Handler serving each Method
+        T *any_{nullptr};                              ///< Handler docked without a Method constraint
+        std::string allow_;                            ///< Precomputed Allow header
+    };
+
+}// namespace harbour::router
@@ -0,0 +1,67 @@
+///  _  _             _
+/// | || | __ _  _ _ | |__  ___  _  _  _ _   A Web Server Framework For Modern C++
+/// | __ |/ _` || '_|| '_ \/ _ \| || || '_|  https://github.com/griefzz/harbour
+/// |_||_|\__,_||_|  |_.__/\___/ \_,_||_|    License: MIT
+///
+/// @file params.hpp
+/// @brief Contains the implementation of harbours route parameters
+
+#pragma once
+
+#include <array>
+#include <optional>
+#include <string_view>
+
+/// @brief Maximum number of named parameters a single route can hold
+#ifndef HARBOUR_MAX_ROUTE_PARAMS
+    #define HARBOUR_MAX_ROUTE_PARAMS 8
+#endif
+
+namespace harbour::router {
+
+    /// @brief Single named route parameter
+    struct Param {
+        std::string_view name; ///< Name of the parameter in the route (':id' → 'id')
+        std::string_view value;///< Value of the parameter as a view into Request::path
+    };
+
+    /// @brief Fixed capacity list of route parameters filled by a route match without allocating
+    class Params {
+    public:
+        /// @brief Maximum number of parameters
+        static constexpr std::size_t Capacity = HARBOUR_MAX_ROUTE_PARAMS;
+
+        /// @brief Append a parameter value to the list
+        /// @param value Value to append
+        /// @return bool True if the value was added, false if the list is full
+        constexpr auto push_back(std::string_view value) noexcept -> bool {
+            if (size_ == Capacity) return false;
+            params_[size_++] = {{}, value};
+            return true;
+        }
+
+        /// @brief Remove the last parameter
+        constexpr auto pop_back() noexcept -> void { size_--; }
+
+        /// @brief Find the value of a parameter by name
+        /// @param name Name of the parameter
+        /// @return std::optional<std::string_view> Value of the parameter, empty if not found
+        [[nodiscard]] constexpr auto get(std::string_view name) const noexcept -> std::optional<std::string_view> {
+            for (std::size_t i = 0; i < size_; i++)
+                if (params_[i].name == name) return params_[i].value;
+            return {};
+        }
+
+        [[nodiscard]] constexpr auto operator[](std::size_t i) noexcept -> Param & { return params_[i]; }
+        [[nodiscard]] constexpr auto operator[](std::size_t i) const noexcept -> const Param & { return params_[i]; }
+        [[nodiscard]] constexpr auto begin() const noexcept { return params_.begin(); }
+        [[nodiscard]] constexpr auto end() const noexcept { return params_.begin() + size_; }
+        [[nodiscard]] constexpr auto size() const noexcept -> std::size_t { return size_; }
+        [[nodiscard]] constexpr auto empty() const noexcept -> bool { return size_ == 0; }
+
+    private:
+        std::array<Param, Capacity> params_{};///< Parameter storage
+        std::size_t size_{0};                 ///< Number of parameters
+    };
+
+}// namespace harbour::router
@@ -0,0 +1,258 @@
+///  _  _             _
+/// | || | __ _  _ _ | |__  ___  _  _  _ _   A Web Server Framework For Modern C++
+/// | __ |/ _` || '_|| '_ \/ _ \| || || '_|  https://github.com/griefzz/harbour
+/// |_||_|\__,_||_|  |_.__/\___/ \_,_||_|    License: MIT
+///
+/// @file radix.hpp
+/// @brief Contains the implementation of harbours compressed radix tree router
+
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "params.hpp"
+
+namespace harbour::router {
+
+    namespace detail {
+
+        /// @brief Normalize a request path so '/foo/' and '/foo' match the same route
+        /// @param path Path to normalize
+        /// @return std::string_view Path without a trailing '/', or "/" for the root
+        [[nodiscard]] constexpr auto trim(std::string_view path) noexcept -> std::string_view {
+            if (path.size() > 1 && path.back() == '/') path.remove_suffix(1);
+            if (path.empty()) return "/";
+            return path;
+        }
+
+        /// @brief Check that a route pattern is well formed
+        /// @param route Route pattern to check, for example '/users/:id/posts/*rest'
+        /// @return const char* Description of the problem, nullptr if the route is well formed
+        [[nodiscard]] constexpr auto validate(std::string_view route) noexcept -> const char * {
+            route              = trim(route);
+            std::size_t params = 0;
+            for (std::size_t i = 0; i < route.size(); i++) {
+                if (route[i] != ':' && route[i] != '*') continue;
+
+                const auto end = route.find('/', i);
+                if (i != 0 && route[i - 1] != '/') return "Route parameters must start a path segment";
+                if (i + 1 == route.size() || end == i + 1) return "Route parameters must be named";
+                if (route[i] == '*' && end != std::string_view::npos) return "Catch-all parameters must end a route";
+                if (++params > Params::Capacity) return "Too many route parameters";
+
+                // Skip the parameter name
+                i = end == std::string_view::npos ? route.size() : end;
+            }
+
+            return nullptr;
+        }
+
+        /// @brief Length of the common prefix of two strings
+        [[nodiscard]] constexpr auto common_prefix(std::string_view a, std::string_view b) noexcept -> std::size_t {
+            std::size_t i = 0;
+            while (i < a.size() && i < b.size() && a[i] == b[i]) i++;
+            return i;
+        }
+
+    }// namespace detail
+
+    /// @brief Result of a route match
+    /// @tparam T Type of the data stored on the route
+    template<typename T>
+    struct Match {
+        T *value;                ///< Data stored on the matched route
+        std::string_view pattern;///< Route pattern that matched, for example '/users/:id'
+        Params params;           ///< Named parameters captured from the path
+    };
+
+    /// @class Router
+    /// @brief Compressed radix tree router.
+    ///        Static text is stored as compressed edge labels, ':name' captures a single
+    ///        path segment and '*name' captures the rest of the path. Static segments are
+    ///        always preferred over parameters, and parameters over catch-alls.
+    /// @tparam T The type of data stored on each route.
+    template<typename T>
+    class Router {
+    public:
+        /// @brief Node of the radix tree
+        struct Node {
+            std::string prefix;                         ///< Compressed static edge label
+            std::vector<std::unique_ptr<Node>> children;///< Static children
+            std::string indices;                        ///< First byte of each static child
+            std::unique_ptr<Node> param;                ///< ':name' child capturing one segment
+            std::unique_ptr<Node> wildcard;             ///< '*name' child capturing the rest of the path
+            std::optional<T> value;                     ///< Data stored on a route ending at this node
+            std::string pattern;                        ///< Route pattern ending at this node
+            std::vector<std::string> names;             ///< Parameter names of the route in order
+        };
+
+        /// @brief Inserts a route into the Router, replacing the data of an existing route.
+        /// @param route Route pattern to insert, for example '/users/:id/posts/*rest'
+        /// @param value The value to insert.
+        /// @throws std::invalid_argument if the route pattern is malformed or names its parameters differently than an existing route
+        auto insert(std::string_view route, T &&value) -> void {
+            node(route)->value = std::forward<T>(value);
+        }
+
+        /// @brief Get the data stored on a route, inserting a default value if the route doesnt exist yet.
+        /// @param route Route pattern to find or insert, for example '/users/:id/posts/*rest'
+        /// @return T& Data stored on the route
+        /// @throws std::invalid_argument if the route pattern is malformed or names its parameters differently than an existing route
+        auto emplace(std::string_view route) -> T & {
+            auto *n = node(route);
+            if (!n->value) n->value.emplace();
+            return *n->value;
+        }
+
+        /// @brief Matches a path against the Router without allocating.
+        /// @param path The path to match, parameters are returned as views into it
+        /// @return std::optional<Match<T>> The matched route, std::nullopt if no route matched
+        [[nodiscard]] auto match(std::string_view path) noexcept -> std::optional<Match<T>> {
+            Params params;
+            if (auto node = find(&root_, detail::trim(path), params)) {
+                for (std::size_t i = 0; i < params.size(); i++)
+                    params[i].name = node->names[i];
+                return Match<T>{&*node->value, node->pattern, params};
+            }
+
+            return {};
+        }
+
+        /// @brief Get the root node of the Router
+        /// @return const Node& Root node
+        [[nodiscard]] auto root() const noexcept -> const Node & { return root_; }
+
+        /// @brief Get the root node of the Router
+        /// @return Node& Root node
+        [[nodiscard]] auto root() noexcept -> Node & { return root_; }
+
+    private:
+        /// @brief Find or create the node at the end of a route pattern
+        /// @param route Route pattern to walk
+        /// @return Node* Node at the end of the route
+        /// @throws std::invalid_argument if the route pattern is malformed or names its parameters differently than an existing route
+        auto node(std::string_view route) -> Node * {
+            std::string pattern(route);
+            if (!pattern.starts_with('/')) pattern.insert(pattern.begin(), '/');
+            const auto cleaned = detail::trim(pattern);
+            if (auto error = detail::validate(cleaned))
+                throw std::invalid_argument(std::string(error) + ": " + pattern);
+
+            Node *node = &root_;
+            std::vector<std::string> names;
+            std::string_view rest = cleaned;
+
+            while (!rest.empty()) {
+                const auto special = rest.find_first_of(":*");
+                node               = insert_static(node, rest.substr(0, special));
+                if (special == std::string_view::npos) break;
+
+                rest            = rest.substr(special);
+                const auto end  = rest.find('/');
+                const auto name = rest.substr(1, end == std::string_view::npos ? std::string_view::npos : end - 1);
+
+                names.emplace_back(name);
+                auto &child = rest[0] == '*' ? node->wildcard : node->param;
+                if (!child) child = std::make_unique<Node>();
+                node = child.get();
+                rest = end == std::string_view::npos ? std::string_view{} : rest.substr(end);
+            }
+
+            // Matches are named by the node, so every route ending here must use the same names
+            if (!node->pattern.empty() && node->names != names)
+                throw std::invalid_argument("Route parameters are named differently than " + node->pattern + ": " + pattern);
+
+            node->pattern = cleaned;
+            node->names   = std::move(names);
+            return node;
+        }
+
+        /// @brief Insert static text below a node, splitting edges as needed
+        /// @param node Node to insert below
+        /// @param text Static text to insert
+        /// @return Node* Node at the end of the inserted text
+        auto insert_static(Node *node, std::string_view text) -> Node * {
+            while (!text.empty()) {
+                const auto i = node->indices.find(text[0]);
+                if (i == std::string::npos) {
+                    auto child    = std::make_unique<Node>();
+                    child->prefix = text;
+                    auto *next    = child.get();
+                    add_child(node, std::move(child));
+                    return next;
+                }
+
+                auto &child         = node->children[i];
+                const auto matching = detail::common_prefix(child->prefix, text);
+
+                // Split the edge if the label only partially matches
+                if (matching < child->prefix.size()) {
+                    auto split    = std::make_unique<Node>();
+                    split->prefix = child->prefix.substr(0, matching);
+                    child->prefix.erase(0, matching);
+                    split->indices.push_back(child->prefix[0]);
+                    split->children.push_back(std::move(child));
+                    child = std::move(split);
+                }
+
+                node = child.get();
+                text = text.substr(matching);
+            }
+
+            return node;
+        }
+
+        /// @brief Add a static child to a node keeping children sorted by their first byte
+        auto add_child(Node *node, std::unique_ptr<Node> child) -> void {
+            std::size_t i = 0;
+            while (i < node->indices.size() && node->indices[i] < child->prefix[0]) i++;
+            node->indices.insert(node->indices.begin() + i, child->prefix[0]);
+            node->children.insert(node->children.begin() + i, std::move(child));
+        }
+
+        /// @brief Recursively find the node for a path, backtracking from static to param to catch-all
+        /// @param node Node whose prefix has already been consumed
+        /// @param path Remaining path to match
+        /// @param params Parameters captured so far
+        /// @return Node* Matched node, nullptr if no route matched
+        [[nodiscard]] auto find(Node *node, std::string_view path, Params &params) noexcept -> Node * {
+            if (path.empty()) {
+                if (node->value) return node;
+            } else {
+                // Static children first
+                if (const auto i = node->indices.find(path[0]); i != std::string::npos) {
+                    auto *child = node->children[i].get();
+                    if (path.starts_with(child->prefix))
+                        if (auto found = find(child, path.substr(child->prefix.size()), params))
+                            return found;
+                }
+
+                // Then a parameter capturing one segment
+                if (node->param && path[0] != '/') {
+                    const auto end = path.find('/');
+                    params.push_back(path.substr(0, end));
+                    if (auto found = find(node->param.get(), end == std::string_view::npos ? std::string_view{} : path.substr(end), params))
+                        return found;
+                    params.pop_back();
+                }
+            }
+
+            // Finally a catch-all capturing the rest of the path
+            if (node->wildcard && node->wildcard->value) {
+                params.push_back(path);
+                return node->wildcard.get();
+            }
+
+            return nullptr;
+        }
+
+        Node root_;///< Root node of the Router
+    };
+
+}// namespace harbour::router
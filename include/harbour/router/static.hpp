@@ -0,0 +1,66 @@
+///  _  _             _
+/// | || | __ _  _ _ | |__  ___  _  _  _ _   A Web Server Framework For Modern C++
+/// | __ |/ _` || '_|| '_ \/ _ \| || || '_|  https://github.com/griefzz/harbour
+/// |_||_|\__,_||_|  |_.__/\___/ \_,_||_|    License: MIT
+///
+/// @file static.hpp
+/// @brief Contains the implementation of harbours compile-time static route table
+
+#pragma once
+
+#include <array>
+#include <optional>
+#include <string_view>
+
+#include "radix.hpp"
+#include "../fixed_string.hpp"
+#include "../perfect_hash.hpp"
+
+namespace harbour::router {
+
+    namespace detail {
+
+        /// @brief Check if a route has no named parameters or catch-alls
+        [[nodiscard]] constexpr auto is_static(std::string_view route) noexcept -> bool {
+            return route.find_first_of(":*") == std::string_view::npos;
+        }
+
+    }// namespace detail
+
+    /// @class StaticTable
+    /// @brief Route table of static paths resolved through a minimal perfect hash built at compile time.
+    ///        Dispatching a path costs a single hash and compare.
+    /// @tparam Routes Static routes of the table, for example StaticTable<"/", "/health", "/api/v1/users">
+    template<FixedString... Routes>
+    class StaticTable {
+        static_assert(((Routes.view().starts_with('/') && detail::is_static(Routes.view())) && ...),
+                      "StaticTable routes must start with '/' and have no parameters");
+
+    public:
+        /// @brief Number of routes in the table
+        static constexpr std::size_t size = sizeof...(Routes);
+
+        /// @brief Normalized routes in declaration order
+        static constexpr std::array<std::string_view, size> routes{detail::trim(Routes.view())...};
+
+        /// @brief Find the index of the route matching a path
+        /// @param path Path to match, a trailing '/' is ignored
+        /// @return std::optional<std::size_t> Index of the route in declaration order, empty if no route matched
+        [[nodiscard]] static constexpr auto find(std::string_view path) noexcept -> std::optional<std::size_t> {
+            return set_.find(detail::trim(path));
+        }
+
+        /// @brief Get the index of a route at compile time
+        /// @tparam Route Route to find, must be part of the table
+        /// @return std::size_t Index of the route in declaration order
+        template<FixedString Route>
+        [[nodiscard]] static consteval auto index() -> std::size_t {
+            if (auto i = find(Route.view())) return *i;
+            throw "Route is not part of the StaticTable";
+        }
+
+    private:
+        static constexpr perfect_hash::FixedSet<size> set_{routes};///< Perfect hash of the routes
+    };
+
+}// namespace harbour::router
@@ -8,12 +8,25 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
 #include <cstdio>
+#include <fstream>
+#include <stdexcept>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <memory>
 #include <functional>
 #include <array>
+#include <chrono>
+
+#if defined(__linux__)
+    #include <fcntl.h>
+    #include <sys/sendfile.h>
+    #include <unistd.h>
+#endif
 
 #include <asio.hpp>
 #include <asio/ssl/impl/src.hpp>
@@ -22,7 +35,10 @@
 #include "socket.hpp"
 #include "../response/response.hpp"
 #include "../request/request.hpp"
+#include "../request/framing.hpp"
+#include "../http/fields.hpp"
 #include "../ship.hpp"
+#include "../memory.hpp"
 #include "../log/log.hpp"
 
 #if defined(ASIO_ENABLE_HANDLER_TRACKING)
@@ -134,18 +150,57 @@ namespace harbour::server {
                     co_await settings_.on_connection(ctx);
                 }
 
+                // Every Record of this connection shares the peer captured at accept
+                log::access::Record record;
+                if (settings_.access_log) record.set_peer(ctx->endpoint());
+
+                // The read buffer and the Arena are reused by every Request on this connection
+                memory::Arena arena;
                 std::string data;
                 data.reserve(settings_.buffering_size);
+                std::size_t consumed = 0;
+
+                // Serve Requests until the client closes the connection or asks us to
+                for (bool served = false;; served = true) {
+                    // The previous Request and Response are gone, free everything they allocated at once.
+                    // Bytes after the previous Request are the start of the next pipelined one and are kept.
+                    data.erase(0, consumed);
+                    arena.reset();
+
+                    // Read until a whole Request is buffered, its head and body may span many reads
+                    std::size_t length = 0;
+                    auto framing       = request::frame(data, length);
+                    while (framing == request::Framing::Partial && data.size() < settings_.max_size) {
+                        auto buffer      = asio::dynamic_string_buffer(data, settings_.max_size);
+                        auto [ec, bytes] = co_await ctx->async_read(buffer, asio::as_tuple(use_awaitable));
+                        if (ec == asio::error::eof && served && data.empty()) co_return;
+                        if (ec) throw asio::system_error(ec);
+                        framing = request::frame(data, length);
+                    }
+                    if (framing != request::Framing::Complete) {
+                        co_await handle_failed_request(ctx, data);
+                        break;
+                    }
+                    consumed = length;
+
+                    auto request = Request::create(ctx, data.data(), length, arena.allocator());
+                    if (!request) {
+                        co_await handle_failed_request(ctx, std::string_view(data).substr(0, length));
+                        break;
+                    }
+
+                    const auto started = std::chrono::steady_clock::now();
+                    Response response(arena.allocator());
+                    co_await handle_ships_(*request, response);
 
-                auto buffer = asio::dynamic_string_buffer(data, settings_.max_size);
-                co_await ctx->async_read(buffer, use_awaitable);
+                    // Tell the client when this is the last Response on the connection,
+                    // Streams sent to HTTP/1.0 clients end when the connection closes
+                    const auto open    = keep_alive(*request) && (request->version >= 1 || !response.data.stream());
+                    const auto written = co_await write_response(ctx, response, open, request->method != http::Method::HEAD, request->version);
 
-                if (auto request = Request::create(ctx, data.c_str(), data.size())) {
-                    Response response;
-                    co_await handle_ships_(*request, response);
-                    co_await ctx->async_write(response.string(), use_awaitable);
-                } else {
-                    co_await handle_failed_request(ctx, data);
+                    if (settings_.access_log) record_access(record, *request, response, written, started);
+
+                    if (!open) break;
                 }
             } catch (const asio::system_error &se) {
                 asio_exception = se;
@@ -160,12 +215,176 @@ namespace harbour::server {
             }
         }
 
+        /// @brief Write a Response without copying its body.
+        ///        In-memory bodies are written together with the head in a single gather write,
+        ///        File bodies are streamed from disk after the head, multipart bodies are written part by part,
+        ///        Stream bodies are generated and sent in chunks, or unframed to HTTP/1.0 clients, and pre-serialized
+        ///        Responses are written as-is.
+        /// @param ctx Socket to write to
+        /// @param response Response to write
+        /// @param keep_alive Whether the connection stays open after the Response
+        /// @param body Whether to write the body, Responses to HEAD only write the head
+        /// @param version Minor HTTP version of the Request
+        /// @return std::uint64_t Bytes written, head included
+        auto write_response(const SharedSocket &ctx, const Response &response, bool keep_alive, bool body,
+                            std::uint8_t version = 1) -> awaitable<std::uint64_t> {
+            if (response.serialized) {
+                std::string closing;
+                if (!keep_alive) closing = response.string(false);
+                auto out = keep_alive ? std::string_view(*response.serialized) : std::string_view(closing);
+                if (!body) out = out.substr(0, out.find("\n\n") + 2);
+                co_return co_await ctx->async_write_buffers(asio::buffer(out), use_awaitable);
+            }
+
+            // The head describes the full body even when the body isnt sent
+            const auto head = response.head(keep_alive, version);
+            if (!body) co_return co_await ctx->async_write(head, use_awaitable);
+
+            std::uint64_t written = 0;
+            if (const auto *file = response.data.file()) {
+                written += co_await ctx->async_write(head, use_awaitable);
+                co_await write_file(ctx, *file);
+                written += file->length;
+            } else if (const auto *stream = response.data.stream()) {
+                written += co_await ctx->async_write(head, use_awaitable);
+                written += co_await write_stream(ctx, *stream, version >= 1);
+            } else if (const auto *parts = response.data.parts()) {
+                written += co_await ctx->async_write(head, use_awaitable);
+                for (const auto &part: *parts) {
+                    if (const auto *f = std::get_if<response::File>(&part)) {
+                        co_await write_file(ctx, *f);
+                        written += f->length;
+                    } else {
+                        written += co_await ctx->async_write(std::get<std::string>(part), use_awaitable);
+                    }
+                }
+            } else {
+                const std::array<asio::const_buffer, 2> buffers{asio::buffer(head), asio::buffer(response.data.view())};
+                written += co_await ctx->async_write_buffers(buffers, use_awaitable);
+            }
+            co_return written;
+        }
+
+        /// @brief Queue an access Record for a served Request if its route is sampled
+        /// @param record Record holding the connection's peer, reused between Requests
+        /// @param req Request that was served
+        /// @param resp Response that was written
+        /// @param written Bytes of the Response written
+        /// @param started When the Request was handed to the Ships
+        auto record_access(log::access::Record &record, const Request &req, const Response &resp,
+                           std::uint64_t written, std::chrono::steady_clock::time_point started) -> void {
+            using namespace std::chrono;
+            if (!settings_.access_log->sample(req.pattern)) return;
+
+            const auto latency = duration_cast<microseconds>(steady_clock::now() - started);
+            record.timestamp   = static_cast<std::uint64_t>(duration_cast<microseconds>(system_clock::now().time_since_epoch() - latency).count());
+            record.latency     = static_cast<std::uint32_t>(std::min<std::int64_t>(latency.count(), UINT32_MAX));
+            record.bytes       = written;
+            record.status      = static_cast<std::uint16_t>(resp.status);
+            record.method      = req.method;
+            record.set_route(req.pattern.empty() ? req.path : req.pattern);
+            settings_.access_log->record(record);
+        }
+
+        /// @brief Stream a file region to a socket.
+        ///        Plain TCP sockets on Linux hand the file to the kernel with sendfile,
+        ///        everything else reads the file in chunks into a single buffer.
+        /// @param ctx Socket to write to
+        /// @param file File region to write
+        /// @throws std::runtime_error if the file can't be read, the head has already promised its length
+        auto write_file(const SharedSocket &ctx, const response::File &file) -> awaitable<void> {
+#if defined(__linux__)
+            if (auto *sock = std::get_if<TcpSocket>(&ctx->socket())) {
+                struct Descriptor {
+                    int fd;
+                    ~Descriptor() { if (fd >= 0) ::close(fd); }
+                } const in{::open(file.path.c_str(), O_RDONLY | O_CLOEXEC)};
+                if (in.fd < 0) throw std::runtime_error(fmt::format("Failed to open {}", file.path.string()));
+
+                sock->native_non_blocking(true);
+                auto offset    = static_cast<off_t>(file.offset);
+                auto remaining = file.length;
+                while (remaining) {
+                    const auto n = ::sendfile(sock->native_handle(), in.fd, &offset, static_cast<std::size_t>(remaining));
+                    if (n > 0) {
+                        remaining -= static_cast<std::uint64_t>(n);
+                    } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                        co_await sock->async_wait(tcp::socket::wait_write, use_awaitable);
+                    } else if (n < 0 && errno == EINTR) {
+                        continue;
+                    } else {
+                        throw std::runtime_error(fmt::format("Failed to send {}", file.path.string()));
+                    }
+                }
+                co_return;
+            }
+#endif
+            std::ifstream in(file.path, std::ios::binary);
+            if (!in || !in.seekg(static_cast<std::streamoff>(file.offset)))
+                throw std::runtime_error(fmt::format("Failed to open {}", file.path.string()));
+
+            std::string chunk(static_cast<std::size_t>(std::min<std::uint64_t>(file.length, settings_.buffering_size)), '\0');
+            for (auto remaining = file.length; remaining;) {
+                const auto n = static_cast<std::size_t>(std::min<std::uint64_t>(remaining, chunk.size()));
+                if (!in.read(chunk.data(), static_cast<std::streamsize>(n)))
+                    throw std::runtime_error(fmt::format("Failed to read {}", file.path.string()));
+                co_await ctx->async_write(std::string_view(chunk.data(), n), use_awaitable);
+                remaining -= n;
+            }
+        }
+
+        /// @brief Send a Stream with chunked transfer encoding.
+        ///        Each chunk is generated into a single buffer of about buffering_size bytes and written before
+        ///        the next one is generated, so a body of any size costs one buffer per connection.
+        /// @param ctx Socket to write to
+        /// @param stream Stream generating the body
+        /// @param chunked Whether to frame chunks, unframed Streams are ended by closing the connection
+        /// @return std::uint64_t Bytes written, chunk framing included
+        auto write_stream(const SharedSocket &ctx, const response::Stream &stream, bool chunked) -> awaitable<std::uint64_t> {
+            std::uint64_t written = 0;
+            std::string chunk;
+            chunk.reserve(settings_.buffering_size);
+            for (bool more = static_cast<bool>(stream.next); more;) {
+                chunk.clear();
+                more = stream.next(chunk, settings_.buffering_size);
+                if (chunk.empty()) continue;
+
+                if (!chunked) {
+                    written += co_await ctx->async_write(std::string_view(chunk), use_awaitable);
+                    continue;
+                }
+
+                const auto size = fmt::format("{:x}\r\n", chunk.size());
+                const std::array<asio::const_buffer, 3> buffers{asio::buffer(size), asio::buffer(chunk), asio::buffer("\r\n", 2)};
+                written += co_await ctx->async_write_buffers(buffers, use_awaitable);
+            }
+            if (chunked) written += co_await ctx->async_write_buffers(asio::buffer("0\r\n\r\n", 5), use_awaitable);
+            co_return written;
+        }
+
+        /// @brief Check if a connection should stay open after a Request.
+        ///        HTTP/1.1 connections stay open unless the client sends 'Connection: close',
+        ///        HTTP/1.0 connections close unless the client sends 'Connection: keep-alive'.
+        /// @param req Request that was served
+        /// @return bool True if the connection stays open
+        [[nodiscard]] static auto keep_alive(const Request &req) -> bool {
+            bool close = false, open = false;
+            if (const auto connection = req.header("Connection")) {
+                http::fields::for_each(*connection, [&](std::string_view token) {
+                    close = close || http::fields::iequals(token, "close");
+                    open  = open || http::fields::iequals(token, "keep-alive");
+                });
+            }
+            if (close) return false;
+            return req.version >= 1 || open;
+        }
+
         // New helper methods to break down the connection handling
-        auto handle_failed_request(const SharedSocket &ctx, const std::string &data) -> awaitable<void> {
+        auto handle_failed_request(const SharedSocket &ctx, std::string_view data) -> awaitable<void> {
             if (settings_.on_warning) {
                 co_await settings_.on_warning(ctx, fmt::format("Failed to parse request:\n{}", data));
             }
-            co_await ctx->async_write(Response(http::Status::BadRequest).string(), use_awaitable);
+            co_await ctx->async_write(Response(http::Status::BadRequest).string(false), use_awaitable);
         }
 
         auto handle_connection_error(const SharedSocket &ctx, const asio::system_error &se) -> awaitable<void> {
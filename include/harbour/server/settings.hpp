@@ -13,6 +13,7 @@
 #include <optional>
 
 #include "../log/callbacks.hpp"
+#include "../log/access.hpp"
 
 namespace harbour::server {
 
@@ -38,6 +39,8 @@ namespace harbour::server {
         log::callbacks::Warning on_warning{log::callbacks::on_warning};         ///< Callback for a server warning
         log::callbacks::Critical on_critical{log::callbacks::on_critical};      ///< Callback for a server critical
 
+        log::access::SharedLog access_log;///< Optional access log recording every Request served
+
         /// @brief Create a Settings with the default values
         /// @return Default Settings structure
         [[nodiscard]] static auto defaults() noexcept -> Settings {
@@ -144,6 +147,23 @@ namespace harbour::server {
             this->on_critical = on_critical;
             return *this;
         }
+
+        /// @brief Record every Request served in a structured access log
+        /// @param settings Settings of the access log
+        /// @return Settings& Reference to Settings for chaining
+        /// @throws std::system_error if the access log file can't be opened
+        auto with_access_log(log::access::Settings settings) -> Settings & {
+            this->access_log = std::make_shared<log::access::Log>(std::move(settings));
+            return *this;
+        }
+
+        /// @brief Record every Request served in an access log shared with other Settings
+        /// @param access_log Access log to use. If nullptr, no access log is written.
+        /// @return Settings& Reference to Settings for chaining
+        auto with_access_log(log::access::SharedLog access_log) noexcept -> Settings & {
+            this->access_log = std::move(access_log);
+            return *this;
+        }
     };
 
 }// namespace harbour::server
\ No newline at end of file
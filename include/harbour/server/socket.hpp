@@ -8,15 +8,25 @@
 
 #pragma once
 
+#include <array>
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <type_traits>
 #include <variant>
 #include <concepts>
 
+#if !defined(_WIN32)
+    #include <arpa/inet.h>
+#endif
+
 #include <asio.hpp>
 #include <asio/ssl/impl/src.hpp>
 #include <asio/ssl.hpp>
 
+#include <fmt/base.h>
+#include <fmt/format.h>
+
 namespace harbour::server {
 
     using asio::awaitable;
@@ -30,14 +40,28 @@ namespace harbour::server {
     using TcpSocket = tcp::socket;
     using SslSocket = ssl::stream<TcpSocket>;
 
+    /// @brief Text of an IP address formatted into an inline buffer
+    struct Address {
+        std::array<char, 64> data{};///< Formatted address, large enough for an IPv6 address with a scope id
+        std::uint8_t size{0};       ///< Bytes of data used
+
+        /// @brief Get the address as a string_view, only valid while the Address is alive
+        [[nodiscard]] auto view() const noexcept -> std::string_view { return {data.data(), size}; }
+
+        [[nodiscard]] operator std::string_view() const noexcept { return view(); }
+        [[nodiscard]] operator std::string() const { return std::string(view()); }
+
+        [[nodiscard]] auto operator==(std::string_view other) const noexcept -> bool { return view() == other; }
+    };
+
     /// @brief A structure representing a socket, which can be either a plain TCP socket or an SSL socket.
     class Socket final : public std::enable_shared_from_this<Socket> {
     public:
         // Constructor for TCP socket
-        explicit Socket(tcp::socket &&socket) noexcept : socket_(std::move(socket)) {}
+        explicit Socket(tcp::socket &&socket) noexcept : socket_(std::move(socket)) { remember_peer(); }
 
         // Constructor for SSL stream
-        explicit Socket(ssl::stream<TcpSocket> &&socket) noexcept : socket_(std::move(socket)) {}
+        explicit Socket(ssl::stream<TcpSocket> &&socket) noexcept : socket_(std::move(socket)) { remember_peer(); }
 
         // Delete copy operations
         Socket(const Socket &)            = delete;
@@ -47,31 +71,41 @@ namespace harbour::server {
         Socket(Socket &&) noexcept            = default;
         Socket &operator=(Socket &&) noexcept = default;
 
-        /// @brief Gets the remote address of the socket.
-        /// @return The remote address as a string.
-        [[nodiscard]] auto address() const -> std::string {
-            return std::visit([](const auto &sock) {
-                if constexpr (std::is_same_v<std::decay_t<decltype(sock)>, TcpSocket>) {
-                    return sock.remote_endpoint().address().to_string();
-                } else {
-                    return sock.lowest_layer().remote_endpoint().address().to_string();
+        /// @brief Gets the remote address of the socket, formatted without allocating.
+        /// @return The remote address, empty if the peer was unknown when the socket was accepted.
+        [[nodiscard]] auto address() const noexcept -> Address {
+            Address out;
+            if (peer_ == tcp::endpoint{}) return out;
+
+            const auto address = peer_.address();
+
+            if (address.is_v4()) {
+                const auto b      = address.to_v4().to_bytes();
+                const auto result = fmt::format_to_n(out.data.data(), out.data.size(), "{}.{}.{}.{}", b[0], b[1], b[2], b[3]);
+                out.size          = static_cast<std::uint8_t>(result.size);
+            } else {
+                const auto v6 = address.to_v6();
+                const auto b  = v6.to_bytes();
+                if (!::inet_ntop(AF_INET6, b.data(), out.data.data(), out.data.size())) return out;
+
+                // Scoped addresses keep their numeric scope id
+                auto size = std::string_view(out.data.data()).size();
+                if (v6.scope_id() != 0) {
+                    const auto result = fmt::format_to_n(out.data.data() + size, out.data.size() - size, "%{}", v6.scope_id());
+                    size += result.size;
                 }
-            },
-                              socket_);
+                out.size = static_cast<std::uint8_t>(size);
+            }
+            return out;
         }
 
         /// @brief Gets the remote port of the socket.
-        /// @return The remote port.
-        [[nodiscard]] auto port() const -> port_type {
-            return std::visit([](const auto &sock) {
-                if constexpr (std::is_same_v<std::decay_t<decltype(sock)>, TcpSocket>) {
-                    return sock.remote_endpoint().port();
-                } else {
-                    return sock.lowest_layer().remote_endpoint().port();
-                }
-            },
-                              socket_);
-        }
+        /// @return The remote port, 0 if the peer was unknown when the socket was accepted.
+        [[nodiscard]] auto port() const noexcept -> port_type { return peer_.port(); }
+
+        /// @brief Gets the remote endpoint of the socket.
+        /// @return The remote endpoint captured when the socket was accepted, or a default endpoint if it was unknown.
+        [[nodiscard]] auto endpoint() const noexcept -> const tcp::endpoint & { return peer_; }
 
         /// @brief Get the number of bytes available to read on a socket
         /// @return Number of available bytes
@@ -146,6 +180,20 @@ namespace harbour::server {
                               socket_);
         }
 
+        /// @brief Asynchronously writes a sequence of buffers to the socket with a single gather write.
+        /// @tparam ConstBufferSequence Type of the buffer sequence (std::array<asio::const_buffer, N>)
+        /// @tparam CompletionToken Completion token to use (asio::use_awaitable, asio::use_future)
+        /// @param buffers Buffers to write, they are not copied and must outlive the operation
+        /// @param token The completion token to be called when the operation completes.
+        /// @return The result of the asynchronous write operation.
+        template<typename ConstBufferSequence, asio::completion_token_for<void(std::error_code, std::size_t)> CompletionToken>
+        auto async_write_buffers(const ConstBufferSequence &buffers, CompletionToken &&token) {
+            return std::visit([&](auto &sock) {
+                return asio::async_write(sock, buffers, std::forward<CompletionToken>(token));
+            },
+                              socket_);
+        }
+
         /// @brief Writes some data to the socket.
         /// @param buffers The buffer(s) containing the data to be written.
         /// @return The number of bytes written.
@@ -164,10 +212,33 @@ namespace harbour::server {
         }
 
     private:
-        std::variant<TcpSocket, SslSocket> socket_;
+        /// @brief Look the peer up once, it can't change for the lifetime of a connection
+        auto remember_peer() noexcept -> void {
+            asio::error_code ec;
+            auto peer = std::visit([&](const auto &sock) {
+                if constexpr (std::is_same_v<std::decay_t<decltype(sock)>, TcpSocket>) {
+                    return sock.remote_endpoint(ec);
+                } else {
+                    return sock.lowest_layer().remote_endpoint(ec);
+                }
+            },
+                                   socket_);
+            if (!ec) peer_ = peer;
+        }
+
+        std::variant<TcpSocket, SslSocket> socket_;///< Underlying TCP or SSL socket
+        tcp::endpoint peer_;                       ///< Remote endpoint captured at accept, stored inline
     };
 
     /// @brief Convenience type for a std::shared_ptr<Socket>
     using SharedSocket = std::shared_ptr<Socket>;
 
-}// namespace harbour::server
\ No newline at end of file
+}// namespace harbour::server
+
+/// @brief Allow Address to be formatted using fmtlib
+template<>
+struct fmt::formatter<harbour::server::Address> : formatter<string_view> {
+    auto format(const harbour::server::Address &address, format_context &ctx) const -> format_context::iterator {
+        return formatter<string_view>::format(address.view(), ctx);
+    }
+};
\ No newline at end of file
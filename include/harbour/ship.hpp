@@ -8,10 +8,13 @@
 
 #pragma once
 
-#include <functional>
-#include <variant>
 #include <concepts>
+#include <cstddef>
+#include <memory>
+#include <new>
 #include <optional>
+#include <type_traits>
+#include <utility>
 
 #include <asio/awaitable.hpp>
 
@@ -32,77 +35,12 @@ namespace harbour::detail {
     template<typename T>
     struct is_awaitable<awaitable<T>> : std::true_type {};
 
-    /// @brief Concept to check if a type T is any of the types U.
-    /// @tparam T The type to check.
-    /// @tparam U The types to check against.
-    template<typename T, typename... U>
-    concept is_any_of = (std::same_as<T, U> || ...);
-
-    /// @brief Helper struct to overload multiple function call operators.
-    /// @tparam Ts The types of the function call operators.
-    template<class... Ts>
-    struct overloaded : Ts... {
-        using Ts::operator()...;
-    };
-
-    /// explicit deduction guide (not needed as of C++20) but AppleClang throws a fit
-    template<class... Ts>
-    overloaded(Ts...) -> overloaded<Ts...>;
-
-    /// @brief Type aliases for awaitable ship variants
-    using Ship_0  = std::function<awaitable<Response>(const Request &, Response &)>;
-    using Ship_1  = std::function<awaitable<Response>(Response &, const Request &)>;
-    using Ship_2  = std::function<awaitable<std::optional<Response>>(const Request &, Response &)>;
-    using Ship_3  = std::function<awaitable<std::optional<Response>>(Response &, const Request &)>;
-    using Ship_4  = std::function<awaitable<void>(const Request &, Response &)>;
-    using Ship_5  = std::function<awaitable<void>(Response &, const Request &)>;
-    using Ship_6  = std::function<awaitable<Response>(const Request &)>;
-    using Ship_7  = std::function<awaitable<Response>(Response &)>;
-    using Ship_8  = std::function<awaitable<std::optional<Response>>(const Request &)>;
-    using Ship_9  = std::function<awaitable<std::optional<Response>>(Response &)>;
-    using Ship_10 = std::function<awaitable<void>(const Request &)>;
-    using Ship_11 = std::function<awaitable<void>(Response &)>;
-    using Ship_12 = std::function<awaitable<Response>()>;
-    using Ship_13 = std::function<awaitable<std::optional<Response>>()>;
-    using Ship_14 = std::function<awaitable<void>()>;
-
-    /// @brief Type aliases for non-awaitable ship variants
-    using Ship_15 = std::function<Response(const Request &, Response &)>;
-    using Ship_16 = std::function<Response(Response &, const Request &)>;
-    using Ship_17 = std::function<std::optional<Response>(const Request &, Response &)>;
-    using Ship_18 = std::function<std::optional<Response>(Response &, const Request &)>;
-    using Ship_19 = std::function<void(const Request &, Response &)>;
-    using Ship_20 = std::function<void(Response &, const Request &)>;
-    using Ship_21 = std::function<Response(const Request &)>;
-    using Ship_22 = std::function<Response(Response &)>;
-    using Ship_23 = std::function<std::optional<Response>(const Request &)>;
-    using Ship_24 = std::function<std::optional<Response>(Response &)>;
-    using Ship_25 = std::function<void(const Request &)>;
-    using Ship_26 = std::function<void(Response &)>;
-    using Ship_27 = std::function<Response()>;
-    using Ship_28 = std::function<std::optional<Response>()>;
-    using Ship_29 = std::function<void()>;
-
-    /// @brief Main ship variant used
-    using Ship = std::variant<Ship_0, Ship_1, Ship_2, Ship_3, Ship_4,
-                              Ship_5, Ship_6, Ship_7, Ship_8, Ship_9,
-                              Ship_10, Ship_11, Ship_12, Ship_13, Ship_14,
-                              Ship_15, Ship_16, Ship_17, Ship_18,
-                              Ship_19, Ship_20, Ship_21, Ship_22,
-                              Ship_23, Ship_24, Ship_25, Ship_26,
-                              Ship_27, Ship_28, Ship_29>;
+    class Ship;
 
     /// @brief Concept to check if a type T is a ship.
     /// @tparam T The type to check.
     template<typename T>
-    concept is_ship = is_any_of<std::remove_cvref_t<std::remove_pointer_t<std::decay_t<T>>>,
-                                Ship_0, Ship_1, Ship_2, Ship_3, Ship_4,
-                                Ship_5, Ship_6, Ship_7, Ship_8, Ship_9,
-                                Ship_10, Ship_11, Ship_12, Ship_13, Ship_14,
-                                Ship_15, Ship_16, Ship_17, Ship_18,
-                                Ship_19, Ship_20, Ship_21, Ship_22,
-                                Ship_23, Ship_24, Ship_25, Ship_26,
-                                Ship_27, Ship_28, Ship_29>;
+    concept is_ship = std::same_as<std::remove_cvref_t<T>, Ship>;
 
     /// @brief Concept to check if a type T satisfies the ShipConcept.
     /// @tparam T The type to check.
@@ -140,87 +78,244 @@ namespace harbour::detail {
              std::is_invocable_r_v<std::optional<Response>, T> ||
              std::is_invocable_r_v<void, T>);
 
-    /// @brief Creates a Ship from a given ShipConcept.
-    /// @tparam S The type of the ship concept.
-    /// @param s The ship concept instance.
-    /// @return A Ship variant.
-    constexpr auto make_ship(ShipConcept auto &&s) {
-        using S = decltype(s);
-        using T = std::decay_t<S>;
-
-        // clang-format off
-        /// Awaitable ship variants
-        if constexpr (is_ship<T>) return Ship{s};
-        else if constexpr (std::is_invocable_r_v<awaitable<Response>, S, const Request &, Response &>)                return Ship{Ship_0{s}};
-        else if constexpr (std::is_invocable_r_v<awaitable<Response>, S, Response &, const Request &>)                return Ship{Ship_1{s}};
-        else if constexpr (std::is_invocable_r_v<awaitable<std::optional<Response>>, S, const Request &, Response &>) return Ship{Ship_2{s}};
-        else if constexpr (std::is_invocable_r_v<awaitable<std::optional<Response>>, S, Response &, const Request &>) return Ship{Ship_3{s}};
-        else if constexpr (std::is_invocable_r_v<awaitable<void>, S, const Request &, Response &>)                    return Ship{Ship_4{s}};
-        else if constexpr (std::is_invocable_r_v<awaitable<void>, S, Response &, const Request &>)                    return Ship{Ship_5{s}};
-        else if constexpr (std::is_invocable_r_v<awaitable<Response>, S, const Request &>)                            return Ship{Ship_6{s}};
-        else if constexpr (std::is_invocable_r_v<awaitable<Response>, S, Response &>)                                 return Ship{Ship_7{s}};
-        else if constexpr (std::is_invocable_r_v<awaitable<std::optional<Response>>, S, const Request &>)             return Ship{Ship_8{s}};
-        else if constexpr (std::is_invocable_r_v<awaitable<std::optional<Response>>, S, Response &>)                  return Ship{Ship_9{s}};
-        else if constexpr (std::is_invocable_r_v<awaitable<void>, S, const Request &>)                                return Ship{Ship_10{s}};
-        else if constexpr (std::is_invocable_r_v<awaitable<void>, S, Response &>)                                     return Ship{Ship_11{s}};
-        else if constexpr (std::is_invocable_r_v<awaitable<Response>, S>)                                             return Ship{Ship_12{s}};
-        else if constexpr (std::is_invocable_r_v<awaitable<std::optional<Response>>, S>)                              return Ship{Ship_13{s}};
-        else if constexpr (std::is_invocable_r_v<awaitable<void>, S>)                                                 return Ship{Ship_14{s}};
-        
-        /// Non-awaitable ship variants
-        else if constexpr (std::is_invocable_r_v<Response, S, const Request &, Response &>)                           return Ship{Ship_15{s}};
-        else if constexpr (std::is_invocable_r_v<Response, S, Response &, const Request &>)                           return Ship{Ship_16{s}};
-        else if constexpr (std::is_invocable_r_v<std::optional<Response>, S, const Request &, Response &>)            return Ship{Ship_17{s}};
-        else if constexpr (std::is_invocable_r_v<std::optional<Response>, S, Response &, const Request &>)            return Ship{Ship_18{s}};
-        else if constexpr (std::is_invocable_r_v<void, S, const Request &, Response &>)                               return Ship{Ship_19{s}};
-        else if constexpr (std::is_invocable_r_v<void, S, Response &, const Request &>)                               return Ship{Ship_20{s}};
-        else if constexpr (std::is_invocable_r_v<Response, S, const Request &>)                                       return Ship{Ship_21{s}};
-        else if constexpr (std::is_invocable_r_v<Response, S, Response &>)                                            return Ship{Ship_22{s}};
-        else if constexpr (std::is_invocable_r_v<std::optional<Response>, S, const Request &>)                        return Ship{Ship_23{s}};
-        else if constexpr (std::is_invocable_r_v<std::optional<Response>, S, Response &>)                             return Ship{Ship_24{s}};
-        else if constexpr (std::is_invocable_r_v<void, S, const Request &>)                                           return Ship{Ship_25{s}};
-        else if constexpr (std::is_invocable_r_v<void, S, Response &>)                                                return Ship{Ship_26{s}};
-        else if constexpr (std::is_invocable_r_v<Response, S>)                                                        return Ship{Ship_27{s}};
-        else if constexpr (std::is_invocable_r_v<std::optional<Response>, S>)                                         return Ship{Ship_28{s}};
-        else if constexpr (std::is_invocable_r_v<void, S>)                                                            return Ship{Ship_29{s}};
-        // clang-format on
+    /// @brief Call a Ship callable with the arguments it accepts, in the order it accepts them
+    /// @param f Callable to invoke
+    /// @param req Request passed to the callable
+    /// @param resp Response passed to the callable
+    /// @return Whatever the callable returns
+    // clang-format off
+    constexpr decltype(auto) invoke_ship(auto &f, const Request &req, Response &resp) {
+        if      constexpr (requires { f(req, resp); }) return f(req, resp);
+        else if constexpr (requires { f(resp, req); }) return f(resp, req);
+        else if constexpr (requires { f(req); })       return f(req);
+        else if constexpr (requires { f(resp); })      return f(resp);
+        else                                           return f();
+    }
+    // clang-format on
+
+    /// @brief Return type of a Ship callable
+    template<typename F>
+    using ship_result_t = decltype(invoke_ship(std::declval<F &>(), std::declval<const Request &>(), std::declval<Response &>()));
+
+    /// @brief Result of a Ship that writes its Response in place, such as a Pipeline
+    struct Handled {
+        bool value;///< True if the Ship produced a Response
+    };
+
+    /// @brief Store a Ship result into the Response
+    /// @tparam R Type returned by the Ship, either void, Handled, Response, std::optional<Response> or convertible to Response
+    /// @param result Result returned by the Ship
+    /// @param resp Response to move the result into
+    /// @return bool True if the Ship produced a Response
+    template<typename R>
+    auto store_result(R &&result, Response &resp) -> bool {
+        if constexpr (std::same_as<std::remove_cvref_t<R>, Handled>) {
+            return result.value;
+        } else if constexpr (std::convertible_to<R, Response>) {
+            resp = std::forward<R>(result);
+            return true;
+        } else if constexpr (std::convertible_to<R, std::optional<Response>>) {
+            std::optional<Response> r = std::forward<R>(result);
+            if (!r) return false;
+            resp = std::move(*r);
+            return true;
+        } else {
+            return false;
+        }
+    }
+
+    /// @brief Call a synchronous Ship callable and store its result
+    /// @param f Callable to invoke
+    /// @param req Request passed to the callable
+    /// @param resp Response passed to the callable, receives the Response it produced
+    /// @return bool True if the callable produced a Response
+    auto call_ship(auto &f, const Request &req, Response &resp) -> bool {
+        if constexpr (std::is_void_v<decltype(invoke_ship(f, req, resp))>) {
+            invoke_ship(f, req, resp);
+            return false;
+        } else {
+            return store_result(invoke_ship(f, req, resp), resp);
+        }
     }
 
-    /// @brief Handler for processing a Request and Response using a Ship.
-    constexpr auto ShipHandler = [](const Request &req, Response &resp, auto &&ship) -> awaitable<std::optional<Response>> {
-        auto handle = [&](auto &&s, auto &&...args) -> awaitable<std::optional<Response>> {
-            using ReturnType = decltype(s(args...));
-
-            if constexpr (is_awaitable<ReturnType>::value) {
-                if constexpr (std::is_same_v<awaitable<void>, decltype(s(args...))>) {
-                    co_await s(args...);
-                    co_return std::nullopt;
-                } else {
-                    co_return co_await s(args...);
-                }
+    /// @class Ship
+    /// @brief Type-erased Ship normalized to a single calling convention.
+    ///        Every Ship is called with a Request and a Response and reports whether it produced
+    ///        a Response, which is moved into the Response it was given. Synchronous Ships are
+    ///        called directly without a coroutine frame, awaitable Ships through async_call.
+    ///        Callables up to BufferSize bytes are stored inline without allocating.
+    ///        Move-only callables are shared by every copy of their Ship.
+    class Ship {
+        /// @brief Operations for a stored callable
+        struct VTable {
+            bool (*call)(void *, const Request &, Response &);                 ///< Synchronous call, nullptr for awaitable Ships
+            awaitable<bool> (*async_call)(void *, const Request &, Response &);///< Awaitable call, nullptr for synchronous Ships
+            void (*copy)(void *, const void *);                                ///< Copy construct into uninitialized storage
+            void (*move)(void *, void *) noexcept;                             ///< Move construct into uninitialized storage
+            void (*destroy)(void *) noexcept;                                  ///< Destroy the stored callable
+        };
+
+    public:
+        /// @brief Size of the inline buffer for small callables
+        static constexpr std::size_t BufferSize = 4 * sizeof(void *);
+
+        /// @brief Construct a Ship from any ShipConcept callable
+        /// @param f Callable to store
+        template<typename F>
+            requires(!is_ship<F> && ShipConcept<F>)
+        Ship(F &&f) {
+            using T = std::decay_t<F>;
+            if constexpr (std::is_copy_constructible_v<T>)
+                emplace<T>(std::forward<F>(f));
+            else
+                emplace<shared_t<T>>(shared(std::make_shared<T>(std::forward<F>(f))));
+        }
+
+        Ship(const Ship &other) : vtable_(other.vtable_) { vtable_->copy(buffer_, other.buffer_); }
+        Ship(Ship &&other) noexcept : vtable_(other.vtable_) { vtable_->move(buffer_, other.buffer_); }
+
+        auto operator=(const Ship &other) -> Ship & {
+            if (this != &other) {
+                Ship copy(other);
+                *this = std::move(copy);
+            }
+            return *this;
+        }
+
+        auto operator=(Ship &&other) noexcept -> Ship & {
+            if (this != &other) {
+                vtable_->destroy(buffer_);
+                vtable_ = other.vtable_;
+                vtable_->move(buffer_, other.buffer_);
+            }
+            return *this;
+        }
+
+        ~Ship() { vtable_->destroy(buffer_); }
+
+        /// @brief Check if the Ship has to be awaited
+        [[nodiscard]] auto is_async() const noexcept -> bool { return vtable_->async_call != nullptr; }
+
+        /// @brief Call a synchronous Ship
+        /// @param req Request to handle
+        /// @param resp Response to handle, receives the Response produced by the Ship
+        /// @return bool True if the Ship produced a Response
+        auto operator()(const Request &req, Response &resp) const -> bool {
+            return vtable_->call(const_cast<std::byte *>(buffer_), req, resp);
+        }
+
+        /// @brief Call an awaitable Ship
+        /// @param req Request to handle
+        /// @param resp Response to handle, receives the Response produced by the Ship
+        /// @return awaitable<bool> True if the Ship produced a Response
+        auto async_call(const Request &req, Response &resp) const -> awaitable<bool> {
+            return vtable_->async_call(const_cast<std::byte *>(buffer_), req, resp);
+        }
+
+    private:
+        /// @brief Store a copyable callable
+        /// @tparam T Type of the callable
+        /// @param f Callable to store
+        template<typename T>
+        auto emplace(auto &&f) -> void {
+            vtable_ = &table<T>;
+            if constexpr (inline_storage<T>)
+                ::new (static_cast<void *>(buffer_)) T(std::forward<decltype(f)>(f));
+            else
+                ::new (static_cast<void *>(buffer_)) T *(new T(std::forward<decltype(f)>(f)));
+        }
+
+        /// @brief Wrap a move-only callable in a copyable one sharing it
+        /// @param p Callable to share
+        /// @return Callable forwarding to the shared callable
+        template<typename T>
+        static auto shared(std::shared_ptr<T> p) {
+            return [p = std::move(p)](const Request &req, Response &resp) -> ship_result_t<T> {
+                return invoke_ship(*p, req, resp);
+            };
+        }
+
+        /// @brief Type of the callable sharing a move-only callable
+        template<typename T>
+        using shared_t = decltype(shared(std::declval<std::shared_ptr<T>>()));
+
+        /// @brief Check if a callable can be stored in the inline buffer
+        template<typename T>
+        static constexpr bool inline_storage = sizeof(T) <= BufferSize &&
+                                               alignof(std::max_align_t) % alignof(T) == 0 &&
+                                               std::is_nothrow_move_constructible_v<T>;
+
+        /// @brief Get the callable stored in a buffer
+        template<typename T>
+        static auto object(void *p) noexcept -> T & {
+            if constexpr (inline_storage<T>)
+                return *std::launder(static_cast<T *>(p));
+            else
+                return **std::launder(static_cast<T **>(p));
+        }
+
+        /// @brief Check if a callable returns an awaitable
+        template<typename T>
+        static constexpr bool awaitable_ship = is_awaitable<ship_result_t<T>>::value;
+
+        /// @brief Synchronous call of a stored callable
+        template<typename T>
+        static auto call_sync(void *p, const Request &req, Response &resp) -> bool {
+            return call_ship(object<T>(p), req, resp);
+        }
+
+        /// @brief Awaitable call of a stored callable
+        template<typename T>
+        static auto call_async(void *p, const Request &req, Response &resp) -> awaitable<bool> {
+            auto &f = object<T>(p);
+            if constexpr (std::is_same_v<ship_result_t<T>, awaitable<void>>) {
+                co_await invoke_ship(f, req, resp);
+                co_return false;
             } else {
-                if constexpr (std::is_same_v<void, decltype(s(args...))>) {
-                    s(args...);
-                    co_return std::nullopt;
-                } else {
-                    auto ret = s(args...);
-                    co_return ret;
-                }
+                co_return store_result(co_await invoke_ship(f, req, resp), resp);
             }
-        };
+        }
 
-        // clang-format off
-        auto ol = detail::overloaded{
-                [&](auto &s) -> awaitable<std::optional<Response>> {
-                    if      constexpr (requires { s(req, resp); }) co_return co_await handle(s, req, resp);
-                    else if constexpr (requires { s(resp, req); }) co_return co_await handle(s, resp, req);
-                    else if constexpr (requires { s(req); })       co_return co_await handle(s, req);
-                    else if constexpr (requires { s(resp); })      co_return co_await handle(s, resp);
-                    else                                           co_return co_await handle(s);
+        /// @brief Operations for a callable type
+        template<typename T>
+        static constexpr VTable table{
+                [] {
+                    if constexpr (awaitable_ship<T>) return static_cast<decltype(VTable::call)>(nullptr);
+                    else return &call_sync<T>;
+                }(),
+                [] {
+                    if constexpr (awaitable_ship<T>) return &call_async<T>;
+                    else return static_cast<decltype(VTable::async_call)>(nullptr);
+                }(),
+                [](void *dst, const void *src) {
+                    if constexpr (inline_storage<T>)
+                        ::new (dst) T(*std::launder(static_cast<const T *>(src)));
+                    else
+                        ::new (dst) T *(new T(**std::launder(static_cast<T *const *>(src))));
+                },
+                [](void *dst, void *src) noexcept {
+                    if constexpr (inline_storage<T>)
+                        ::new (dst) T(std::move(*std::launder(static_cast<T *>(src))));
+                    else
+                        ::new (dst) T *(std::exchange(*std::launder(static_cast<T **>(src)), nullptr));
+                },
+                [](void *p) noexcept {
+                    if constexpr (inline_storage<T>)
+                        std::launder(static_cast<T *>(p))->~T();
+                    else
+                        delete *std::launder(static_cast<T **>(p));
                 }};
-        // clang-format on
 
-        co_return co_await std::visit(ol, ship);
+        const VTable *vtable_;                                  ///< Operations for the stored callable
+        alignas(std::max_align_t) std::byte buffer_[BufferSize];///< Inline storage or a pointer to the callable
     };
 
-}// namespace harbour::detail
\ No newline at end of file
+    /// @brief Creates a Ship from a given ShipConcept.
+    /// @tparam S The type of the ship concept.
+    /// @param s The ship concept instance.
+    /// @return A normalized Ship.
+    auto make_ship(ShipConcept auto &&s) -> Ship {
+        return Ship(std::forward<decltype(s)>(s));
+    }
+
+}// namespace harbour::detail
@@ -12,9 +12,13 @@
 #include <string>
 #include <iterator>
 #include <filesystem>
+#include <optional>
 
 #include <asio.hpp>
 
+#include "pool.hpp"
+#include "tmpl/engine.hpp"
+
 #include <fmt/core.h>
 #include <fmt/format.h>
 
@@ -38,15 +42,17 @@ namespace harbour::tmpl {
 
     namespace detail {
 
-        /// @brief load file with callback used in load_file_async
+        /// @brief load file with callback used in load_file_async, the file is read on the blocking pool
         template<typename Callback>
         void load_file_impl(const std::string_view path, Callback cb) {
-            std::thread(
-                    [path, cb = std::move(cb)]() mutable {
-                        auto data = load_file(path);
+            pool::blocking().post(
+                    [path = std::string(path), cb = std::move(cb)]() mutable {
+                        std::optional<std::string> data;
+                        try {
+                            data = load_file(path);
+                        } catch (...) {}
                         std::move(cb)(std::move(data));
-                    })
-                    .detach();
+                    });
         }
 
     }// namespace detail
@@ -103,15 +109,17 @@ namespace harbour::tmpl {
     }
 
     namespace detail {
-        /// @brief render a file with callback used in render_file_async
+        /// @brief render a file with callback used in render_file_async, the file is rendered on the blocking pool
         template<typename Callback>
         void render_file_impl(Callback cb, const std::string_view path, const auto &...args) {
-            std::thread(
-                    [path, cb = std::move(cb), args...]() mutable {
-                        auto data = render_file(path, args...);
+            pool::blocking().post(
+                    [path = std::string(path), cb = std::move(cb), args...]() mutable {
+                        std::optional<std::string> data;
+                        try {
+                            data = render_file(path, args...);
+                        } catch (...) {}
                         std::move(cb)(std::move(data));
-                    })
-                    .detach();
+                    });
         }
 
     }// namespace detail
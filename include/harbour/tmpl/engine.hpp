@@ -0,0 +1,481 @@
+///  _  _             _
+/// | || | __ _  _ _ | |__  ___  _  _  _ _   A Web Server Framework For Modern C++
+/// | __ |/ _` || '_|| '_ \/ _ \| || || '_|  https://github.com/griefzz/harbour
+/// |_||_|\__,_||_|  |_.__/\___/ \_,_||_|    License: MIT
+///
+/// @file engine.hpp
+/// @brief Contains the implementation of harbours precompiled template engine
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include <ankerl/unordered_dense.h>
+#include <fmt/format.h>
+
+#include "../memory.hpp"
+#include "../response/body.hpp"
+
+namespace harbour::tmpl {
+
+    class Value;
+
+    /// @brief List of Values, rendered by a section once per item
+    using List = std::vector<Value>;
+
+    /// @brief Named Values in insertion order, looked up by a linear scan since templates use few names
+    using Object = std::vector<std::pair<std::string, Value>>;
+
+    /// @class Value
+    /// @brief Data rendered by a Template: nothing, a bool, an integer, a float, a string, a List or an Object
+    class Value {
+    public:
+        Value() = default;
+        Value(bool b) : data_(b) {}
+        Value(std::integral auto n)
+            requires(!std::same_as<decltype(n), bool>)
+            : data_(static_cast<std::int64_t>(n)) {}
+        Value(std::floating_point auto n) : data_(static_cast<double>(n)) {}
+        Value(const char *s) : data_(std::string(s)) {}
+        Value(std::string_view s) : data_(std::string(s)) {}
+        Value(std::string s) : data_(std::move(s)) {}
+        Value(List list) : data_(std::move(list)) {}
+        Value(Object object) : data_(std::move(object)) {}
+
+        /// @brief Get a member of an Object
+        /// @param key Name of the member
+        /// @return const Value* Member, nullptr if it's missing or the Value isn't an Object
+        [[nodiscard]] auto find(std::string_view key) const noexcept -> const Value * {
+            if (const auto *object = std::get_if<Object>(&data_))
+                for (const auto &[name, value]: *object)
+                    if (name == key) return &value;
+            return nullptr;
+        }
+
+        /// @brief Get the Value as a List
+        [[nodiscard]] auto list() const noexcept -> const List * { return std::get_if<List>(&data_); }
+
+        /// @brief Check if a section over the Value renders.
+        ///        Nothing, false, zero, empty strings and empty Lists don't.
+        [[nodiscard]] auto truthy() const noexcept -> bool {
+            return std::visit([](const auto &v) -> bool {
+                using T = std::decay_t<decltype(v)>;
+                if constexpr (std::same_as<T, std::monostate>) return false;
+                else if constexpr (std::same_as<T, bool>) return v;
+                else if constexpr (std::same_as<T, std::int64_t> || std::same_as<T, double>) return v != 0;
+                else if constexpr (std::same_as<T, Object>) return true;
+                else return !v.empty();
+            }, data_);
+        }
+
+        /// @brief Append the Value as text, Lists and Objects append nothing
+        /// @param out Buffer to append to
+        /// @param escape Escape HTML special characters in strings
+        auto append(std::string &out, bool escape) const -> void {
+            std::visit([&](const auto &v) {
+                using T = std::decay_t<decltype(v)>;
+                if constexpr (std::same_as<T, bool>) out += v ? "true" : "false";
+                else if constexpr (std::same_as<T, std::int64_t> || std::same_as<T, double>) fmt::format_to(std::back_inserter(out), "{}", v);
+                else if constexpr (std::same_as<T, std::string>) escape ? append_escaped(out, v) : void(out += v);
+            }, data_);
+        }
+
+        /// @brief Append a string with the HTML special characters &<>"' escaped.
+        ///        Runs without special characters are copied in bulk.
+        static auto append_escaped(std::string &out, std::string_view s) -> void {
+            std::size_t start = 0;
+            for (std::size_t i = 0; i < s.size(); i++) {
+                std::string_view entity;
+                switch (s[i]) {
+                    case '&': entity = "&amp;"; break;
+                    case '<': entity = "&lt;"; break;
+                    case '>': entity = "&gt;"; break;
+                    case '"': entity = "&quot;"; break;
+                    case '\'': entity = "&#39;"; break;
+                    default: continue;
+                }
+                out.append(s.substr(start, i - start));
+                out.append(entity);
+                start = i + 1;
+            }
+            out.append(s.substr(start));
+        }
+
+    private:
+        std::variant<std::monostate, bool, std::int64_t, double, std::string, List, Object> data_;
+    };
+
+    /// @class Template
+    /// @brief Template compiled once into a flat list of segments and rendered any number of times.
+    ///
+    ///        - {{name}} renders a Value with HTML escaping, {{{name}}} and {{&name}} render it raw
+    ///        - {{#name}}...{{/name}} renders once per item of a List, or once if the Value is truthy
+    ///        - {{^name}}...{{/name}} renders if the Value is missing, falsy or an empty List
+    ///        - {{!comment}} renders nothing
+    ///
+    ///        Names may be dotted, user.name, and {{.}} is the current item. A name is looked up in the
+    ///        innermost section first, then in every enclosing one.
+    class Template {
+    public:
+        /// @brief Compile a template
+        /// @param source Template text
+        /// @throws std::invalid_argument if a tag is unterminated, empty or a section isn't closed
+        explicit Template(std::string_view source) { compile(source); }
+
+        /// @brief Render the Template, appending to a buffer so it can be reused between renders
+        /// @param data Values of the template's names
+        /// @param out Buffer to append to
+        auto render(const Value &data, std::string &out) const -> void {
+            out.reserve(out.size() + literal_size_);
+            render(0, segments_.size(), Scope{&data, nullptr}, out);
+        }
+
+        /// @brief Render the Template into a new string
+        /// @param data Values of the template's names
+        /// @return std::string Rendered text
+        [[nodiscard]] auto render(const Value &data) const -> std::string {
+            std::string out;
+            render(data, out);
+            return out;
+        }
+
+        /// @brief Get the number of compiled segments
+        [[nodiscard]] auto size() const noexcept -> std::size_t { return segments_.size(); }
+
+        /// @brief Resumable rendering of a Template, see Template::Renderer
+        class Renderer;
+
+    private:
+        /// @brief Kind of a compiled segment
+        enum class Kind : std::uint8_t {
+            Literal, ///< Text copied as is
+            Escaped, ///< Value rendered with HTML escaping
+            Raw,     ///< Value rendered as is
+            Section, ///< Segments rendered per item or if the Value is truthy
+            Inverted,///< Segments rendered if the Value is falsy
+        };
+
+        /// @brief Compiled piece of a template
+        struct Segment {
+            Kind kind;                    ///< What the segment renders
+            std::string text;             ///< Literal text, or the name of the Value
+            std::vector<std::string> path;///< Name split on '.', empty for the current item
+            std::size_t end{0};           ///< Index after the last segment of a section
+        };
+
+        /// @brief Values of the sections being rendered, innermost first
+        struct Scope {
+            const Value *value; ///< Value of this section
+            const Scope *parent;///< Enclosing section, nullptr at the top
+        };
+
+        /// @brief Split a template into segments and match sections to their closing tags
+        auto compile(std::string_view source) -> void {
+            std::vector<std::size_t> open;
+            std::size_t pos = 0;
+            while (pos < source.size()) {
+                const auto start = source.find("{{", pos);
+                if (start != pos) literal(source.substr(pos, start == std::string_view::npos ? std::string_view::npos : start - pos));
+                if (start == std::string_view::npos) break;
+
+                // Triple braces render raw
+                const bool triple  = source.substr(start, 3) == "{{{";
+                const auto closing = triple ? std::string_view("}}}") : std::string_view("}}");
+                const auto inner   = start + (triple ? 3 : 2);
+                const auto end     = source.find(closing, inner);
+                if (end == std::string_view::npos)
+                    throw std::invalid_argument("Unterminated template tag at offset " + std::to_string(start));
+                pos = end + closing.size();
+
+                auto tag   = trim(source.substr(inner, end - inner));
+                auto kind  = triple ? Kind::Raw : Kind::Escaped;
+                char sigil = triple || tag.empty() ? '\0' : tag.front();
+                if (sigil == '!') continue;
+                if (sigil == '#' || sigil == '^' || sigil == '/' || sigil == '&') tag = trim(tag.substr(1));
+                if (tag.empty()) throw std::invalid_argument("Empty template tag at offset " + std::to_string(start));
+
+                if (sigil == '/') {
+                    if (open.empty() || segments_[open.back()].text != tag)
+                        throw std::invalid_argument("Unexpected closing tag {{/" + std::string(tag) + "}}");
+                    segments_[open.back()].end = segments_.size();
+                    open.pop_back();
+                    continue;
+                }
+
+                if (sigil == '#') kind = Kind::Section;
+                if (sigil == '^') kind = Kind::Inverted;
+                if (sigil == '&') kind = Kind::Raw;
+                if (kind == Kind::Section || kind == Kind::Inverted) {
+                    open.push_back(segments_.size());
+                    depth_ = std::max(depth_, open.size());
+                }
+                segments_.push_back({kind, std::string(tag), split(tag)});
+            }
+
+            if (!open.empty())
+                throw std::invalid_argument("Unclosed template section {{#" + segments_[open.back()].text + "}}");
+        }
+
+        /// @brief Add literal text, merging it into a preceding literal
+        auto literal(std::string_view text) -> void {
+            literal_size_ += text.size();
+            if (!segments_.empty() && segments_.back().kind == Kind::Literal)
+                segments_.back().text += text;
+            else
+                segments_.push_back({Kind::Literal, std::string(text), {}});
+        }
+
+        /// @brief Trim spaces around a tag
+        [[nodiscard]] static auto trim(std::string_view s) noexcept -> std::string_view {
+            while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) s.remove_prefix(1);
+            while (!s.empty() && (s.back() == ' ' || s.back() == '\t')) s.remove_suffix(1);
+            return s;
+        }
+
+        /// @brief Split a dotted name into its parts, "." is the current item
+        [[nodiscard]] static auto split(std::string_view name) -> std::vector<std::string> {
+            std::vector<std::string> path;
+            if (name == ".") return path;
+            for (std::size_t pos = 0;;) {
+                const auto dot = name.find('.', pos);
+                path.emplace_back(name.substr(pos, dot == std::string_view::npos ? std::string_view::npos : dot - pos));
+                if (dot == std::string_view::npos) break;
+                pos = dot + 1;
+            }
+            return path;
+        }
+
+        /// @brief Find the Value of a name, searching the innermost section first
+        [[nodiscard]] static auto lookup(const Segment &segment, const Scope &scope) noexcept -> const Value * {
+            if (segment.path.empty()) return scope.value;
+
+            const Value *value = nullptr;
+            for (const auto *s = &scope; s && !value; s = s->parent)
+                value = s->value->find(segment.path.front());
+            for (std::size_t i = 1; value && i < segment.path.size(); i++)
+                value = value->find(segment.path[i]);
+            return value;
+        }
+
+        /// @brief Render the segments in [first, last)
+        auto render(std::size_t first, std::size_t last, const Scope &scope, std::string &out) const -> void {
+            for (auto i = first; i < last;) {
+                const auto &segment = segments_[i];
+                switch (segment.kind) {
+                    case Kind::Literal:
+                        out += segment.text;
+                        break;
+                    case Kind::Escaped:
+                    case Kind::Raw:
+                        if (const auto *value = lookup(segment, scope)) value->append(out, segment.kind == Kind::Escaped);
+                        break;
+                    case Kind::Section:
+                        if (const auto *value = lookup(segment, scope)) {
+                            if (const auto *list = value->list()) {
+                                for (const auto &item: *list) render(i + 1, segment.end, Scope{&item, &scope}, out);
+                            } else if (value->truthy()) {
+                                render(i + 1, segment.end, Scope{value, &scope}, out);
+                            }
+                        }
+                        i = segment.end;
+                        continue;
+                    case Kind::Inverted:
+                        if (const auto *value = lookup(segment, scope); !value || !value->truthy())
+                            render(i + 1, segment.end, scope, out);
+                        i = segment.end;
+                        continue;
+                }
+                i++;
+            }
+        }
+
+        std::vector<Segment> segments_;///< Compiled segments, each section is followed by its contents
+        std::size_t literal_size_{0}; ///< Bytes of literal text, reserved before rendering
+        std::size_t depth_{0};        ///< Deepest nesting of sections
+    };
+
+    /// @class Template::Renderer
+    /// @brief Renders a Template a piece at a time, pausing whenever the output reaches a limit.
+    ///        Rendering state lives in a stack of sections instead of on the call stack so it can be resumed,
+    ///        and literals are split at the limit so the output never grows much past it.
+    ///        The Template and Value must outlive the Renderer.
+    class Template::Renderer {
+    public:
+        /// @brief Start rendering a Template
+        /// @param compiled Template to render
+        /// @param data Values of the template's names
+        Renderer(const Template &compiled, const Value &data) : compiled_(&compiled) {
+            // Reserve the deepest nesting so the Scopes pointing into frames_ stay put
+            frames_.reserve(compiled.depth_ + 1);
+            frames_.push_back({Scope{&data, nullptr}, 0, 0, compiled.segments_.size(), nullptr, 0});
+        }
+
+        /// @brief Render until the buffer holds at least limit bytes or the Template is done
+        /// @param out Buffer to append to
+        /// @param limit Size of out to stop at
+        /// @return bool True if there is more to render
+        auto next(std::string &out, std::size_t limit) -> bool {
+            while (!frames_.empty()) {
+                if (out.size() >= limit) return true;
+
+                auto &frame = frames_.back();
+                if (frame.pos == frame.end) {
+                    // Loop over the next item of a List, or leave the section
+                    if (frame.list && ++frame.item < frame.list->size()) {
+                        frame.scope.value = &(*frame.list)[frame.item];
+                        frame.pos         = frame.begin;
+                    } else {
+                        frames_.pop_back();
+                    }
+                    continue;
+                }
+
+                const auto &segment = compiled_->segments_[frame.pos];
+                switch (segment.kind) {
+                    case Kind::Literal: {
+                        const auto n = std::min(segment.text.size() - offset_, limit - out.size());
+                        out.append(segment.text, offset_, n);
+                        offset_ += n;
+                        if (offset_ == segment.text.size()) {
+                            offset_ = 0;
+                            frame.pos++;
+                        }
+                        break;
+                    }
+                    case Kind::Escaped:
+                    case Kind::Raw:
+                        if (const auto *value = lookup(segment, frame.scope)) value->append(out, segment.kind == Kind::Escaped);
+                        frame.pos++;
+                        break;
+                    case Kind::Section: {
+                        const auto begin = frame.pos + 1;
+                        frame.pos        = segment.end;
+                        if (const auto *value = lookup(segment, frame.scope)) {
+                            if (const auto *list = value->list()) {
+                                if (!list->empty()) frames_.push_back({Scope{&list->front(), &frame.scope}, begin, begin, segment.end, list, 0});
+                            } else if (value->truthy()) {
+                                frames_.push_back({Scope{value, &frame.scope}, begin, begin, segment.end, nullptr, 0});
+                            }
+                        }
+                        break;
+                    }
+                    case Kind::Inverted: {
+                        const auto begin = frame.pos + 1;
+                        frame.pos        = segment.end;
+                        if (const auto *value = lookup(segment, frame.scope); !value || !value->truthy())
+                            frames_.push_back({frame.scope, begin, begin, segment.end, nullptr, 0});
+                        break;
+                    }
+                }
+            }
+            return false;
+        }
+
+    private:
+        /// @brief Section being rendered
+        struct Frame {
+            Scope scope;        ///< Value of the section and its enclosing sections
+            std::size_t begin;  ///< First segment of the section
+            std::size_t pos;    ///< Next segment to render
+            std::size_t end;    ///< Index after the last segment of the section
+            const List *list;   ///< List being looped over, nullptr if the section renders once
+            std::size_t item;   ///< Index of the current item of list
+        };
+
+        const Template *compiled_;  ///< Template being rendered
+        std::vector<Frame> frames_; ///< Sections being rendered, innermost last
+        std::size_t offset_{0};     ///< Bytes of the current literal already rendered
+    };
+
+    /// @brief Render a Template into a Response body while the Response is written, a chunk at a time
+    /// @param compiled Template to render
+    /// @param data Values of the template's names
+    /// @return response::Stream Stream rendering the Template
+    [[nodiscard]] inline auto stream(std::shared_ptr<const Template> compiled, Value data) -> response::Stream {
+        // The Renderer borrows the Template and Value, keep them together for as long as the Stream lives
+        struct State {
+            State(std::shared_ptr<const Template> t, Value v)
+                : compiled(std::move(t)), data(std::move(v)), renderer(*compiled, data) {}
+
+            std::shared_ptr<const Template> compiled;
+            Value data;
+            Template::Renderer renderer;
+        };
+
+        auto state = std::make_shared<State>(std::move(compiled), std::move(data));
+        return {[state = std::move(state)](std::string &out, std::size_t limit) { return state->renderer.next(out, limit); }};
+    }
+
+    /// @class Cache
+    /// @brief Compiled Templates by path. A file is compiled on first use and again only when
+    ///        its modification time changes, so a hit costs a single stat.
+    class Cache {
+    public:
+        /// @brief Get the compiled Template of a file
+        /// @param path Path of the template file
+        /// @return std::shared_ptr<const Template> Compiled Template, empty if the file can't be read
+        /// @throws std::invalid_argument if the template is malformed
+        [[nodiscard]] auto get(const std::filesystem::path &path) -> std::shared_ptr<const Template> {
+            std::error_code ec;
+            const auto modified = std::filesystem::last_write_time(path, ec);
+            if (ec) return {};
+
+            const auto key = path.string();
+            {
+                std::lock_guard lock(mutex_);
+                if (auto it = entries_.find(key); it != entries_.end() && it->second.modified == modified)
+                    return it->second.compiled;
+            }
+
+            // Compile outside the lock so a large template doesn't hold up hits on others
+            std::ifstream file(path, std::ios::binary);
+            if (!file) return {};
+            const std::string source((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+            auto compiled = std::make_shared<const Template>(source);
+
+            std::lock_guard lock(mutex_);
+            entries_[key] = Entry{compiled, modified};
+            return compiled;
+        }
+
+        /// @brief Forget every compiled Template
+        auto clear() -> void {
+            std::lock_guard lock(mutex_);
+            entries_.clear();
+        }
+
+    private:
+        /// @brief Compiled Template and the modification time it was compiled at
+        struct Entry {
+            std::shared_ptr<const Template> compiled;///< Compiled Template
+            std::filesystem::file_time_type modified;///< Modification time of the file
+        };
+
+        std::mutex mutex_;///< Guards entries_
+        ankerl::unordered_dense::map<std::string, Entry, memory::StringHash, memory::StringEqual> entries_;
+    };
+
+    /// @brief Get the compiled Template of a file from the shared Cache, compiling it on first use
+    /// @param path Path of the template file
+    /// @return std::shared_ptr<const Template> Compiled Template, empty if the file can't be read
+    /// @throws std::invalid_argument if the template is malformed
+    [[nodiscard]] inline auto compile_file(const std::filesystem::path &path) -> std::shared_ptr<const Template> {
+        static Cache cache;
+        return cache.get(path);
+    }
+
+}// namespace harbour::tmpl
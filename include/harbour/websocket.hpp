@@ -8,6 +8,9 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <optional>
 #include <span>
 #include <string>
@@ -51,6 +54,7 @@ namespace harbour::websocket {
 
     constexpr std::string_view WEBSOCKET_GUID = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
     constexpr std::size_t DEFAULT_BUFFER_SIZE = 8192;
+    constexpr std::uint64_t MAX_PAYLOAD_SIZE  = 16 * 1024 * 1024;
 
     /// @brief WebSocket frame opcodes
     enum class Opcode : uint8_t {
@@ -62,6 +66,144 @@ namespace harbour::websocket {
         Pong         = 0xA
     };
 
+    /// @brief Status codes sent in a Close frame
+    enum class CloseCode : uint16_t {
+        Normal        = 1000,///< The connection is done
+        ProtocolError = 1002,///< The peer sent a frame breaking RFC 6455
+        MessageTooBig = 1009 ///< The peer sent a message larger than MAX_PAYLOAD_SIZE
+    };
+
+    /// @brief A decoded WebSocket frame
+    struct Frame {
+        bool fin{true};             ///< True if this is the last frame of a message
+        Opcode opcode{Opcode::Text};///< Frame opcode
+        std::string_view payload{}; ///< Unmasked payload, points into the Decoder's buffer until its next prepare
+    };
+
+    /// @brief Result of decoding the next frame
+    enum class Parse : uint8_t {
+        Complete,///< A whole frame was decoded
+        Partial, ///< More bytes are needed, read into prepare() and try again
+        Error    ///< The frame breaks RFC 6455 or is larger than the payload limit
+    };
+
+    /// @class Decoder
+    /// @brief Buffered WebSocket frame decoder.
+    ///        Bytes are read into one buffer with a single large read and as many complete frames as it holds
+    ///        are decoded in place without further reads. A partial frame at the end of the buffer is moved to
+    ///        its front on the next prepare and the buffer grows when a single frame doesn't fit.
+    ///        Frames are decoded as a server reads them, so unmasked frames, reserved bits or opcodes and
+    ///        fragmented or oversized control frames are rejected.
+    class Decoder {
+    public:
+        /// @brief Construct a Decoder
+        /// @param capacity Initial size of the read buffer
+        /// @param max_payload Largest payload accepted in a single frame
+        explicit Decoder(std::size_t capacity = DEFAULT_BUFFER_SIZE, std::uint64_t max_payload = MAX_PAYLOAD_SIZE)
+            : buffer_(std::max<std::size_t>(capacity, 14)), max_payload_(max_payload) {}
+
+        /// @brief Decode the next buffered frame, unmasking its payload in place
+        /// @param frame Frame to fill, only valid if Parse::Complete is returned
+        /// @return Parse Whether a frame was decoded, more bytes are needed or the stream is malformed
+        [[nodiscard]] auto next(Frame &frame) noexcept -> Parse {
+            const auto *data   = reinterpret_cast<const uint8_t *>(buffer_.data() + begin_);
+            const auto size    = end_ - begin_;
+            std::size_t header = 2;
+            if (size < header) return partial(header);
+
+            const bool fin       = (data[0] & 0x80) != 0;
+            const auto opcode    = data[0] & 0x0F;
+            const bool masked    = (data[1] & 0x80) != 0;
+            uint64_t payload_len = data[1] & 0x7F;
+
+            // No extensions are negotiated and every client frame must be masked
+            if ((data[0] & 0x70) != 0 || !masked) return Parse::Error;
+
+            // Opcodes 0x3-0x7 and 0xB-0xF are reserved
+            if ((opcode > 0x2 && opcode < 0x8) || opcode > 0xA) return Parse::Error;
+
+            // Control frames can't be fragmented and carry at most 125 bytes
+            if ((opcode & 0x8) != 0 && (!fin || payload_len > 125)) return Parse::Error;
+
+            header += (payload_len == 126 ? 2 : payload_len == 127 ? 8 : 0) + 4;
+            if (size < header) return partial(header);
+
+            // Handle extended payload length
+            if (payload_len == 126) {
+                payload_len = (uint64_t{data[2]} << 8) | data[3];
+            } else if (payload_len == 127) {
+                payload_len = 0;
+                for (int i = 0; i < 8; i++)
+                    payload_len = (payload_len << 8) | data[2 + i];
+            }
+            if (payload_len > max_payload_) return Parse::Error;
+            if (size - header < payload_len) return partial(header + static_cast<std::size_t>(payload_len));
+
+            auto *payload = buffer_.data() + begin_ + header;
+            unmask(payload, static_cast<std::size_t>(payload_len), data + header - 4);
+
+            frame.fin     = fin;
+            frame.opcode  = static_cast<Opcode>(opcode);
+            frame.payload = std::string_view(payload, static_cast<std::size_t>(payload_len));
+
+            begin_ += header + static_cast<std::size_t>(payload_len);
+            need_ = 0;
+            return Parse::Complete;
+        }
+
+        /// @brief Get the free space to read into, making room for the pending frame.
+        ///        Invalidates the payloads of previously decoded frames.
+        /// @return std::span<char> Writable space after the buffered bytes
+        [[nodiscard]] auto prepare() -> std::span<char> {
+            // Move the partial frame to the front so the whole buffer is available for it
+            if (begin_) {
+                std::memmove(buffer_.data(), buffer_.data() + begin_, end_ - begin_);
+                end_ -= begin_;
+                begin_ = 0;
+            }
+            if (need_ > buffer_.size()) buffer_.resize(need_);
+            if (end_ == buffer_.size()) buffer_.resize(buffer_.size() * 2);
+            return {buffer_.data() + end_, buffer_.size() - end_};
+        }
+
+        /// @brief Mark bytes read into prepare() as buffered
+        /// @param n Number of bytes read
+        auto commit(std::size_t n) noexcept -> void { end_ += n; }
+
+        /// @brief Get the number of buffered bytes that haven't been decoded yet
+        [[nodiscard]] auto buffered() const noexcept -> std::size_t { return end_ - begin_; }
+
+    private:
+        /// @brief Remember how many bytes the pending frame needs
+        auto partial(std::size_t need) noexcept -> Parse {
+            need_ = need;
+            return Parse::Partial;
+        }
+
+        /// @brief XOR a payload with its masking key, eight bytes at a time
+        static auto unmask(char *payload, std::size_t n, const uint8_t *key) noexcept -> void {
+            uint64_t mask;
+            uint8_t repeated[8];
+            for (std::size_t i = 0; i < 8; i++) repeated[i] = key[i % 4];
+            std::memcpy(&mask, repeated, 8);
+
+            std::size_t i = 0;
+            for (; i + 8 <= n; i += 8) {
+                uint64_t word;
+                std::memcpy(&word, payload + i, 8);
+                word ^= mask;
+                std::memcpy(payload + i, &word, 8);
+            }
+            for (; i < n; i++) payload[i] ^= static_cast<char>(key[i % 4]);
+        }
+
+        std::vector<char> buffer_; ///< Read buffer
+        std::size_t begin_{0};     ///< Start of the bytes not decoded yet
+        std::size_t end_{0};       ///< End of the buffered bytes
+        std::size_t need_{0};      ///< Bytes the pending frame needs, 0 if unknown
+        std::uint64_t max_payload_;///< Largest payload accepted in a single frame
+    };
+
     /// @brief WebSocket Connection
     class Connection {
     public:
@@ -69,72 +211,57 @@ namespace harbour::websocket {
             : key_(std::move(key)),
               version_(std::move(version)),
               secret_(std::move(secret)),
-              socket_(std::move(socket)),
-              read_buffer_(DEFAULT_BUFFER_SIZE) {}
+              socket_(std::move(socket)) {}
 
-        /// @brief Read a WebSocket frame from the connection
-        /// @return String containing frame payload
+        /// @brief Read a WebSocket message from the connection.
+        ///        Fragmented messages are joined, pings are answered and pongs skipped while reading.
+        ///        Frames already buffered by a previous read are decoded without reading from the socket.
+        ///        A frame breaking RFC 6455 closes the connection with CloseCode::ProtocolError.
+        /// @return String containing the message payload, empty if the connection was closed or failed
         auto read() -> awaitable<std::optional<std::string>> {
             try {
-                // Read header
-                std::array<uint8_t, 2> header;
-                auto bytes_read = co_await socket_->async_read_some(asio::buffer(header), use_awaitable);
-                if (bytes_read != 2) co_return std::nullopt;
-
-                bool fin             = (header[0] & 0x80) != 0;
-                Opcode opcode        = static_cast<Opcode>(header[0] & 0x0F);
-                bool masked          = (header[1] & 0x80) != 0;
-                uint64_t payload_len = header[1] & 0x7F;
-
-                // Handle extended payload length
-                if (payload_len == 126) {
-                    std::array<uint8_t, 2> ext_len;
-                    bytes_read = co_await socket_->async_read_some(asio::buffer(ext_len), use_awaitable);
-                    if (bytes_read != 2) co_return std::nullopt;
-                    payload_len = (ext_len[0] << 8) | ext_len[1];
-                } else if (payload_len == 127) {
-                    std::array<uint8_t, 8> ext_len;
-                    bytes_read = co_await socket_->async_read_some(asio::buffer(ext_len), use_awaitable);
-                    if (bytes_read != 8) co_return std::nullopt;
-                    payload_len = 0;
-                    for (int i = 0; i < 8; i++) {
-                        payload_len = (payload_len << 8) | ext_len[i];
+                std::string message;
+                bool fragmented = false;
+                for (;;) {
+                    Frame frame;
+                    const auto parsed = decoder_.next(frame);
+                    if (parsed == Parse::Partial) {
+                        const auto space = decoder_.prepare();
+                        const auto n     = co_await socket_->async_read_some(asio::buffer(space.data(), space.size()), use_awaitable);
+                        decoder_.commit(n);
+                        continue;
                     }
-                }
-
-                // Read masking key if present
-                std::array<uint8_t, 4> mask_key;
-                if (masked) {
-                    bytes_read = co_await socket_->async_read_some(asio::buffer(mask_key), use_awaitable);
-                    if (bytes_read != 4) co_return std::nullopt;
-                }
-
-                // Read payload
-                if (payload_len > read_buffer_.size()) {
-                    read_buffer_.resize(payload_len);
-                }
-                bytes_read = co_await socket_->async_read_some(asio::buffer(read_buffer_.data(), payload_len), use_awaitable);
-                if (bytes_read != payload_len) co_return std::nullopt;
-
-                // Unmask if needed
-                if (masked) {
-                    for (size_t i = 0; i < payload_len; i++) {
-                        read_buffer_[i] ^= mask_key[i % 4];
+                    if (parsed == Parse::Error) {
+                        co_await close(CloseCode::ProtocolError);
+                        co_return std::nullopt;
                     }
-                }
 
-                // Handle control frames
-                switch (opcode) {
-                    case Opcode::Close:
-                        co_await close();
-                        co_return std::nullopt;
-                    case Opcode::Ping:
-                        co_await send(read_buffer_.data(), payload_len, Opcode::Pong);
-                        co_return std::string(read_buffer_.data(), payload_len);
-                    default:
-                        co_return std::string(read_buffer_.data(), payload_len);
+                    // Handle control frames
+                    switch (frame.opcode) {
+                        case Opcode::Close:
+                            // A Close payload is empty or starts with a 2 byte status code
+                            co_await close(frame.payload.size() == 1 ? CloseCode::ProtocolError : CloseCode::Normal);
+                            co_return std::nullopt;
+                        case Opcode::Ping:
+                            co_await send(frame.payload, Opcode::Pong);
+                            continue;
+                        case Opcode::Pong:
+                            continue;
+                        default:
+                            // Continuations must follow an unfinished message and new messages can't interrupt one
+                            if ((frame.opcode == Opcode::Continuation) != fragmented) {
+                                co_await close(CloseCode::ProtocolError);
+                                co_return std::nullopt;
+                            }
+                            if (message.size() + frame.payload.size() > MAX_PAYLOAD_SIZE) {
+                                co_await close(CloseCode::MessageTooBig);
+                                co_return std::nullopt;
+                            }
+                            message += frame.payload;
+                            fragmented = !frame.fin;
+                            if (frame.fin) co_return message;
+                    }
                 }
-
             } catch (const std::exception &) {
                 co_return std::nullopt;
             }
@@ -182,9 +309,12 @@ namespace harbour::websocket {
         }
 
         /// @brief Close the WebSocket connection
-        auto close() -> awaitable<void> {
+        /// @param code Status code sent in the Close frame
+        auto close(CloseCode code = CloseCode::Normal) -> awaitable<void> {
             try {
-                co_await send(nullptr, 0, Opcode::Close);
+                const auto value         = static_cast<uint16_t>(code);
+                const uint8_t payload[2] = {static_cast<uint8_t>(value >> 8), static_cast<uint8_t>(value & 0xFF)};
+                co_await send(payload, sizeof(payload), Opcode::Close);
             } catch (...) {
                 // Ignore errors during close
             }
@@ -194,7 +324,7 @@ namespace harbour::websocket {
         std::string version_;
         std::string secret_;
         server::SharedSocket socket_;
-        std::vector<char> read_buffer_;
+        Decoder decoder_;
     };
 
     /// @brief Upgrade a client to a websocket connection
@@ -19,63 +19,6 @@
 using namespace harbour;
 namespace fs = std::filesystem;
 
-/// @brief Accepted MIME Types
-using MimeTypes = std::vector<std::pair<std::vector<std::string>, std::string>>;
-static auto ServerAcceptedMimeTypes() -> const MimeTypes & {
-    static const MimeTypes mimes = {{{".txt", ".text", ".conf", ".log", ".ini"}, "text/plain; charset=utf-8"},
-                                    {{".html", ".htm"}, "text/html; charset=utf-8"},
-                                    {{".pdf"}, "application/pdf"},
-                                    {{".jpg", ".jpeg"}, "image/jpeg"},
-                                    {{".png"}, "image/png"},
-                                    {{".gif"}, "image/gif"},
-                                    {{".mp3"}, "audio/mpeg"},
-                                    {{".mp4"}, "video/mp4"},
-                                    {{".json"}, "application/json"},
-                                    {{".xml"}, "application/xml"},
-                                    {{".zip"}, "application/zip"},
-                                    {{".css"}, "text/css"},
-                                    {{".doc", ".docx"}, "application/msword"},
-                                    {{".xls", ".xlsx"}, "application/vnd.ms-excel"},
-                                    {{".ppt", ".pptx"}, "application/vnd.ms-powerpoint"},
-                                    {{".wav"}, "audio/wav"},
-                                    {{".avi"}, "video/x-msvideo"},
-                                    {{".bmp"}, "image/bmp"},
-                                    {{".csv"}, "text/csv"},
-                                    {{".js"}, "application/javascript"},
-                                    {{".ico"}, "image/x-icon"},
-                                    {{".svg", ".svgz"}, "image/svg+xml"},
-                                    {{".c", ".cpp", ".h", ".hpp"}, "text/html; charset=utf-8"},
-                                    {{".tar"}, "application/x-tar"},
-                                    {{".7z"}, "application/x-7z-compressed"},
-                                    {{".rar"}, "application/x-rar-compressed"},
-                                    {{".rtf"}, "application/rtf"},
-                                    {{".ogg"}, "audio/ogg"},
-                                    {{".ogv"}, "video/ogg"},
-                                    {{".webm"}, "video/webm"},
-                                    {{".flv"}, "video/x-flv"},
-                                    {{".mkv"}, "video/x-matroska"},
-                                    {{".eot"}, "application/vnd.ms-fontobject"},
-                                    {{".ttf"}, "font/ttf"},
-                                    {{".woff"}, "font/woff"},
-                                    {{".woff2"}, "font/woff2"},
-                                    {{".otf"}, "font/otf"},
-                                    {{".md"}, "text/markdown"}};
-
-    return mimes;
-}
-
-auto get_mime_type(const std::string_view ext) -> std::string {
-    for (const auto &mimes: ServerAcceptedMimeTypes()) {
-        const auto &extensions = mimes.first;
-        if (std::find(extensions.begin(), extensions.end(), ext) != extensions.end()) {
-            return mimes.second;
-        }
-    }
-
-    log::warn("Invalid mime type for: {}", ext);
-    return "text/plain";
-};
-
 auto get_full_path(auto &&target) -> std::string {
     auto current_dir = fs::current_path();
     current_dir += target;
@@ -103,7 +46,7 @@ auto Ship(const Request &req) -> awaitable<Response> {
         fs::path index_path  = req.path.empty() ? std::string(req.path) + "/index.html" : std::string(req.path) + "index.html";
         const auto full_path = get_full_path(fs::path(index_path).make_preferred());
         if (auto file = tmpl::load_file(full_path)) {
-            const auto mime = get_mime_type(fs::path(full_path).extension().string());
+            const auto mime = std::string(http::mime::get(fs::path(full_path).extension().string()));
             co_return Response()
                     .with_status(http::Status::OK)
                     .with_header("Content-Type", mime)
@@ -145,7 +88,7 @@ auto Ship(const Request &req) -> awaitable<Response> {
     // If our path exists serve the file
     const auto full_path = get_full_path(fs::path(req.path).make_preferred());
     if (auto file = tmpl::load_file(full_path)) {
-        const auto mime = get_mime_type(fs::path(req.path).extension().string());
+        const auto mime = std::string(http::mime::get(fs::path(req.path).extension().string()));
         co_return Response()
                 .with_status(http::Status::OK)
                 .with_header("Content-Type", mime)
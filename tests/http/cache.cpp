@@ -0,0 +1,157 @@
+///  _  _             _
+/// | || | __ _  _ _ | |__  ___  _  _  _ _   A Web Server Framework For Modern C++
+/// | __ |/ _` || '_|| '_ \/ _ \| || || '_|  https://github.com/griefzz/harbour
+/// |_||_|\__,_||_|  |_.__/\___/ \_,_||_|    License: MIT
+///
+
+#include <cassert>
+#include <chrono>
+#include <string>
+#include <string_view>
+
+#include <harbour/harbour.hpp>
+
+#define EXPECT(ok) \
+    assert((ok));  \
+    if (!(ok)) return 1;
+
+using namespace harbour;
+using namespace harbour::middleware;
+
+// Run a Cache on a Request and return the Response it produced
+auto handle(Cache &cache, const Request &req, bool *handled = nullptr) -> Response {
+    Response resp;
+    asio::io_context ctx(1);
+    asio::co_spawn(ctx, [&]() -> asio::awaitable<void> {
+        auto h = co_await cache(req, resp);
+        if (handled) *handled = h.value;
+    },
+                   asio::detached);
+    ctx.run();
+    return resp;
+}
+
+// Parse a Request, the message must outlive it since the Request views it
+auto make_request(std::string_view msg) -> Request {
+    return *Request::create(nullptr, msg.data(), msg.size());
+}
+
+auto test_store() -> int {
+    const auto now = cache::Clock::now();
+    auto entry     = [&](std::size_t n) {
+        cache::Entry e;
+        e.response = std::make_shared<const std::string>(n, 'x');
+        e.expires  = now + std::chrono::seconds(10);
+        return e;
+    };
+
+    // Inserts never grow a shard past its budget, referenced entries survive the clock hand
+    cache::Store store({.capacity = 4096, .shards = 1});
+    for (int i = 0; i < 256; i++) {
+        store.put("key" + std::to_string(i), entry(100), now);
+        EXPECT(store.bytes() <= 4096);
+        EXPECT(store.get("key0", now));
+    }
+    EXPECT(!store.get("key1", now));
+
+    // Entries larger than a shard are never stored
+    store.put("huge", entry(8192), now);
+    EXPECT(!store.get("huge", now));
+
+    // Stale entries are not returned
+    EXPECT(store.get("key0", now));
+    EXPECT(!store.get("key0", now + std::chrono::seconds(11)));
+    return 0;
+}
+
+auto main() -> int {
+    if (test_store() != 0) return 1;
+
+    const auto first  = make_request("GET /page?id=1 HTTP/1.1\r\nAccept-Language: en\r\n\r\n");
+    const auto same   = make_request("GET /page?id=1 HTTP/1.1\r\nAccept-Language: de\r\n\r\n");
+    const auto other  = make_request("GET /page?id=2 HTTP/1.1\r\n\r\n");
+    const auto posted = make_request("POST /page?id=1 HTTP/1.1\r\nContent-Length: 0\r\n\r\n");
+
+    // Fresh Responses are served pre-serialized without running the Ships
+    int calls = 0;
+    Cache page([&](const Request &) {
+        calls++;
+        return Response("page").with_header("Cache-Control", "public, max-age=60");
+    });
+    const auto miss = handle(page, first);
+    EXPECT(!miss.serialized);
+    const auto hit = handle(page, first);
+    EXPECT(hit.serialized);
+    EXPECT(hit.string() == miss.string());
+    EXPECT(calls == 1);
+
+    // The query string and method are part of the key
+    handle(page, other);
+    EXPECT(calls == 2);
+    handle(page, posted);
+    handle(page, posted);
+    EXPECT(calls == 4);
+
+    // Vary splits entries on the named Request headers
+    int vary_calls = 0;
+    Cache language([&](const Request &req) {
+        vary_calls++;
+        return Response(std::string(req.header("Accept-Language").value_or("none")))
+                .with_headers({{"Cache-Control", "max-age=10, s-maxage=60"}, {"Vary", "accept-language"}});
+    });
+    for (int i = 0; i < 2; i++) {
+        EXPECT(handle(language, first).string().ends_with("en"));
+        EXPECT(handle(language, same).string().ends_with("de"));
+    }
+    EXPECT(vary_calls == 2);
+
+    // Private Responses are never stored
+    int private_calls = 0;
+    Cache personal([&](const Request &) {
+        private_calls++;
+        return Response("mine").with_header("Cache-Control", "private, max-age=60");
+    });
+    handle(personal, first);
+    handle(personal, first);
+    EXPECT(private_calls == 2);
+    EXPECT(personal.store->size() == 0);
+
+    // Responses to authorized Requests are only stored if they are marked as shared
+    const auto authorized = make_request("GET /account HTTP/1.1\r\nAuthorization: Bearer secret\r\n\r\n");
+    int account_calls = 0;
+    Cache account([&](const Request &) {
+        account_calls++;
+        return Response("secret").with_header("Cache-Control", "max-age=60");
+    });
+    handle(account, authorized);
+    handle(account, authorized);
+    EXPECT(account_calls == 2);
+    EXPECT(account.store->size() == 0);
+
+    int shared_calls = 0;
+    Cache shared([&](const Request &) {
+        shared_calls++;
+        return Response("shared").with_header("Cache-Control", "max-age=60, must-revalidate");
+    });
+    handle(shared, authorized);
+    handle(shared, authorized);
+    EXPECT(shared_calls == 1);
+
+    // Requests marked no-store don't have their Responses stored
+    const auto no_store = make_request("GET /page?id=3 HTTP/1.1\r\nCache-Control: no-store\r\n\r\n");
+    handle(page, no_store);
+    EXPECT(calls == 5);
+    handle(page, other);
+    EXPECT(calls == 5);
+    const auto fresh = make_request("GET /page?id=3 HTTP/1.1\r\n\r\n");
+    handle(page, fresh);
+    EXPECT(calls == 6);
+
+    // Requests the Ships don't handle are passed on
+    bool handled = true;
+    Cache nothing([](const Request &) {});
+    handle(nothing, first, &handled);
+    EXPECT(!handled);
+
+    return 0;
+}
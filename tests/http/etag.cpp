@@ -0,0 +1,114 @@
+///  _  _             _
+/// | || | __ _  _ _ | |__  ___  _  _  _ _   A Web Server Framework For Modern C++
+/// | __ |/ _` || '_|| '_ \/ _ \| || || '_|  https://github.com/griefzz/harbour
+/// |_||_|\__,_||_|  |_.__/\___/ \_,_||_|    License: MIT
+///
+
+#include <cassert>
+#include <chrono>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include <harbour/harbour.hpp>
+
+#define EXPECT(ok) \
+    assert((ok));  \
+    if (!(ok)) return 1;
+
+using namespace harbour;
+using namespace harbour::middleware;
+
+// Run a Ship on a Request and return the Response it produced
+auto handle(auto &ship, const Request &req) -> Response {
+    Response resp;
+    asio::io_context ctx(1);
+    asio::co_spawn(ctx, [&]() -> asio::awaitable<void> { co_await ship(req, resp); }, asio::detached);
+    ctx.run();
+    return resp;
+}
+
+// Parse a Request, its message is kept for the rest of the test since the Request views it
+auto make_request(std::string msg) -> Request {
+    static std::deque<std::string> messages;
+    const auto &kept = messages.emplace_back(std::move(msg));
+    return *Request::create(nullptr, kept.data(), kept.size());
+}
+
+auto header(const Response &resp, std::string_view key) -> std::string {
+    return std::string(http::fields::find(resp.headers, key).value_or(""));
+}
+
+auto test_dates() -> int {
+    using namespace std::chrono;
+    const auto t = sys_days(year(1994) / 11 / 6) + hours(8) + minutes(49) + seconds(37);
+    EXPECT(http::date::format(t) == "Sun, 06 Nov 1994 08:49:37 GMT");
+    EXPECT(http::date::parse("Sun, 06 Nov 1994 08:49:37 GMT") == t);
+    EXPECT(!http::date::parse("Sunday, 06-Nov-94 08:49:37 GMT"));
+    EXPECT(!http::date::parse("Sun, 31 Feb 1994 08:49:37 GMT"));
+    return 0;
+}
+
+auto test_matches() -> int {
+    EXPECT(etag::matches("\"a\", \"b\"", "\"b\""));
+    EXPECT(etag::matches("W/\"b\"", "\"b\""));
+    EXPECT(etag::matches("*", "\"b\""));
+    EXPECT(!etag::matches("\"a\"", "\"b\""));
+    return 0;
+}
+
+auto main() -> int {
+    if (test_dates() != 0) return 1;
+    if (test_matches() != 0) return 1;
+
+    const auto plain = make_request("GET / HTTP/1.1\r\n\r\n");
+
+    // In-memory bodies are tagged with a hash of their contents
+    ETag page([](const Request &) { return Response("page"); });
+    const auto full = handle(page, plain);
+    const auto tag  = header(full, "ETag");
+    EXPECT(full.status == http::Status::OK);
+    EXPECT(tag == etag::hash("page"));
+
+    // A matching If-None-Match is answered without a body
+    const auto revalidate = make_request("GET / HTTP/1.1\r\nIf-None-Match: " + tag + "\r\n\r\n");
+    const auto cached     = handle(page, revalidate);
+    EXPECT(cached.status == http::Status::NotModified);
+    EXPECT(!cached.data);
+    EXPECT(header(cached, "ETag") == tag);
+
+    const auto stale = make_request("GET / HTTP/1.1\r\nIf-None-Match: \"other\"\r\n\r\n");
+    EXPECT(handle(page, stale).status == http::Status::OK);
+
+    // File bodies are tagged from their modification time and size
+    const auto path = std::filesystem::temp_directory_path() / "harbour_etag_test.txt";
+    std::ofstream(path) << "file contents";
+    ETag file([&](const Request &, Response &resp) {
+        resp.data = response::File{path, 0, 13};
+        return true;
+    });
+    const auto served   = handle(file, plain);
+    const auto modified = header(served, "Last-Modified");
+    EXPECT(!header(served, "ETag").empty());
+    EXPECT(http::date::parse(modified));
+
+    const auto since = make_request("GET / HTTP/1.1\r\nIf-Modified-Since: " + modified + "\r\n\r\n");
+    EXPECT(handle(file, since).status == http::Status::NotModified);
+    std::filesystem::remove(path);
+
+    // Cached Responses answer revalidation from the cache
+    int calls = 0;
+    Cache cache(ETag([&](const Request &) {
+        calls++;
+        return Response("cached").with_header("Cache-Control", "max-age=60");
+    }));
+    const auto first = handle(cache, plain);
+    const auto again = make_request("GET / HTTP/1.1\r\nIf-None-Match: " + header(first, "ETag") + "\r\n\r\n");
+    const auto hit   = handle(cache, again);
+    EXPECT(hit.status == http::Status::NotModified);
+    EXPECT(hit.serialized && hit.serialized->find("304") != std::string::npos);
+    EXPECT(calls == 1);
+
+    return 0;
+}
@@ -0,0 +1,174 @@
+///  _  _             _
+/// | || | __ _  _ _ | |__  ___  _  _  _ _   A Web Server Framework For Modern C++
+/// | __ |/ _` || '_|| '_ \/ _ \| || || '_|  https://github.com/griefzz/harbour
+/// |_||_|\__,_||_|  |_.__/\___/ \_,_||_|    License: MIT
+///
+
+#include <cassert>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <harbour/harbour.hpp>
+
+#define EXPECT(ok) \
+    assert((ok));  \
+    if (!(ok)) return 1;
+
+using namespace harbour;
+using namespace harbour::middleware;
+
+auto write(const std::filesystem::path &path, const std::string &data) -> void {
+    std::ofstream(path, std::ios::binary | std::ios::trunc) << data;
+}
+
+// Request a file from a FileServer with extra headers
+auto get(FileServer &server, const std::string &path, const std::string &headers = "") -> Response {
+    const auto msg = "GET " + path + " HTTP/1.1\r\n" + headers + "\r\n";
+    const auto req = *Request::create(nullptr, msg.data(), msg.size());
+    Response resp;
+    asio::io_context ctx(1);
+    asio::co_spawn(ctx, [&]() -> asio::awaitable<void> { co_await server(req, resp); }, asio::detached);
+    ctx.run();
+    return resp;
+}
+
+auto test_parse() -> int {
+    using http::range::Status;
+    std::vector<http::range::Range> ranges;
+    EXPECT(http::range::parse("bytes=0-4", 10, ranges) == Status::Satisfiable);
+    EXPECT(ranges.size() == 1 && ranges[0].offset == 0 && ranges[0].length == 5);
+    EXPECT(http::range::parse("bytes=-3", 10, ranges) == Status::Satisfiable);
+    EXPECT(ranges[0].offset == 7 && ranges[0].length == 3);
+    EXPECT(http::range::parse("bytes=5-", 10, ranges) == Status::Satisfiable);
+    EXPECT(ranges[0].offset == 5 && ranges[0].length == 5);
+    EXPECT(http::range::parse("bytes=0-2, 2-5, 8-9", 10, ranges) == Status::Satisfiable);
+    EXPECT(ranges.size() == 2 && ranges[0].length == 6);
+    EXPECT(http::range::parse("bytes=20-30", 10, ranges) == Status::Unsatisfiable);
+    EXPECT(http::range::parse("bytes=5-2", 10, ranges) == Status::Ignore);
+    EXPECT(http::range::parse("items=0-2", 10, ranges) == Status::Ignore);
+    return 0;
+}
+
+auto test_ranges(const std::filesystem::path &dir) -> int {
+    write(dir / "range.txt", "0123456789abcdefghij");
+    FileServer server(dir.string() + "/");
+
+    const auto full = get(server, "/range.txt");
+    EXPECT(full.status == http::Status::OK);
+    EXPECT(full.data == "0123456789abcdefghij");
+
+    // A single range is a slice of the cached file
+    const auto one = get(server, "/range.txt", "Range: bytes=2-4\r\n");
+    EXPECT(one.status == http::Status::PartialContent);
+    EXPECT(one.data == "234");
+    EXPECT(http::fields::find(one.headers, "Content-Range").value_or("") == "bytes 2-4/20");
+
+    // Multiple ranges are sent as multipart/byteranges
+    const auto multi = get(server, "/range.txt", "Range: bytes=0-1, -2\r\n");
+    EXPECT(multi.status == http::Status::PartialContent);
+    EXPECT(http::fields::find(multi.headers, "Content-Type").value_or("").starts_with("multipart/byteranges; boundary="));
+    const auto body = multi.data.string();
+    EXPECT(body.size() == multi.data.size());
+    EXPECT(body.find("Content-Range: bytes 0-1/20\r\n\r\n01\r\n") != std::string::npos);
+    EXPECT(body.find("Content-Range: bytes 18-19/20\r\n\r\nij\r\n") != std::string::npos);
+
+    // Ranges past the end are not satisfiable
+    const auto past = get(server, "/range.txt", "Range: bytes=50-\r\n");
+    EXPECT(past.status == http::Status::RangeNotSatisfiable);
+    EXPECT(!past.data);
+
+    // If-Range only allows ranges of the current file
+    const auto tag = std::string(http::fields::find(full.headers, "ETag").value_or(""));
+    EXPECT(get(server, "/range.txt", "Range: bytes=0-0\r\nIf-Range: " + tag + "\r\n").status == http::Status::PartialContent);
+    EXPECT(get(server, "/range.txt", "Range: bytes=0-0\r\nIf-Range: \"old\"\r\n").status == http::Status::OK);
+
+    // Files too large to cache are sliced straight from disk
+    write(dir / "large.bin", std::string(512 * 1024, 'x'));
+    const auto large = get(server, "/large.bin", "Range: bytes=100-199\r\n");
+    EXPECT(large.data.file() && large.data.file()->offset == 100 && large.data.size() == 100);
+    return 0;
+}
+
+auto main() -> int {
+    if (test_parse() != 0) return 1;
+
+    const auto dir = std::filesystem::temp_directory_path() / "harbour_files_test";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir / "sub");
+    write(dir / "a.txt", "hello");
+    write(dir / "sub" / "b.txt", "world");
+    write(dir / "big.txt", std::string(2048, 'x'));
+
+    files::Cache cache({.capacity = 12, .max_file_size = 1024});
+
+    // Lookups never load files, only get does
+    EXPECT(!cache.find(dir / "a.txt"));
+
+    // Small files are cached with their contents, hits share the same buffer
+    const auto a = cache.get(dir / "a.txt");
+    EXPECT(a && a->content && *a->content == "hello");
+    EXPECT(cache.get(dir / "." / "a.txt") == a);
+    EXPECT(cache.find(dir / "a.txt") == a);
+
+    // Large files only cache their metadata
+    const auto big = cache.get(dir / "big.txt");
+    EXPECT(big && !big->content && big->size == 2048);
+
+    // Missing files and directories are not cached
+    EXPECT(!cache.get(dir / "missing.txt"));
+    EXPECT(!cache.get(dir / "sub"));
+
+    // Changed files are reloaded
+    write(dir / "a.txt", "changed!");
+    EXPECT(!cache.find(dir / "a.txt"));
+    const auto changed = cache.get(dir / "a.txt");
+    EXPECT(changed && *changed->content == "changed!");
+    EXPECT(changed->validators.tag != a->validators.tag);
+
+    // The least recently used contents are dropped to stay within budget, their metadata stays cached
+    const auto b = cache.get(dir / "sub" / "b.txt");
+    EXPECT(b && *b->content == "world");
+    EXPECT(cache.bytes() <= 12);
+    const auto evicted = cache.find(dir / "a.txt");
+    EXPECT(evicted && !evicted->content && evicted->size == 8 && evicted->validators.tag == changed->validators.tag);
+    EXPECT(cache.find(dir / "sub" / "b.txt") == b);
+
+    // Lookups count as a use, so the file found last keeps its contents
+    {
+        files::Cache recent({.capacity = 8, .max_file_size = 1024});
+        write(dir / "x.txt", "1234");
+        write(dir / "y.txt", "5678");
+        write(dir / "z.txt", "9abc");
+        EXPECT(recent.get(dir / "x.txt") && recent.get(dir / "y.txt"));
+        EXPECT(recent.find(dir / "x.txt"));
+        EXPECT(recent.get(dir / "z.txt"));
+
+        const auto x = recent.find(dir / "x.txt"), y = recent.find(dir / "y.txt"), z = recent.find(dir / "z.txt");
+        EXPECT(x && x->content && y && !y->content && z && z->content && recent.bytes() == 8);
+    }
+
+    // Removed files are forgotten
+    std::filesystem::remove(dir / "sub" / "b.txt");
+    EXPECT(!cache.get(dir / "sub" / "b.txt"));
+
+    // Files in directories inotify can't watch, here one that can't be listed, check their modification time instead
+    {
+        const auto hidden = dir / "hidden";
+        std::filesystem::create_directories(hidden);
+        write(hidden / "c.txt", "before");
+        std::filesystem::permissions(hidden, std::filesystem::perms::owner_write | std::filesystem::perms::owner_exec);
+        const auto before = cache.get(hidden / "c.txt");
+        EXPECT(before && *before->content == "before");
+        write(hidden / "c.txt", "after!!");
+        const auto after = cache.get(hidden / "c.txt");
+        EXPECT(after && *after->content == "after!!");
+        std::filesystem::permissions(hidden, std::filesystem::perms::owner_all);
+    }
+
+    if (test_ranges(dir) != 0) return 1;
+
+    std::filesystem::remove_all(dir);
+    return 0;
+}
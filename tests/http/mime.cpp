@@ -0,0 +1,41 @@
+///  _  _             _
+/// | || | __ _  _ _ | |__  ___  _  _  _ _   A Web Server Framework For Modern C++
+/// | __ |/ _` || '_|| '_ \/ _ \| || || '_|  https://github.com/griefzz/harbour
+/// |_||_|\__,_||_|  |_.__/\___/ \_,_||_|    License: MIT
+///
+
+#include <cassert>
+#include <cctype>
+#include <string>
+
+#include <harbour/harbour.hpp>
+
+#define EXPECT(ok) \
+    assert((ok));  \
+    if (!(ok)) return 1;
+
+using namespace harbour;
+
+// Lookups are resolved at compile time
+static_assert(http::mime::get(".html") == "text/html; charset=utf-8");
+static_assert(http::mime::get("PNG") == "image/png");
+static_assert(!http::mime::find(".unknown"));
+
+auto main() -> int {
+    // Every extension maps to its own type, with or without the leading '.', in any case
+    for (const auto &t: http::mime::Types) {
+        EXPECT(http::mime::find(t.extension) == t.type);
+        std::string upper = "." + std::string(t.extension);
+        for (auto &c: upper) c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+        EXPECT(http::mime::find(upper) == t.type);
+    }
+
+    // Unknown extensions fall back to a binary stream
+    EXPECT(http::mime::get(".unknown") == http::mime::Default);
+    EXPECT(http::mime::get("") == http::mime::Default);
+    EXPECT(http::mime::get(".htmlx") == http::mime::Default);
+
+    // FileServer shares the same table
+    EXPECT(middleware::FileServer::get_mime_type(".MP4") == "video/mp4");
+    return 0;
+}
@@ -0,0 +1,114 @@
+///  _  _             _
+/// | || | __ _  _ _ | |__  ___  _  _  _ _   A Web Server Framework For Modern C++
+/// | __ |/ _` || '_|| '_ \/ _ \| || || '_|  https://github.com/griefzz/harbour
+/// |_||_|\__,_||_|  |_.__/\___/ \_,_||_|    License: MIT
+///
+
+#include <cassert>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <harbour/harbour.hpp>
+
+#define EXPECT(ok) \
+    assert((ok));  \
+    if (!(ok)) return 1;
+
+using namespace harbour;
+
+// Await a Pipeline and get whether it handled the Request
+auto run(auto &ship, const Request &req, Response &resp) -> bool {
+    bool handled = false;
+    asio::io_context ctx(1);
+    asio::co_spawn(ctx, [&]() -> asio::awaitable<void> {
+        const auto result = co_await ship(req, resp);
+        handled           = result.value; }, asio::detached);
+    ctx.run();
+    return handled;
+}
+
+auto main() -> int {
+    const std::string msg = "GET /pipeline HTTP/1.1\r\n\r\n";
+    const auto req        = *Request::create(nullptr, msg.data(), msg.size());
+
+    // Synchronous stages run in order until one produces a Response
+    {
+        std::vector<int> trace;
+        auto ship = pipeline([&] { trace.push_back(1); },
+                             [&](Response &) { trace.push_back(2); },
+                             [&]() -> std::optional<Response> { trace.push_back(3); return std::nullopt; },
+                             [&] { trace.push_back(4); return Response("done"); },
+                             [&] { trace.push_back(5); return Response("unreachable"); });
+        static_assert(!decltype(ship)::is_async);
+        static_assert(std::is_same_v<decltype(ship(req, std::declval<Response &>())), detail::Handled>);
+
+        Response resp;
+        const auto handled = ship(req, resp).value;
+        EXPECT(handled && resp.data == "done");
+        EXPECT((trace == std::vector<int>{1, 2, 3, 4}));
+    }
+
+    // Changes to the Response are seen by the next stage
+    {
+        auto ship = pipeline([](Response &resp) { resp.headers["X-Stage"] = "one"; },
+                             [](Response &resp) { resp.status = http::Status::Accepted; },
+                             [](Response &resp, const Request &r) {
+                                 resp.data = std::string(http::fields::find(resp.headers, "X-Stage").value_or("")) + std::string(r.path);
+                                 return detail::Handled{true};
+                             });
+
+        Response resp;
+        const auto handled = ship(req, resp).value;
+        EXPECT(handled && resp.status == http::Status::Accepted && resp.data == "one/pipeline");
+    }
+
+    // A Pipeline where no stage produces a Response isn't handled
+    {
+        auto ship = pipeline([](Response &resp) { resp.data = "kept"; }, [] { return std::optional<Response>(); });
+        Response resp;
+        const auto handled = ship(req, resp).value;
+        EXPECT(!handled && resp.data == "kept");
+    }
+
+    // Awaitable stages are awaited in order between synchronous ones
+    {
+        std::vector<int> trace;
+        auto ship = pipeline([&](Response &resp) { trace.push_back(1); resp.data = "a"; },
+                             [&](Response &resp) -> asio::awaitable<void> { trace.push_back(2); resp.data = std::string(resp.data.view()) + "b"; co_return; },
+                             [&](Response &resp) { trace.push_back(3); resp.data = std::string(resp.data.view()) + "c"; },
+                             [&]() -> asio::awaitable<std::optional<Response>> { trace.push_back(4); co_return std::nullopt; },
+                             [&](Response &resp) { trace.push_back(5); return resp; });
+        static_assert(decltype(ship)::is_async);
+
+        Response resp;
+        const auto handled = run(ship, req, resp);
+        EXPECT(handled && resp.data == "abc");
+        EXPECT((trace == std::vector<int>{1, 2, 3, 4, 5}));
+    }
+
+    // An awaitable stage producing a Response stops the Pipeline
+    {
+        std::vector<int> trace;
+        auto ship = pipeline([&] { trace.push_back(1); },
+                             [&]() -> asio::awaitable<Response> { trace.push_back(2); co_return Response("early"); },
+                             [&]() -> asio::awaitable<Response> { trace.push_back(3); co_return Response("late"); });
+
+        Response resp;
+        const auto handled = run(ship, req, resp);
+        EXPECT(handled && resp.data == "early");
+        EXPECT((trace == std::vector<int>{1, 2}));
+    }
+
+    // Pipelines are Ships themselves, a returned Response replaces the one earlier stages changed
+    {
+        const detail::Ship ship(pipeline([](Response &resp) { resp.headers["X-Stage"] = "one"; },
+                                         [] { return Response("docked"); }));
+        Response resp;
+        const auto handled = ship(req, resp);
+        EXPECT(handled && resp.data == "docked" && !http::fields::find(resp.headers, "X-Stage"));
+    }
+
+    return 0;
+}
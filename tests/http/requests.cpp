@@ -6,6 +6,7 @@
 
 #include <iostream>
 #include <cassert>
+#include <algorithm>
 
 #include <harbour/harbour.hpp>
 
@@ -33,8 +34,87 @@ bool check_header(const harbour::Request &req, auto &&key, auto &&value) {
     return false;
 }
 
+// Build a request with more headers than can be stored inline
+auto make_overflow_message(std::size_t n) -> std::string {
+    std::string msg = "GET /overflow HTTP/1.1\r\n";
+    for (std::size_t i = 0; i < n; i++)
+        msg += fmt::format("X-Header-{}: {}\r\n", i, i);
+    return msg + "\r\n";
+}
+
+auto test_overflow(const std::shared_ptr<harbour::server::Socket> &sock) -> int {
+    const auto n   = HARBOUR_MAX_INLINE_HEADERS * 2;
+    const auto msg = make_overflow_message(n);
+    if (auto req = harbour::Request::create(sock, msg.data(), msg.size())) {
+        EXPECT(req->headers.size() == n);
+        EXPECT(check_header(*req, "X-Header-0", "0"));
+        EXPECT(check_header(*req, fmt::format("X-Header-{}", n - 1), fmt::format("{}", n - 1)));
+        EXPECT(req->header_map().size() == n);
+        return 0;
+    }
+
+    return 1;
+}
+
+// The SIMD parser must produce the same view of a request as llhttp
+auto test_simd() -> int {
+    using namespace harbour::request::detail;
+    RequestData llhttp_data;
+    RequestData simd_data;
+    EXPECT(parse_llhttp(llhttp_data, get_message.data(), get_message.size()));
+    EXPECT(parse_simd(simd_data, get_message.data(), get_message.size()) == ParseResult::Ok);
+    EXPECT(std::ranges::equal(llhttp_data.path, simd_data.path));
+    EXPECT(std::ranges::equal(llhttp_data.data, simd_data.data));
+    EXPECT(llhttp_data.method == simd_data.method);
+    EXPECT(llhttp_data.version == simd_data.version);
+    EXPECT(llhttp_data.headers.size() == simd_data.headers.size());
+    for (std::size_t i = 0; i < simd_data.headers.size(); i++) {
+        EXPECT(llhttp_data.headers[i].key == simd_data.headers[i].key);
+        EXPECT(llhttp_data.headers[i].value == simd_data.headers[i].value);
+    }
+
+    return 0;
+}
+
+auto test_methods() -> int {
+    using namespace harbour::request::detail;
+    using harbour::http::Method;
+    for (auto method: {Method::PUT, Method::HEAD, Method::DELETE, Method::PATCH, Method::OPTIONS}) {
+        const auto msg = std::string(harbour::http::detail::to_string(method)) + " /users/1 HTTP/1.1\r\nHost: github.com\r\n\r\n";
+        RequestData llhttp_data;
+        RequestData simd_data;
+        EXPECT(parse_llhttp(llhttp_data, msg.data(), msg.size()));
+        EXPECT(parse_simd(simd_data, msg.data(), msg.size()) == ParseResult::Ok);
+        EXPECT(llhttp_data.method == method);
+        EXPECT(simd_data.method == method);
+    }
+
+    return 0;
+}
+
+// Both parsers read the minor HTTP version, it decides if the connection stays open
+auto test_versions() -> int {
+    using namespace harbour::request::detail;
+    for (const std::uint8_t version: {0, 1}) {
+        const auto msg = fmt::format("GET / HTTP/1.{}\r\nHost: github.com\r\n\r\n", version);
+        RequestData llhttp_data;
+        RequestData simd_data;
+        EXPECT(parse_llhttp(llhttp_data, msg.data(), msg.size()));
+        EXPECT(parse_simd(simd_data, msg.data(), msg.size()) == ParseResult::Ok);
+        EXPECT(llhttp_data.version == version);
+        EXPECT(simd_data.version == version);
+    }
+
+    return 0;
+}
+
 auto main() -> int {
     std::shared_ptr<harbour::server::Socket> sock;
+    if (test_overflow(sock) != 0) return 1;
+    if (test_simd() != 0) return 1;
+    if (test_methods() != 0) return 1;
+    if (test_versions() != 0) return 1;
+
     if (auto req = harbour::Request::create(sock, get_message.data(), get_message.size())) {
         EXPECT(check_header(*req, "Host", "github.com"));
         EXPECT(check_header(*req, "Connection", "keep-alive"));
@@ -48,6 +128,7 @@ auto main() -> int {
         EXPECT(check_header(*req, "If-None-Match", "7f9c6a2baf61233cedd62ffa906b604f"));
         EXPECT(req->method == harbour::http::Method::GET);
         EXPECT(req->path == "/api/v1/foo");
+        EXPECT(req->version == 1);
         EXPECT(req->body.size() == 0);
         EXPECT(req->data.size() == get_message.size());
         return 0;
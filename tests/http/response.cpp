@@ -0,0 +1,70 @@
+///  _  _             _
+/// | || | __ _  _ _ | |__  ___  _  _  _ _   A Web Server Framework For Modern C++
+/// | __ |/ _` || '_|| '_ \/ _ \| || || '_|  https://github.com/griefzz/harbour
+/// |_||_|\__,_||_|  |_.__/\___/ \_,_||_|    License: MIT
+///
+
+#include <cassert>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+
+#include <harbour/harbour.hpp>
+
+#define EXPECT(ok) \
+    assert((ok));  \
+    if (!(ok)) return 1;
+
+using namespace harbour;
+
+auto main() -> int {
+    // Owned bodies are written after the head
+    Response owned("Hello");
+    EXPECT(owned.data == "Hello");
+    EXPECT(owned.head().ends_with("Content-Length: 5\n\n"));
+    EXPECT(owned.string() == owned.head() + "Hello");
+
+    // Statuses without a body have no Content-Length
+    Response empty(http::Status::NoContent);
+    EXPECT(!empty.data);
+    EXPECT(empty.string() == empty.head());
+    EXPECT(empty.head().ends_with("keep-alive\n\n"));
+
+    // Other empty bodies have a zero Content-Length so the client knows where the Response ends
+    Response missing(http::Status::NotFound);
+    EXPECT(missing.head().ends_with("Connection: keep-alive\nContent-Length: 0\n\n"));
+
+    // The last Response on a connection says so
+    EXPECT(missing.head(false).ends_with("Connection: close\nContent-Length: 0\n\n"));
+    Response serialized;
+    serialized.serialized = std::make_shared<const std::string>(owned.string());
+    EXPECT(serialized.string() == owned.string());
+    EXPECT(serialized.string(false) == owned.string(false));
+    EXPECT(owned.string(false).ends_with("Connection: close\nContent-Length: 5\n\nHello"));
+
+    // Static bodies view the literal
+    Response literal(response::Static("Hello, World!"));
+    EXPECT(literal.data == "Hello, World!");
+    EXPECT(literal.data.size() == 13);
+
+    // Shared bodies are never copied, not even with the Response
+    auto cached = std::make_shared<const std::string>("cached content");
+    Response shared(cached);
+    Response copy = shared;
+    EXPECT(shared.data.view().data() == cached->data());
+    EXPECT(copy.data.view().data() == cached->data());
+
+    // File bodies are read from disk only when needed
+    {
+        std::ofstream out("response_body.txt", std::ios::binary);
+        out << "0123456789";
+    }
+    Response file(response::File{"response_body.txt", 3, 4});
+    EXPECT(file.data.file() != nullptr);
+    EXPECT(file.data.size() == 4);
+    EXPECT(file.data.view().empty());
+    EXPECT(file.string().ends_with("Content-Length: 4\n\n3456"));
+    std::remove("response_body.txt");
+
+    return 0;
+}
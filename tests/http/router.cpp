@@ -0,0 +1,152 @@
+///  _  _             _
+/// | || | __ _  _ _ | |__  ___  _  _  _ _   A Web Server Framework For Modern C++
+/// | __ |/ _` || '_|| '_ \/ _ \| || || '_|  https://github.com/griefzz/harbour
+/// |_||_|\__,_||_|  |_.__/\___/ \_,_||_|    License: MIT
+///
+
+#include <cassert>
+#include <stdexcept>
+
+#include <harbour/harbour.hpp>
+
+#define EXPECT(ok) \
+    assert((ok));  \
+    if (!(ok)) return 1;
+
+using Static = harbour::router::StaticTable<"/", "/health", "/api/v1/users", "/api/v1/users/me", "/about/">;
+
+// Static tables are resolved at compile time
+static_assert(Static::find("/health") == Static::index<"/health">());
+static_assert(Static::routes[Static::index<"/about">()] == "/about");
+static_assert(!Static::find("/missing"));
+
+auto main() -> int {
+    using namespace harbour;
+
+    // Static table lookups at runtime
+    EXPECT(Static::find("/") == 0);
+    EXPECT(Static::find("/api/v1/users/") == 2);
+    EXPECT(Static::find("/api/v1/users/me") == 3);
+    EXPECT(!Static::find("/api/v1/user"));
+
+    // Perfect hash sets find every key and nothing else
+    std::vector<std::string> keys;
+    for (int i = 0; i < 1000; i++) keys.push_back("/route/" + std::to_string(i));
+    const perfect_hash::Set<> set(keys);
+    for (std::size_t i = 0; i < keys.size(); i++) {
+        EXPECT(set.find(keys[i]) == i);
+    }
+    EXPECT(!set.find("/route/1000"));
+    EXPECT(!perfect_hash::Set<>().find("/"));
+
+    router::Router<int> r;
+    r.insert("/", 0);
+    r.insert("/users", 1);
+    r.insert("/users/me", 2);
+    r.insert("/users/:id", 3);
+    r.insert("/users/:id/posts/:post", 4);
+    r.insert("/users/:id/posts/latest", 5);
+    r.insert("/static/*file", 6);
+    r.insert("/search/", 7);
+    r.insert("upload", 8);
+
+    // Static routes and edge splitting
+    EXPECT(*r.match("/")->value == 0);
+    EXPECT(*r.match("/users")->value == 1);
+    EXPECT(*r.match("/users/")->value == 1);
+    EXPECT(*r.match("/search")->value == 7);
+    EXPECT(*r.match("/upload")->value == 8);
+    EXPECT(!r.match("/use"));
+    EXPECT(!r.match("/usersx"));
+
+    // Static routes are preferred over parameters
+    EXPECT(*r.match("/users/me")->value == 2);
+    EXPECT(r.match("/users/me")->params.empty());
+
+    // Single parameter
+    auto id = r.match("/users/42");
+    EXPECT(id && *id->value == 3);
+    EXPECT(id->pattern == "/users/:id");
+    EXPECT(id->params.size() == 1);
+    EXPECT(id->params.get("id") == "42");
+
+    // Multiple parameters, and backtracking out of a static prefix
+    auto post = r.match("/users/me/posts/7");
+    EXPECT(post && *post->value == 4);
+    EXPECT(post->params.get("id") == "me");
+    EXPECT(post->params.get("post") == "7");
+    EXPECT(*r.match("/users/42/posts/latest")->value == 5);
+    EXPECT(!r.match("/users/42/posts"));
+
+    // Catch-all captures the rest of the path
+    auto file = r.match("/static/css/site.css");
+    EXPECT(file && *file->value == 6);
+    EXPECT(file->params.get("file") == "css/site.css");
+
+    // Parameters are views into the matched path
+    const std::string path = "/users/abc";
+    auto view              = r.match(path);
+    EXPECT(view->params[0].value.data() == path.data() + 7);
+
+    // The frozen table matches exactly like the tree it was built from
+    const router::FrozenRouter<int> frozen(r);
+    for (auto p: {"/", "/users/", "/users/me", "/users/42", "/users/me/posts/7", "/users/42/posts/latest",
+                  "/users/42/posts", "/static/css/site.css", "/upload", "/use", "/missing"}) {
+        auto a = r.match(p);
+        auto b = frozen.match(p);
+        EXPECT(a.has_value() == b.has_value());
+        if (a) {
+            EXPECT(a->value == b->value);
+            EXPECT(a->params.size() == b->params.size());
+            EXPECT(a->params.size() == 0 || a->params[a->params.size() - 1].value == b->params[b->params.size() - 1].value);
+        }
+    }
+
+    // Per-method handlers on a single route
+    router::Methods<int> methods;
+    methods.insert(static_cast<http::MethodConstraint>(http::Method::GET), 1);
+    methods.insert(static_cast<http::MethodConstraint>(http::Method::POST | http::Method::PUT), 2);
+    EXPECT(*methods.find(http::Method::GET) == 1);
+    EXPECT(*methods.find(http::Method::PUT) == 2);
+    EXPECT(!methods.find(http::Method::DELETE));
+    EXPECT(!methods.find(http::Method::OPTIONS));
+    EXPECT(methods.allow() == "GET, POST, PUT, HEAD, OPTIONS");
+
+    // HEAD is served by the GET handler
+    EXPECT(*methods.find(http::Method::HEAD) == 1);
+
+    // Redocking a Method replaces it, an unconstrained handler serves the rest
+    methods.insert(static_cast<http::MethodConstraint>(http::Method::POST), 3);
+    methods.insert({}, 4);
+    EXPECT(*methods.find(http::Method::POST) == 3);
+    EXPECT(*methods.find(http::Method::PUT) == 2);
+    EXPECT(*methods.find(http::Method::DELETE) == 4);
+    EXPECT(*methods.find(http::Method::HEAD) == 1);
+    EXPECT(methods.allow() == "GET, POST, PUT, HEAD, DELETE, PATCH, OPTIONS");
+
+    // A HEAD handler of its own takes precedence over GET
+    methods.insert(static_cast<http::MethodConstraint>(http::Method::HEAD), 5);
+    EXPECT(*methods.find(http::Method::HEAD) == 5);
+    EXPECT(*methods.find(http::Method::GET) == 1);
+
+    // Malformed routes are rejected
+    auto rejects = [&](std::string_view route) {
+        try {
+            r.insert(route, -1);
+        } catch (const std::invalid_argument &) {
+            return true;
+        }
+        return false;
+    };
+    EXPECT(rejects("/files/*path/more"));
+    EXPECT(rejects("/api/v1/foo:bar"));
+    EXPECT(rejects("/api/:"));
+
+    // A route can't rename the parameters of an existing route
+    EXPECT(rejects("/users/:name"));
+    EXPECT(rejects("/users/:id/posts/:name"));
+    EXPECT(!rejects("/users/:id/"));
+    EXPECT(r.match("/users/42")->params[0].name == "id");
+
+    return 0;
+}
@@ -0,0 +1,156 @@
+///  _  _             _
+/// | || | __ _  _ _ | |__  ___  _  _  _ _   A Web Server Framework For Modern C++
+/// | __ |/ _` || '_|| '_ \/ _ \| || || '_|  https://github.com/griefzz/harbour
+/// |_||_|\__,_||_|  |_.__/\___/ \_,_||_|    License: MIT
+///
+
+#include <array>
+#include <cassert>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include <harbour/harbour.hpp>
+
+#define EXPECT(ok) \
+    assert((ok));  \
+    if (!(ok)) return 1;
+
+using namespace harbour;
+using detail::Ship;
+
+// Result of calling a Ship
+struct Called {
+    bool handled{false};///< True if the Ship produced a Response
+    Response resp;      ///< Response after the call
+    bool threw{false};  ///< True if the Ship threw
+};
+
+// Call a Ship the way Harbour does, awaiting it if it has to be
+auto call(const Ship &ship, const Request &req, Response resp = {}) -> Called {
+    Called called{.resp = std::move(resp)};
+    asio::io_context ctx(1);
+    asio::co_spawn(ctx, [&]() -> asio::awaitable<void> {
+        try {
+            called.handled = ship.is_async() ? co_await ship.async_call(req, called.resp) : ship(req, called.resp);
+        } catch (const std::runtime_error &) {
+            called.threw = true;
+        } }, asio::detached);
+    ctx.run();
+    return called;
+}
+
+// Callable counting its live copies
+struct Tracked {
+    static inline int live = 0;
+    std::array<char, 4 * Ship::BufferSize> padding{};///< Too large for the inline buffer
+
+    Tracked() { live++; }
+    Tracked(const Tracked &) { live++; }
+    Tracked(Tracked &&) noexcept { live++; }
+    ~Tracked() { live--; }
+
+    auto operator()() const -> Response { return Response("tracked"); }
+};
+
+auto main() -> int {
+    const std::string msg = "GET /ships HTTP/1.1\r\n\r\n";
+    const auto req        = *Request::create(nullptr, msg.data(), msg.size());
+
+    // Every return shape reports whether a Response was produced
+    {
+        EXPECT(call(Ship([] { return Response("sync"); }), req).resp.data == "sync");
+        EXPECT(call(Ship([]() -> std::optional<Response> { return Response("some"); }), req).resp.data == "some");
+        EXPECT(!call(Ship([]() -> std::optional<Response> { return std::nullopt; }), req).handled);
+        EXPECT(!call(Ship([](Response &resp) { resp.data = "written"; }), req).handled);
+        EXPECT(call(Ship([](Response &resp) { resp.data = "written"; }), req).resp.data == "written");
+
+        const auto handled = call(Ship([](Response &resp) { resp.data = "in place"; return detail::Handled{true}; }), req);
+        EXPECT(handled.handled && handled.resp.data == "in place");
+        EXPECT(!call(Ship([] { return detail::Handled{false}; }), req).handled);
+    }
+
+    // Awaitable Ships return the same shapes through async_call
+    {
+        const Ship response([](const Request &r) -> asio::awaitable<Response> { co_return Response(std::string(r.path)); });
+        EXPECT(response.is_async());
+        const auto called = call(response, req);
+        EXPECT(called.handled && called.resp.data == "/ships");
+
+        EXPECT(!call(Ship([]() -> asio::awaitable<std::optional<Response>> { co_return std::nullopt; }), req).handled);
+        EXPECT(call(Ship([]() -> asio::awaitable<std::optional<Response>> { co_return Response("later"); }), req).resp.data == "later");
+
+        const auto written = call(Ship([](Response &resp) -> asio::awaitable<void> { resp.data = "awaited"; co_return; }), req);
+        EXPECT(!written.handled && written.resp.data == "awaited");
+        EXPECT(call(Ship([]() -> asio::awaitable<detail::Handled> { co_return detail::Handled{true}; }), req).handled);
+        EXPECT(!Ship([] { return Response(); }).is_async());
+    }
+
+    // Arguments are passed in the order the Ship takes them
+    {
+        const auto called = call(Ship([](Response &resp, const Request &r) { return resp.with_data(std::string(r.path)); }), req, Response("prefix"));
+        EXPECT(called.resp.data == "/ships");
+    }
+
+    // Ships larger than the inline buffer live on the heap, every copy is destroyed once
+    {
+        {
+            const Ship big{Tracked{}};
+            EXPECT(Tracked::live == 1);
+            Ship copy(big);
+            Ship moved(std::move(copy));
+            EXPECT(Tracked::live == 2);
+            EXPECT(call(big, req).resp.data == "tracked" && call(moved, req).resp.data == "tracked");
+
+            moved = big;
+            EXPECT(Tracked::live == 2);
+            moved = Ship([] { return Response("small"); });
+            EXPECT(Tracked::live == 1 && call(moved, req).resp.data == "small");
+        }
+        EXPECT(Tracked::live == 0);
+    }
+
+    // Small Ships are stored inline and copied with their state
+    {
+        const std::array<char, Ship::BufferSize> state{'s', 'm', 'a', 'l', 'l'};
+        const Ship small([state] { return Response(std::string(state.data())); });
+        auto copy = small;
+        EXPECT(call(copy, req).resp.data == "small");
+    }
+
+    // Move-only Ships are shared by their copies
+    {
+        auto count = std::make_unique<int>(0);
+        const Ship counter([count = std::move(count)] { return Response(std::to_string(++*count)); });
+        const auto copy   = counter;
+        const auto first  = call(counter, req);
+        const auto second = call(copy, req);
+        EXPECT(first.resp.data == "1" && second.resp.data == "2");
+
+        auto resource = std::make_unique<std::string>("moved");
+        const Ship async([resource = std::move(resource)]() -> asio::awaitable<Response> { co_return Response(*resource); });
+        EXPECT(async.is_async() && call(async, req).resp.data == "moved");
+    }
+
+    // Exceptions thrown by a Ship reach its caller and leave it callable
+    {
+        bool fail = true;
+        const Ship sync([&fail] {
+            if (fail) throw std::runtime_error("sync");
+            return Response("recovered");
+        });
+        EXPECT(call(sync, req).threw);
+        fail = false;
+        EXPECT(call(sync, req).resp.data == "recovered");
+
+        const Ship async([]() -> asio::awaitable<Response> {
+            throw std::runtime_error("async");
+            co_return Response();
+        });
+        EXPECT(call(async, req).threw);
+    }
+
+    return 0;
+}
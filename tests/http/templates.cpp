@@ -0,0 +1,111 @@
+///  _  _             _
+/// | || | __ _  _ _ | |__  ___  _  _  _ _   A Web Server Framework For Modern C++
+/// | __ |/ _` || '_|| '_ \/ _ \| || || '_|  https://github.com/griefzz/harbour
+/// |_||_|\__,_||_|  |_.__/\___/ \_,_||_|    License: MIT
+///
+
+#include <cassert>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include <harbour/harbour.hpp>
+
+#define EXPECT(ok) \
+    assert((ok));  \
+    if (!(ok)) return 1;
+
+using namespace harbour;
+
+// Check that compiling a template throws
+auto malformed(std::string_view source) -> bool {
+    try {
+        tmpl::Template t(source);
+    } catch (const std::invalid_argument &) {
+        return true;
+    }
+    return false;
+}
+
+auto main() -> int {
+    // Slots are escaped unless they are raw
+    const tmpl::Value page = tmpl::Object{
+            {"title", "Ships & Sailors"},
+            {"html", "<b>bold</b>"},
+            {"count", 3},
+            {"ratio", 0.5},
+            {"admin", false},
+            {"captain", tmpl::Object{{"name", "Pegleg"}}},
+            {"crew", tmpl::List{tmpl::Object{{"name", "Bobby"}}, tmpl::Object{{"name", "<Tommy>"}}}},
+            {"tags", tmpl::List{"a", "b"}},
+            {"empty", tmpl::List{}},
+    };
+
+    EXPECT(tmpl::Template("{{title}}").render(page) == "Ships &amp; Sailors");
+    EXPECT(tmpl::Template("{{{html}}}|{{& html}}").render(page) == "<b>bold</b>|<b>bold</b>");
+    EXPECT(tmpl::Template("{{ count }} {{ratio}} {{admin}} {{missing}}!").render(page) == "3 0.5 false !");
+    EXPECT(tmpl::Template("{{captain.name}}").render(page) == "Pegleg");
+    EXPECT(tmpl::Template("a{{! comment }}b").render(page) == "ab");
+
+    // Sections loop over Lists and look names up in enclosing sections
+    EXPECT(tmpl::Template("{{#crew}}<p>{{name}} of {{title}}</p>{{/crew}}").render(page) ==
+           "<p>Bobby of Ships &amp; Sailors</p><p>&lt;Tommy&gt; of Ships &amp; Sailors</p>");
+    EXPECT(tmpl::Template("{{#tags}}[{{.}}]{{/tags}}").render(page) == "[a][b]");
+    EXPECT(tmpl::Template("{{#captain}}{{name}}{{/captain}}").render(page) == "Pegleg");
+    EXPECT(tmpl::Template("{{#admin}}admin{{/admin}}{{^admin}}crew{{/admin}}").render(page) == "crew");
+    EXPECT(tmpl::Template("{{^empty}}none{{/empty}}{{#empty}}some{{/empty}}").render(page) == "none");
+    EXPECT(tmpl::Template("{{#crew}}{{#tags}}{{name}}{{.}} {{/tags}}{{/crew}}").render(page) == "Bobbya Bobbyb &lt;Tommy&gt;a &lt;Tommy&gt;b ");
+
+    // Rendering appends so a buffer can be reused
+    const tmpl::Template greeting("Hello {{title}}!");
+    std::string buffer = ">";
+    greeting.render(page, buffer);
+    EXPECT(buffer == ">Hello Ships &amp; Sailors!");
+
+    // Renderers pause at the limit and resume where they left off
+    const tmpl::Template nested("<ul>{{#crew}}<li>{{name}}{{#tags}}[{{.}}]{{/tags}}{{^admin}}!{{/admin}}</li>{{/crew}}</ul>{{#empty}}x{{/empty}}");
+    const auto whole = nested.render(page);
+    for (std::size_t limit = 1; limit < 8; limit++) {
+        tmpl::Template::Renderer renderer(nested, page);
+        std::string streamed, chunk;
+        for (bool more = true; more;) {
+            chunk.clear();
+            more = renderer.next(chunk, limit);
+            EXPECT(chunk.size() <= limit + 13);
+            streamed += chunk;
+        }
+        EXPECT(streamed == whole);
+    }
+
+    // Streamed bodies render while they are read
+    const auto body = response::Body(tmpl::stream(std::make_shared<const tmpl::Template>("{{#tags}}<i>{{.}}</i>{{/tags}}"), page));
+    EXPECT(body.stream() && body.size() == 0);
+    const auto rendered = body.string();
+    EXPECT(rendered == "<i>a</i><i>b</i>");
+
+    // Malformed templates are rejected when compiled
+    EXPECT(malformed("{{#crew}}"));
+    EXPECT(malformed("{{#crew}}{{/tags}}"));
+    EXPECT(malformed("{{/crew}}"));
+    EXPECT(malformed("{{title"));
+    EXPECT(malformed("{{}}"));
+
+    // Files are compiled once and again when they change
+    const auto path = std::filesystem::temp_directory_path() / "harbour_templates_test.html";
+    std::ofstream(path) << "<h1>{{title}}</h1>";
+    const auto first = tmpl::compile_file(path);
+    EXPECT(first && first->render(page) == "<h1>Ships &amp; Sailors</h1>");
+    EXPECT(tmpl::compile_file(path) == first);
+
+    std::ofstream(path) << "<h2>{{title}}</h2>";
+    std::filesystem::last_write_time(path, std::filesystem::last_write_time(path) + std::chrono::seconds(1));
+    const auto second = tmpl::compile_file(path);
+    EXPECT(second && second != first && second->render(page) == "<h2>Ships &amp; Sailors</h2>");
+
+    std::filesystem::remove(path);
+    EXPECT(!tmpl::compile_file(path));
+    return 0;
+}
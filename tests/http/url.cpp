@@ -0,0 +1,57 @@
+///  _  _             _
+/// | || | __ _  _ _ | |__  ___  _  _  _ _   A Web Server Framework For Modern C++
+/// | __ |/ _` || '_|| '_ \/ _ \| || || '_|  https://github.com/griefzz/harbour
+/// |_||_|\__,_||_|  |_.__/\___/ \_,_||_|    License: MIT
+///
+
+#include <cassert>
+
+#include <harbour/harbour.hpp>
+
+#define EXPECT(ok) \
+    assert((ok));  \
+    if (!(ok)) return 1;
+
+static const std::string get_message =
+        "GET /users?id=1&name=bob%20smith&tag=a+b&empty&bad=%zz#top HTTP/1.1\r\n"
+        "Host: github.com\r\n"
+        "\r\n";
+
+auto main() -> int {
+    using namespace harbour::request;
+
+    // Split a target into path and query
+    auto [path, query] = url::split("/users?id=1#frag");
+    EXPECT(path == "/users");
+    EXPECT(query == "id=1");
+    EXPECT(url::split("/users").second.empty());
+
+    // Percent-decoding, long enough to take the vectorized path
+    EXPECT(url::decode("hello%20world") == "hello world");
+    EXPECT(url::decode("a+b") == "a b");
+    EXPECT(url::decode("a+b", false) == "a+b");
+    EXPECT(url::decode("100%") == "100%");
+    EXPECT(url::decode("%E4%B8%AD%E5%9B%BD %2Fthe%2Fquick%2Fbrown%2Ffox%2Fjumps%2Fover%2Fthe%2Flazy%2Fdog") == "\xE4\xB8\xAD\xE5\x9B\xBD /the/quick/brown/fox/jumps/over/the/lazy/dog");
+
+    // Query maps allocate from the Arena they were given
+    harbour::memory::Arena arena;
+    const auto params = url::parse_query("name=bob%20smith%20the%20builder%20of%20many%20things", arena.allocator());
+    EXPECT(params.find("name")->second == "bob smith the builder of many things");
+    EXPECT(params.find("name")->second.get_allocator().resource() == arena.resource());
+
+    std::shared_ptr<harbour::server::Socket> sock;
+    if (auto req = harbour::Request::create(sock, get_message.data(), get_message.size())) {
+        EXPECT(req->url == "/users?id=1&name=bob%20smith&tag=a+b&empty&bad=%zz#top");
+        EXPECT(req->path == "/users");
+        EXPECT(req->query_string == "id=1&name=bob%20smith&tag=a+b&empty&bad=%zz");
+        EXPECT(req->query("id") == "1");
+        EXPECT(req->query("name") == "bob smith");
+        EXPECT(req->query("tag") == "a b");
+        EXPECT(req->query("empty") == "");
+        EXPECT(req->query("bad") == "%zz");
+        EXPECT(!req->query("missing"));
+        return 0;
+    }
+
+    return 1;
+}
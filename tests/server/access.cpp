@@ -0,0 +1,152 @@
+///  _  _             _
+/// | || | __ _  _ _ | |__  ___  _  _  _ _   A Web Server Framework For Modern C++
+/// | __ |/ _` || '_|| '_ \/ _ \| || || '_|  https://github.com/griefzz/harbour
+/// |_||_|\__,_||_|  |_.__/\___/ \_,_||_|    License: MIT
+///
+
+#include <cassert>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <harbour/log/access.hpp>
+
+#define EXPECT(ok) \
+    assert((ok));  \
+    if (!(ok)) return 1;
+
+using namespace harbour;
+using namespace harbour::log;
+
+// Read a whole file
+auto slurp(const std::filesystem::path &path) -> std::string {
+    std::ifstream in(path, std::ios::binary);
+    return {std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+}
+
+// Build a Record for a route
+auto make(std::string_view route, std::uint16_t status) -> access::Record {
+    access::Record record;
+    record.timestamp = 1700000000000000;
+    record.bytes     = 1234;
+    record.latency   = 42;
+    record.status    = status;
+    record.method    = http::Method::POST;
+    record.set_route(route);
+    record.set_peer({asio::ip::make_address("192.168.1.7"), 5555});
+    return record;
+}
+
+auto main() -> int {
+    const auto directory = std::filesystem::temp_directory_path() / "harbour_access_test";
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+
+    // Binary logs are a FileHeader followed by raw Records
+    {
+        const auto path = directory / "binary.log";
+        {
+            access::Log log({.path = path});
+            int queued = 0;
+            for (int i = 0; i < 10; i++) queued += log.record(make("/users/:id", 200));
+            log.flush();
+            EXPECT(queued == 10);
+            const auto stats = log.stats();
+            EXPECT(stats.written == 10 && stats.dropped == 0);
+        }
+
+        const auto data = slurp(path);
+        EXPECT(data.size() == sizeof(access::FileHeader) + 10 * sizeof(access::Record));
+
+        access::FileHeader header;
+        std::memcpy(&header, data.data(), sizeof(header));
+        EXPECT(std::string_view(header.magic.data(), 4) == "HBAL" && header.record_size == sizeof(access::Record));
+
+        access::Record record;
+        std::memcpy(&record, data.data() + sizeof(header), sizeof(record));
+        EXPECT(record.get_route() == "/users/:id" && record.status == 200 && record.bytes == 1234);
+        EXPECT(record.method == http::Method::POST && record.peer() == "192.168.1.7" && record.port == 5555);
+    }
+
+    // Reused Records don't keep bytes of a longer previous route
+    {
+        auto record = make("/a/much/longer/route/than/the/next", 200);
+        record.set_route("/b");
+        const auto rest = std::string_view(record.route, sizeof(record.route)).substr(2);
+        EXPECT(record.get_route() == "/b" && rest.find_first_not_of('\0') == std::string_view::npos);
+    }
+
+    // JSON lines are escaped and one Record per line
+    {
+        const auto path = directory / "access.jsonl";
+        {
+            access::Log log({.path = path, .format = access::Format::JsonLines});
+            log.record(make("/say/\"hi\"", 404));
+            auto v6 = make("/", 200);
+            v6.set_peer({asio::ip::make_address("::1"), 80});
+            log.record(v6);
+        }
+
+        const auto data = slurp(path);
+        EXPECT(data == R"({"ts":1700000000000000,"method":"POST","route":"/say/\"hi\"","status":404,"bytes":1234,"latency_us":42,"peer":"192.168.1.7","port":5555})"
+                       "\n"
+                       R"({"ts":1700000000000000,"method":"POST","route":"/","status":200,"bytes":1234,"latency_us":42,"peer":"::1","port":80})"
+                       "\n");
+    }
+
+    // Long routes are truncated
+    {
+        const auto record = make(std::string(HARBOUR_ACCESS_ROUTE_SIZE * 2, 'r'), 200);
+        EXPECT(record.get_route() == std::string(HARBOUR_ACCESS_ROUTE_SIZE, 'r'));
+    }
+
+    // Routes are sampled by pattern, others use the default rate
+    {
+        access::Log log({.path = directory / "sampled.log", .sample = 2, .routes = {{"/health", 100}, {"/orders", 1}}});
+        int health = 0, orders = 0, other = 0;
+        for (int i = 0; i < 1000; i++) {
+            health += log.sample("/health");
+            orders += log.sample("/orders");
+            other += log.sample("/users/:id");
+        }
+        EXPECT(health == 10 && orders == 1000 && other == 500);
+        EXPECT(log.stats().sampled == 990 + 500);
+    }
+
+    // Files are rotated once they would grow past max_bytes, keeping max_files old files
+    {
+        const auto path    = directory / "rotated.log";
+        const auto records = 4;
+        access::Log log({.path      = path,
+                         .max_bytes = sizeof(access::FileHeader) + records * sizeof(access::Record),
+                         .max_files = 2});
+        for (int batch = 0; batch < 4; batch++) {
+            for (int i = 0; i < records; i++) log.record(make("/", 200));
+            log.flush();
+        }
+
+        const auto stats = log.stats();
+        EXPECT(stats.rotated == 3 && stats.written == 16);
+        EXPECT(std::filesystem::exists(path));
+        EXPECT(std::filesystem::exists(directory / "rotated.log.1"));
+        EXPECT(std::filesystem::exists(directory / "rotated.log.2"));
+        EXPECT(!std::filesystem::exists(directory / "rotated.log.3"));
+        EXPECT(std::filesystem::file_size(path) == sizeof(access::FileHeader) + records * sizeof(access::Record));
+    }
+
+    // A full queue drops new records instead of blocking
+    {
+        access::Log log({.path = directory / "full.log", .batch = 1000, .interval = std::chrono::hours(1), .capacity = 4});
+        int queued = 0;
+        for (int i = 0; i < 8; i++) queued += log.record(make("/", 200));
+        EXPECT(queued == 4 && log.stats().dropped == 4);
+        log.flush();
+        EXPECT(log.stats().written == 4);
+    }
+
+    std::filesystem::remove_all(directory);
+    return 0;
+}
@@ -1,6 +1,8 @@
 #include <cassert>
+#include <chrono>
 #include <vector>
 #include <string>
+#include <string_view>
 
 #include <asio.hpp>
 #include <asio/co_spawn.hpp>
@@ -8,6 +10,7 @@
 #include <asio/ip/tcp.hpp>
 #include <asio/ip/address.hpp>
 #include <asio/ssl.hpp>
+#include <fmt/format.h>
 
 #include <harbour/harbour.hpp>
 
@@ -25,12 +28,58 @@ auto make_server() {
     std::vector<harbour::detail::Ship> ships;
     auto ship_handler = [&](const Request &req, Response &resp) -> asio::awaitable<void> {
         resp = Echo(req);
+
+        // Three chunks of a body of unknown length
+        if (req.path == "/stream") {
+            resp      = Response(http::Status::OK);
+            resp.data = response::Stream{[sent = 0](std::string &buffer, std::size_t) mutable {
+                buffer += "part";
+                return ++sent < 3;
+            }};
+        }
         co_return;
     };
     auto settings = server::Settings::defaults();
     return server::Server(ship_handler, settings, ships);
 }
 
+// Expected Response to an echoed Request
+auto echo(std::string_view request, std::string_view connection = "keep-alive") -> std::string {
+    return fmt::format("HTTP/1.1 200 OK\nContent-Type: text/html; charset=utf-8\nConnection: {}\nContent-Length: {}\n\n{}",
+                       connection, request.size(), request);
+}
+
+// Write each part of a stream with a pause in between, then read exactly the expected Response.
+// If closes is set the server must hang up after it.
+auto exchange(const server::Settings &settings, std::vector<std::string> parts, std::string expected, bool closes = false) -> asio::awaitable<bool> {
+    try {
+        auto executor = co_await asio::this_coro::executor;
+        tcp::socket socket(executor);
+        
+        tcp::endpoint endpoint(asio::ip::make_address("127.0.0.1"), settings.port);
+        co_await socket.async_connect(endpoint, asio::use_awaitable);
+
+        for (const auto &part: parts) {
+            co_await async_write(socket, asio::buffer(part), asio::use_awaitable);
+            asio::steady_timer timer(executor, std::chrono::milliseconds(20));
+            co_await timer.async_wait(asio::use_awaitable);
+        }
+
+        std::string got(expected.size(), '\0');
+        co_await asio::async_read(socket, asio::buffer(got), asio::use_awaitable);
+        if (got != expected) co_return false;
+        if (!closes) co_return true;
+
+        asio::error_code ec;
+        char byte;
+        co_await socket.async_read_some(asio::buffer(&byte, 1), asio::redirect_error(asio::use_awaitable, ec));
+        co_return ec == asio::error::eof;
+    } catch (const std::exception &e) {
+        log::critical("client exception: {}", e.what());
+        co_return false;
+    }
+}
+
 auto client(asio::io_context &io_context, const server::Settings &settings) -> asio::awaitable<bool> {
     try {
         auto executor = co_await asio::this_coro::executor;
@@ -44,8 +93,49 @@ auto client(asio::io_context &io_context, const server::Settings &settings) -> a
         std::array<char, 4096> data;
         auto n = co_await socket.async_read_some(asio::buffer(data), asio::use_awaitable);
         auto got = std::string_view(data.data(), n);
-        
-        co_return got == want;
+        if (got != want) co_return false;
+
+        // A Request split across reads is buffered until its head and body are complete
+        const std::string post = "POST /split HTTP/1.1\r\nContent-Length: 11\r\n\r\nhello world";
+        std::vector<std::string> parts{post.substr(0, 10), post.substr(10, 40), post.substr(50)};
+        if (!co_await exchange(settings, std::move(parts), echo(post))) co_return false;
+
+        // Pipelined Requests in a single write are all answered in order
+        const std::string first  = "GET /first HTTP/1.1\r\n\r\n";
+        const std::string second = "POST /second HTTP/1.1\r\nContent-Length: 5\r\n\r\nhello";
+        std::vector<std::string> pipelined{first + second};
+        if (!co_await exchange(settings, std::move(pipelined), echo(first) + echo(second))) co_return false;
+
+        // Responses to HEAD keep the Content-Length of the full body but leave the body out
+        const std::string head = "HEAD /head HTTP/1.1\r\n\r\n";
+        const auto headers     = echo(head).substr(0, echo(head).size() - head.size());
+        std::vector<std::string> headed{head + first};
+        if (!co_await exchange(settings, std::move(headed), headers + echo(first))) co_return false;
+
+        // HTTP/1.0 connections close after the Response unless the client asks to keep them open
+        const std::string old = "GET /old HTTP/1.0\r\n\r\n";
+        std::vector<std::string> once{old};
+        if (!co_await exchange(settings, std::move(once), echo(old, "close"), true)) co_return false;
+
+        const std::string kept = "GET /kept HTTP/1.0\r\nConnection: keep-alive\r\n\r\n";
+        std::vector<std::string> twice{kept + kept};
+        if (!co_await exchange(settings, std::move(twice), echo(kept) + echo(kept))) co_return false;
+
+        // Streams are chunked for HTTP/1.1 clients, HTTP/1.0 clients get the raw body ended by closing the connection
+        const std::string chunked = "GET /stream HTTP/1.1\r\n\r\n";
+        std::vector<std::string> streamed{chunked + first};
+        const std::string chunks = "HTTP/1.1 200 OK\nConnection: keep-alive\nTransfer-Encoding: chunked\n\n"
+                                   "4\r\npart\r\n4\r\npart\r\n4\r\npart\r\n0\r\n\r\n";
+        if (!co_await exchange(settings, std::move(streamed), chunks + echo(first))) co_return false;
+
+        const std::string unframed = "GET /stream HTTP/1.0\r\nConnection: keep-alive\r\n\r\n";
+        std::vector<std::string> raw{unframed};
+        if (!co_await exchange(settings, std::move(raw), "HTTP/1.1 200 OK\nConnection: close\n\npartpartpart", true)) co_return false;
+
+        // HTTP/1.1 connections close when the client asks to
+        const std::string last = "GET /last HTTP/1.1\r\nConnection: close\r\n\r\n";
+        std::vector<std::string> closing{first + last};
+        co_return co_await exchange(settings, std::move(closing), echo(first) + echo(last, "close"), true);
     } catch (const std::exception &e) {
         log::critical("client exception: {}", e.what());
         co_return false;
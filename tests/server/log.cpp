@@ -0,0 +1,61 @@
+///  _  _             _
+/// | || | __ _  _ _ | |__  ___  _  _  _ _   A Web Server Framework For Modern C++
+/// | __ |/ _` || '_|| '_ \/ _ \| || || '_|  https://github.com/griefzz/harbour
+/// |_||_|\__,_||_|  |_.__/\___/ \_,_||_|    License: MIT
+///
+
+#include <cassert>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <harbour/log/log.hpp>
+
+#define EXPECT(ok) \
+    assert((ok));  \
+    if (!(ok)) return 1;
+
+using namespace harbour;
+
+auto main() -> int {
+    // Capture stdout in a file
+    const auto path = std::filesystem::temp_directory_path() / "harbour_log_test.txt";
+    if (!std::freopen(path.string().c_str(), "w", stdout)) return 1;
+
+    log::info("hello {}", "harbour");
+    log::warn("plain message");
+
+    // Records from many threads are all written, in order per thread
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++)
+        threads.emplace_back([t] {
+            for (int i = 0; i < 100; i++) log::info("thread {} record {}", t, i);
+        });
+    for (auto &thread: threads) thread.join();
+
+    // Messages longer than a record are truncated
+    log::critical("{}", std::string(HARBOUR_LOG_RECORD_SIZE * 2, 'x'));
+    log::flush();
+
+    const auto stats = log::stats();
+    EXPECT(stats.written + stats.dropped == 403);
+
+    std::ifstream in(path);
+    const std::string out((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    EXPECT(out.find("hello harbour") != std::string::npos);
+    EXPECT(out.find("plain message") != std::string::npos);
+    EXPECT(out.find(std::string(HARBOUR_LOG_RECORD_SIZE, 'x') + "…") != std::string::npos);
+    EXPECT(out.find(std::string(HARBOUR_LOG_RECORD_SIZE + 1, 'x')) == std::string::npos);
+    for (int t = 0; t < 4 && stats.dropped == 0; t++) {
+        const auto first = out.find(fmt::format("thread {} record 0\x1b", t));
+        const auto last  = out.find(fmt::format("thread {} record 99\x1b", t));
+        EXPECT(first != std::string::npos && last != std::string::npos && first < last);
+    }
+
+    std::filesystem::remove(path);
+    return 0;
+}
@@ -0,0 +1,78 @@
+///  _  _             _
+/// | || | __ _  _ _ | |__  ___  _  _  _ _   A Web Server Framework For Modern C++
+/// | __ |/ _` || '_|| '_ \/ _ \| || || '_|  https://github.com/griefzz/harbour
+/// |_||_|\__,_||_|  |_.__/\___/ \_,_||_|    License: MIT
+///
+
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include <harbour/harbour.hpp>
+
+#define EXPECT(ok) \
+    assert((ok));  \
+    if (!(ok)) return 1;
+
+using namespace harbour;
+
+// Synchronous Ship that tracks how many copies of it run at once
+struct Slow {
+    auto operator()(const Request &) -> Response {
+        const auto now = ++active;
+        for (auto seen = peak.load(); now > seen && !peak.compare_exchange_weak(seen, now);) {}
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        --active;
+        return Response("slow");
+    }
+
+    std::atomic<int> &active;
+    std::atomic<int> &peak;
+};
+
+auto main() -> int {
+    asio::io_context ctx(1);
+    const auto io = std::this_thread::get_id();
+    const auto req = *Request::create(nullptr, "GET / HTTP/1.1\r\n\r\n", 18);
+
+    // Offloaded work runs on a worker and resumes on the io thread
+    int value = 0;
+    std::thread::id worker, resumed;
+    bool rethrown = false;
+    asio::co_spawn(ctx, [&]() -> awaitable<void> {
+        value   = co_await offload([&] { worker = std::this_thread::get_id(); return 42; });
+        resumed = std::this_thread::get_id();
+        co_await offload([] {});
+        try {
+            co_await offload([]() -> int { throw std::runtime_error("failed"); });
+        } catch (const std::runtime_error &) {
+            rethrown = true;
+        }
+    }, asio::detached);
+    ctx.run();
+    EXPECT(value == 42);
+    EXPECT(worker != io && resumed == io);
+    EXPECT(rethrown);
+
+    // Blocking Ships never run more at once than their Pool has threads, even when its queue overflows
+    std::atomic<int> active{0}, peak{0};
+    pool::Pool limited({.threads = 2, .capacity = 1});
+    detail::Ship ship(blocking(limited, Slow{active, peak}));
+    EXPECT(ship.is_async());
+
+    int handled = 0;
+    ctx.restart();
+    for (int i = 0; i < 8; i++)
+        asio::co_spawn(ctx, [&]() -> awaitable<void> {
+            Response resp;
+            if (co_await ship.async_call(req, resp) && resp.data == "slow") handled++;
+        }, asio::detached);
+    ctx.run();
+    EXPECT(handled == 8);
+    EXPECT(peak >= 1 && peak <= 2);
+    EXPECT(limited.stats().overflowed > 0);
+    return 0;
+}
@@ -0,0 +1,86 @@
+///  _  _             _
+/// | || | __ _  _ _ | |__  ___  _  _  _ _   A Web Server Framework For Modern C++
+/// | __ |/ _` || '_|| '_ \/ _ \| || || '_|  https://github.com/griefzz/harbour
+/// |_||_|\__,_||_|  |_.__/\___/ \_,_||_|    License: MIT
+///
+
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <thread>
+
+#include <harbour/pool.hpp>
+
+#define EXPECT(ok) \
+    assert((ok));  \
+    if (!(ok)) return 1;
+
+using namespace harbour;
+
+auto main() -> int {
+    // Every posted task runs before the Pool is destroyed
+    std::atomic<int> count{0};
+    {
+        pool::Pool pool({.threads = 4, .capacity = 4096});
+        for (int i = 0; i < 1000; i++)
+            pool.post([&] { count++; });
+    }
+    EXPECT(count == 1000);
+
+    // Move-only tasks are accepted
+    {
+        pool::Pool pool({.threads = 2, .capacity = 16});
+        std::promise<int> promise;
+        auto result = promise.get_future();
+        pool.post([value = std::make_unique<int>(42), promise = std::move(promise)]() mutable { promise.set_value(*value); });
+        const auto value = result.get();
+        EXPECT(value == 42);
+    }
+
+    // A full queue still hands tasks to the workers and counts them as overflowed
+    {
+        pool::Pool pool({.threads = 1, .capacity = 2});
+        std::promise<void> release;
+        auto gate = release.get_future().share();
+        std::atomic<bool> started{false};
+        pool.post([&, gate] { started = true; gate.wait(); });
+        while (!started) std::this_thread::yield();
+
+        pool.post([] {});
+        pool.post([] {});
+        std::promise<std::thread::id> ran;
+        auto worker = ran.get_future();
+        pool.post([&] { ran.set_value(std::this_thread::get_id()); });
+
+        const auto stats = pool.stats();
+        EXPECT(stats.queued == 3 && stats.max_queued == 3);
+        EXPECT(stats.running == 1 && stats.overflowed == 1 && stats.submitted == 4);
+        release.set_value();
+        const auto id = worker.get();
+        EXPECT(id != std::this_thread::get_id());
+    }
+
+    // Tasks queued on a busy worker are stolen by idle ones
+    {
+        pool::Pool pool({.threads = 4, .capacity = 1024});
+        std::atomic<int> done{0};
+        pool.post([&] {
+            for (int i = 0; i < 64; i++)
+                pool.post([&] {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                    done++;
+                });
+        });
+        while (done < 64) std::this_thread::yield();
+        const auto stats = pool.stats();
+        EXPECT(stats.stolen > 0);
+        EXPECT(stats.completed >= 64);
+    }
+
+    // The shared pool is started once
+    EXPECT(&pool::blocking() == &pool::blocking());
+    EXPECT(pool::blocking().size() >= 1);
+    return 0;
+}
@@ -0,0 +1,69 @@
+///  _  _             _
+/// | || | __ _  _ _ | |__  ___  _  _  _ _   A Web Server Framework For Modern C++
+/// | __ |/ _` || '_|| '_ \/ _ \| || || '_|  https://github.com/griefzz/harbour
+/// |_||_|\__,_||_|  |_.__/\___/ \_,_||_|    License: MIT
+///
+
+#include <cassert>
+#include <memory>
+#include <string>
+
+#include <asio.hpp>
+#include <fmt/format.h>
+
+#include <harbour/server/socket.hpp>
+
+#define EXPECT(ok) \
+    assert((ok));  \
+    if (!(ok)) return 1;
+
+using namespace harbour;
+using asio::ip::tcp;
+
+// Accept a loopback connection from client
+auto accept(tcp::acceptor &acceptor, tcp::socket &client) -> std::shared_ptr<server::Socket> {
+    client.connect(acceptor.local_endpoint());
+    return std::make_shared<server::Socket>(acceptor.accept());
+}
+
+auto main() -> int {
+    asio::io_context io;
+
+    // The peer is captured at accept and formatted on demand
+    {
+        tcp::acceptor acceptor(io, {asio::ip::make_address("127.0.0.1"), 0});
+        tcp::socket client(io);
+        const auto socket = accept(acceptor, client);
+        const auto port   = client.local_endpoint().port();
+
+        EXPECT(socket->address() == "127.0.0.1");
+        EXPECT(socket->port() == port);
+        EXPECT(socket->endpoint() == client.local_endpoint());
+        EXPECT(fmt::format("{}:{}", socket->address(), socket->port()) == fmt::format("127.0.0.1:{}", port));
+
+        // The peer is still known after the connection is gone
+        client.close();
+        std::get<server::TcpSocket>(socket->socket()).close();
+        EXPECT(socket->address() == "127.0.0.1" && socket->port() == port);
+        const std::string copy = socket->address();
+        EXPECT(copy == "127.0.0.1");
+    }
+
+    // IPv6 peers are formatted too, when the host supports them
+    try {
+        tcp::acceptor acceptor(io, {asio::ip::make_address("::1"), 0});
+        tcp::socket client(io);
+        const auto socket = accept(acceptor, client);
+        EXPECT(socket->address() == "::1");
+        EXPECT(socket->port() == client.local_endpoint().port());
+    } catch (const asio::system_error &) {
+    }
+
+    // Sockets that were never connected have no peer
+    {
+        const server::Socket socket(tcp::socket{io});
+        EXPECT(socket.address() == "" && socket.port() == 0);
+    }
+
+    return 0;
+}
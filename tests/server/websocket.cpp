@@ -0,0 +1,192 @@
+///  _  _             _
+/// | || | __ _  _ _ | |__  ___  _  _  _ _   A Web Server Framework For Modern C++
+/// | __ |/ _` || '_|| '_ \/ _ \| || || '_|  https://github.com/griefzz/harbour
+/// |_||_|\__,_||_|  |_.__/\___/ \_,_||_|    License: MIT
+///
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <asio.hpp>
+
+#include <harbour/websocket.hpp>
+
+#define EXPECT(ok) \
+    assert((ok));  \
+    if (!(ok)) return 1;
+
+using namespace harbour;
+using namespace harbour::websocket;
+using asio::ip::tcp;
+
+// Encode a masked client frame
+auto frame(std::string_view payload, Opcode opcode = Opcode::Text, bool fin = true) -> std::string {
+    std::string out;
+    out += static_cast<char>((fin ? 0x80 : 0x00) | static_cast<uint8_t>(opcode));
+    if (payload.size() <= 125) {
+        out += static_cast<char>(0x80 | payload.size());
+    } else if (payload.size() <= 65535) {
+        out += static_cast<char>(0x80 | 126);
+        out += static_cast<char>(payload.size() >> 8);
+        out += static_cast<char>(payload.size() & 0xFF);
+    } else {
+        out += static_cast<char>(0x80 | 127);
+        for (int i = 7; i >= 0; i--) out += static_cast<char>((payload.size() >> (i * 8)) & 0xFF);
+    }
+    const char key[4] = {0x12, 0x34, 0x56, 0x78};
+    out.append(key, 4);
+    for (std::size_t i = 0; i < payload.size(); i++) out += static_cast<char>(payload[i] ^ key[i % 4]);
+    return out;
+}
+
+// Feed a stream to a Decoder at most chunk bytes per read and collect the payloads
+auto decode(std::string_view stream, std::size_t chunk, std::size_t capacity = 16) -> std::optional<std::vector<std::string>> {
+    Decoder decoder(capacity);
+    std::vector<std::string> payloads;
+    for (;;) {
+        Frame f;
+        const auto parsed = decoder.next(f);
+        if (parsed == Parse::Error) return std::nullopt;
+        if (parsed == Parse::Complete) {
+            payloads.emplace_back(f.payload);
+            continue;
+        }
+        if (stream.empty()) break;
+
+        const auto space = decoder.prepare();
+        const auto n     = std::min({chunk, space.size(), stream.size()});
+        std::memcpy(space.data(), stream.data(), n);
+        decoder.commit(n);
+        stream.remove_prefix(n);
+    }
+    if (decoder.buffered()) return std::nullopt;
+    return payloads;
+}
+
+// Run a Connection over the bytes a client sent and get the status code of the server's Close frame
+auto close_code(std::string_view sent) -> int {
+    asio::io_context io;
+    tcp::acceptor acceptor(io, {asio::ip::make_address("127.0.0.1"), 0});
+    tcp::socket client(io);
+    client.connect(acceptor.local_endpoint());
+    Connection connection("key", "13", "secret", std::make_shared<server::Socket>(acceptor.accept()));
+    asio::write(client, asio::buffer(sent));
+
+    bool closed = false;
+    asio::co_spawn(io, [&]() -> asio::awaitable<void> {
+        while (co_await connection.read()) {}
+        closed = true; }, asio::detached);
+    io.run();
+
+    std::array<uint8_t, 4> reply{};
+    asio::read(client, asio::buffer(reply));
+    if (!closed || reply[0] != 0x88 || reply[1] != 2) return -1;
+    return (reply[2] << 8) | reply[3];
+}
+
+auto main() -> int {
+    const std::vector<std::string> messages{"", "hello", std::string(125, 'a'), std::string(126, 'b'),
+                                            std::string(70000, 'c'), "bye"};
+    std::string stream;
+    for (const auto &message: messages) stream += frame(message);
+
+    // Frames are decoded however the stream is split across reads
+    for (const std::size_t chunk: {std::size_t{1}, std::size_t{3}, std::size_t{7}, std::size_t{4096}, stream.size()}) {
+        const auto payloads = decode(stream, chunk);
+        EXPECT(payloads && *payloads == messages);
+    }
+
+    // Many frames are decoded from a single read
+    {
+        Decoder decoder;
+        std::string small;
+        for (int i = 0; i < 100; i++) small += frame("ping " + std::to_string(i));
+        const auto space = decoder.prepare();
+        EXPECT(space.size() >= small.size());
+        std::memcpy(space.data(), small.data(), small.size());
+        decoder.commit(small.size());
+
+        Frame f;
+        for (int i = 0; i < 100; i++) {
+            const auto parsed = decoder.next(f);
+            EXPECT(parsed == Parse::Complete && f.payload == "ping " + std::to_string(i) && f.fin);
+        }
+        const auto parsed = decoder.next(f);
+        EXPECT(parsed == Parse::Partial && decoder.buffered() == 0);
+    }
+
+    // Frames larger than the payload limit are rejected
+    {
+        Decoder decoder(DEFAULT_BUFFER_SIZE, 100);
+        const auto big   = frame(std::string(101, 'x'));
+        const auto space = decoder.prepare();
+        std::memcpy(space.data(), big.data(), 8);
+        decoder.commit(8);
+        Frame f;
+        const auto parsed = decoder.next(f);
+        EXPECT(parsed == Parse::Error);
+    }
+
+    // Frames breaking RFC 6455 are rejected
+    {
+        auto reserved = frame("x");
+        reserved[0]   = static_cast<char>(reserved[0] | 0x40);
+        EXPECT(!decode(reserved, 4096));
+        EXPECT(!decode(std::string("\x81\x02hi", 4), 4096));
+        EXPECT(!decode(frame("x", static_cast<Opcode>(0x3)), 4096));
+        EXPECT(!decode(frame("x", static_cast<Opcode>(0xB)), 4096));
+        EXPECT(!decode(frame(std::string(126, 'p'), Opcode::Ping), 4096));
+        EXPECT(!decode(frame("p", Opcode::Ping, false), 4096));
+
+        const auto largest = decode(frame(std::string(125, 'p'), Opcode::Ping), 4096);
+        EXPECT(largest && largest->size() == 1 && (*largest)[0].size() == 125);
+    }
+
+    // Protocol errors close the connection with 1002, a client Close is answered with 1000
+    EXPECT(close_code(std::string("\x81\x02hi", 4)) == 1002);
+    EXPECT(close_code(frame("x", static_cast<Opcode>(0x3))) == 1002);
+    EXPECT(close_code(frame("more", Opcode::Continuation)) == 1002);
+    EXPECT(close_code(frame("frag", Opcode::Text, false) + frame("new")) == 1002);
+    EXPECT(close_code(frame("x", Opcode::Close)) == 1002);
+    EXPECT(close_code(frame("", Opcode::Close)) == 1000);
+
+    // Connections join fragments, answer pings and read messages back to back
+    {
+        asio::io_context io;
+        tcp::acceptor acceptor(io, {asio::ip::make_address("127.0.0.1"), 0});
+        tcp::socket client(io);
+        client.connect(acceptor.local_endpoint());
+        Connection connection("key", "13", "secret", std::make_shared<server::Socket>(acceptor.accept()));
+
+        const auto sent = frame("frag", Opcode::Text, false) + frame("ping", Opcode::Ping) +
+                          frame("ment", Opcode::Continuation, true) + stream + frame("", Opcode::Close);
+        asio::write(client, asio::buffer(sent));
+
+        std::vector<std::string> received;
+        bool closed = false;
+        asio::co_spawn(io, [&]() -> asio::awaitable<void> {
+            while (auto message = co_await connection.read()) received.push_back(std::move(*message));
+            closed = true; }, asio::detached);
+        io.run();
+
+        EXPECT(closed && received.size() == messages.size() + 1);
+        EXPECT(received[0] == "fragment");
+        EXPECT(std::vector<std::string>(received.begin() + 1, received.end()) == messages);
+
+        // The ping was answered with a pong before the close
+        std::array<char, 8> reply{};
+        asio::read(client, asio::buffer(reply.data(), 6));
+        EXPECT(static_cast<uint8_t>(reply[0]) == 0x8A && reply[1] == 4 && std::string_view(reply.data() + 2, 4) == "ping");
+        asio::read(client, asio::buffer(reply.data(), 4));
+        EXPECT(static_cast<uint8_t>(reply[0]) == 0x88 && reply[1] == 2 && reply[2] == 0x03 && static_cast<uint8_t>(reply[3]) == 0xE8);
+    }
+
+    return 0;
+}